@@ -32,6 +32,15 @@
     extern "C" {
 #endif
 
+/*
+ * 64-bit unsigned integer, for high resolution times
+ */
+#if defined(_MSC_VER) && (_MSC_VER < 1600)
+    typedef unsigned __int64 GLUTtime;
+#else
+    typedef unsigned long long GLUTtime;
+#endif
+
 /*
  * Additional GLUT Key definitions for the Special key function
  */
@@ -99,6 +108,31 @@
 
 #define  GLUT_ALLOW_NEGATIVE_WINDOW_POSITION 0x0207 /* GLUT doesn't allow negative window positions by default */
 
+#define  GLUT_GEOMETRY_BUFFER_CACHE_SIZE    0x0208  /* Max. number of shapes kept in buffer objects per window, 0 disables */
+#define  GLUT_GEOMETRY_MESH_CACHE_SIZE      0x0209  /* Max. number of generated round shape meshes kept, 0 disables */
+#define  GLUT_GEOMETRY_MESH_CACHE_HITS      0x020A  /* glutGet only: meshes reused from the cache */
+#define  GLUT_GEOMETRY_MESH_CACHE_MISSES    0x020B  /* glutGet only: meshes that had to be generated */
+
+#define  GLUT_GEOMETRY_VERTEX_FORMAT        0x020C  /* Layout of the shapes' vertex buffer objects, see below */
+
+#define  GLUT_FRAME_STATS                   0x020D  /* Collect per frame timings for glutGetFrameStats? */
+
+#define  GLUT_ELAPSED_TIME_NS               0x020E  /* glutGet64 only: nanoseconds since glutInit */
+
+#define  GLUT_COALESCE_EVENTS               0x020F  /* Collapse runs of motion events into the latest one? */
+#define  GLUT_COALESCED_EVENTS              0x0210  /* glutGet only: motion events dropped that way */
+
+#define  GLUT_DEFER_CONTEXT_RESTORE         0x0211  /* Switch back to the current window's context only when needed? */
+
+#define  GLUT_BITMAP_FONT_ATLAS             0x0212  /* Draw bitmap font glyphs from a texture instead of with glBitmap? */
+
+#define  GLUT_TEASET_SUBDIVISIONS           0x0213  /* Points per patch side of teapot, teacup and teaspoon, 0 for the defaults */
+
+#define  GLUT_WINDOW_GEOMETRY_SYNC          0x0214  /* Have glutGet ask the window system for window geometry instead of using the last reported one? */
+
+#define  GLUT_WINDOW_SWAP_INTERVAL          0x0215  /* glutGet only: the current window's swap interval, negative if late swaps tear */
+#define  GLUT_WINDOW_BUFFER_AGE             0x0216  /* glutGet only: swaps since the back buffer was last drawn into, 0 if unknown */
+
 #define  GLUT_WINDOW_SRGB                   0x007D
 
 /*
@@ -113,6 +147,24 @@
 #define  GLUT_AUX3                          0x4000
 #define  GLUT_AUX4                          0x8000
 
+/*
+ * GLUT API Extension macro definitions -- the GLUT_GEOMETRY_VERTEX_FORMAT values
+ */
+#define  GLUT_VERTEX_FORMAT_FLOAT           0x0001  /* Separate float coordinate, normal and texture coordinate buffers */
+#define  GLUT_VERTEX_FORMAT_PACKED          0x0002  /* One interleaved buffer: float coordinates, snorm16 normals, unorm16 texture coordinates */
+
+/*
+ * GLUT API Extension macro definitions -- the phases timed by glutGetFrameStats
+ */
+#define  GLUT_FRAME_PHASE_EVENTS            0       /* Processing window system events */
+#define  GLUT_FRAME_PHASE_TIMERS            1       /* Timer callbacks */
+#define  GLUT_FRAME_PHASE_JOYSTICK          2       /* Joystick polling */
+#define  GLUT_FRAME_PHASE_DISPLAY           3       /* Window work and display callbacks, without menus and swaps */
+#define  GLUT_FRAME_PHASE_MENU              4       /* Menu redraws, without swaps */
+#define  GLUT_FRAME_PHASE_SWAP              5       /* glutSwapBuffers */
+#define  GLUT_FRAME_PHASE_TOTAL             6       /* The whole glutMainLoopEvent */
+#define  GLUT_FRAME_NUM_PHASES              7
+
 /*
  * Context-related flags, see fg_state.c
  * Set the requested OpenGL version
@@ -150,6 +202,14 @@
  */
 FGAPI void    FGAPIENTRY glutMainLoopEvent( void );
 FGAPI void    FGAPIENTRY glutLeaveMainLoop( void );
+
+/*
+ * Frame statistics, see fg_main.c. Copies the timings of (at most)
+ * maxFrames most recent frames into usec, oldest first, as
+ * GLUT_FRAME_NUM_PHASES microsecond values per frame, and returns the
+ * number of frames copied.
+ */
+FGAPI int     FGAPIENTRY glutGetFrameStats( unsigned int *usec, int maxFrames );
 FGAPI void    FGAPIENTRY glutExit         ( void );
 
 /*
@@ -173,11 +233,47 @@ FGAPI void    FGAPIENTRY glutWMCloseFunc( void (* callback)( void ) );
 /* And also a destruction callback for menus */
 FGAPI void    FGAPIENTRY glutMenuDestroyFunc( void (* callback)( void ) );
 
+/*
+ * Vertical retraces to wait for per buffer swap of the current window, see
+ * fg_display.c. Negative values let swaps that missed a retrace tear, where
+ * supported. Returns 0 if the interval could not be set.
+ */
+FGAPI int     FGAPIENTRY glutSwapInterval( int interval );
+
+/*
+ * Buffer swap that only presents the n rectangles in rects, each as x, y,
+ * width and height from the window's bottom left corner, where supported.
+ * See GLUT_WINDOW_BUFFER_AGE for how much of the back buffer to redraw.
+ */
+FGAPI void    FGAPIENTRY glutSwapBuffersWithDamage( const int *rects, int n );
+
+/*
+ * Timer with a nanosecond timeout, and cancelling timers by their value,
+ * see fg_callbacks.c
+ */
+FGAPI void    FGAPIENTRY glutTimerFuncNs( GLUTtime time, void (* callback)( int ), int value );
+FGAPI int     FGAPIENTRY glutCancelTimer( int value );
+
 /*
  * State setting and retrieval functions, see fg_state.c
  */
 FGAPI void    FGAPIENTRY glutSetOption ( GLenum option_flag, int value );
+FGAPI GLUTtime FGAPIENTRY glutGet64( GLenum query );
 FGAPI int *   FGAPIENTRY glutGetModeValues(GLenum mode, int * size);
+
+/*
+ * The current window's framebuffer configuration, all the values glutGet
+ * reports for it in one call. Returns 0 if there is no current window.
+ */
+typedef struct
+{
+    int rgba, doubleBuffer, stereo, srgb;
+    int bufferSize, redSize, greenSize, blueSize, alphaSize;
+    int depthSize, stencilSize;
+    int accumRedSize, accumGreenSize, accumBlueSize, accumAlphaSize;
+    int numSamples, colormapSize, formatID;
+} GLUTwindowConfig;
+FGAPI int     FGAPIENTRY glutGetWindowConfig( GLUTwindowConfig *config );
 /* A.Donev: User-data manipulation */
 FGAPI void*   FGAPIENTRY glutGetWindowData( void );
 FGAPI void    FGAPIENTRY glutSetWindowData(void* data);
@@ -192,6 +288,16 @@ FGAPI GLfloat FGAPIENTRY glutStrokeHeight( void* font );
 FGAPI void    FGAPIENTRY glutBitmapString( void* font, const unsigned char *string );
 FGAPI void    FGAPIENTRY glutStrokeString( void* font, const unsigned char *string );
 
+/*
+ * Prepared strings are measured (and with stroke fonts, laid out) once,
+ * and can then be drawn any number of times, see fg_font.c
+ */
+FGAPI int     FGAPIENTRY glutPrepareString( void* font, const unsigned char *string );
+FGAPI void    FGAPIENTRY glutDestroyPreparedString( int string );
+FGAPI void    FGAPIENTRY glutDrawPreparedString( int string );
+FGAPI GLfloat FGAPIENTRY glutPreparedStringWidth( int string );
+FGAPI int     FGAPIENTRY glutPreparedStringLines( int string );
+
 /*
  * Geometry functions, see fg_geometry.c
  */
@@ -202,6 +308,47 @@ FGAPI void    FGAPIENTRY glutSolidSierpinskiSponge ( int num_levels, double offs
 FGAPI void    FGAPIENTRY glutWireCylinder( double radius, double height, GLint slices, GLint stacks);
 FGAPI void    FGAPIENTRY glutSolidCylinder( double radius, double height, GLint slices, GLint stacks);
 
+/*
+ * Instanced geometry: draw a shape once per instance. The params array
+ * holds the arguments of the shape's glutSolid / glutWire function (none
+ * for the polyhedra, {num_levels, offset x, y, z, scale} for the sponge),
+ * instanceData holds one transform per instance in the given format.
+ */
+FGAPI void    FGAPIENTRY glutWireShapeInstanced( int shape, const double *params, int instanceFormat, int count, const GLfloat *instanceData );
+FGAPI void    FGAPIENTRY glutSolidShapeInstanced( int shape, const double *params, int instanceFormat, int count, const GLfloat *instanceData );
+
+/* shapes that can be passed to glutWireShapeInstanced / glutSolidShapeInstanced */
+#define GLUT_SHAPE_CUBE                     0x0001
+#define GLUT_SHAPE_DODECAHEDRON             0x0002
+#define GLUT_SHAPE_ICOSAHEDRON              0x0003
+#define GLUT_SHAPE_OCTAHEDRON               0x0004
+#define GLUT_SHAPE_RHOMBICDODECAHEDRON      0x0005
+#define GLUT_SHAPE_TETRAHEDRON              0x0006
+#define GLUT_SHAPE_SIERPINSKISPONGE         0x0007
+#define GLUT_SHAPE_SPHERE                   0x0008
+#define GLUT_SHAPE_CONE                     0x0009
+#define GLUT_SHAPE_CYLINDER                 0x000A
+#define GLUT_SHAPE_TORUS                    0x000B
+#define GLUT_SHAPE_TEAPOT                   0x000C
+#define GLUT_SHAPE_TEACUP                   0x000D
+#define GLUT_SHAPE_TEASPOON                 0x000E
+
+/* instance data formats */
+#define GLUT_INSTANCE_OFFSET_SCALE          0x0001  /* 4 floats: x, y, z offset and uniform scale */
+#define GLUT_INSTANCE_MATRIX                0x0002  /* 16 floats: column-major matrix, as glMultMatrixf */
+
+/*
+ * Level of detail: draw a sphere, cone, cylinder or torus with as many
+ * slices and stacks as needed for its outline to be within maxError pixels
+ * (0.5 if not positive) of the true shape, where one unit in object space
+ * covers pixelsPerUnit pixels on screen. The params array holds the sizes
+ * of the shape's glutSolid / glutWire function, without the slices and
+ * stacks. Returns the number of triangles drawn, or of line segments for
+ * glutWireShapeLOD, leaving out triangles that collapse to a line or point.
+ */
+FGAPI int     FGAPIENTRY glutWireShapeLOD( int shape, const double *params, double pixelsPerUnit, double maxError );
+FGAPI int     FGAPIENTRY glutSolidShapeLOD( int shape, const double *params, double pixelsPerUnit, double maxError );
+
 /*
  * Rest of functions for rendering Newell's teaset, found in fg_teapot.c
  * NB: front facing polygons have clockwise winding, not counter clockwise
@@ -216,6 +363,7 @@ FGAPI void    FGAPIENTRY glutSolidTeaspoon( double size );
  */
 typedef void (*GLUTproc)();
 FGAPI GLUTproc FGAPIENTRY glutGetProcAddress( const char *procName );
+FGAPI int      FGAPIENTRY glutGetProcAddresses( const char **procNames, GLUTproc *procs, int count );
 
 /*
  * Multi-touch/multi-pointer extensions
@@ -268,6 +416,8 @@ FGAPI void    FGAPIENTRY glutInitWarningFunc( void (* callback)( const char *fmt
 FGAPI void    FGAPIENTRY glutSetVertexAttribCoord3( GLint attrib );
 FGAPI void    FGAPIENTRY glutSetVertexAttribNormal( GLint attrib );
 FGAPI void    FGAPIENTRY glutSetVertexAttribTexCoord2( GLint attrib );
+FGAPI void    FGAPIENTRY glutSetVertexAttribInstance( GLint attrib );   /* vec4, or mat4 in attrib..attrib+3 */
+FGAPI void    FGAPIENTRY glutFlushGeometryCache( void );
 
 /* Mobile platforms lifecycle */
 FGAPI void    FGAPIENTRY glutInitContextFunc( void (* callback)( void ) );
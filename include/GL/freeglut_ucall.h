@@ -27,6 +27,7 @@ FGAPI int  FGAPIENTRY glutCreateMenuUcall( void (* callback)( int menu, void* us
  * Global callback functions, see fg_callbacks.c
  */
 FGAPI void FGAPIENTRY glutTimerFuncUcall( unsigned int time, void (* callback)( int, void* ), int value, void* user_data );
+FGAPI void FGAPIENTRY glutTimerFuncNsUcall( GLUTtime time, void (* callback)( int, void* ), int value, void* user_data );
 FGAPI void FGAPIENTRY glutIdleFuncUcall( void (* callback)( void* ), void* user_data );
 
 /*
@@ -0,0 +1,380 @@
+/*
+ * fgbench: geometry and text rendering throughput of freeglut
+ *
+ * Times every glutSolid* / glutWire* shape at a few tessellation levels,
+ * the teapot, teacup and teaspoon, glutBitmapString and glutStrokeString,
+ * and prints the results in a machine-readable form, so that runs before
+ * and after a change can be compared.
+ *
+ * The shapes are drawn through the fixed function path (which is the
+ * OpenGL 1.0 or 1.1 code in freeglut, depending on the headers freeglut
+ * was built with) and, if a shader can be built, the OpenGL 2.0 vertex
+ * attribute path. The text functions only have a fixed function path.
+ *
+ * Usage: fgbench [-time ms] [-json] [-packed] [-path fixed|gl20]
+ *   -time ms     minimum time spent per test (default 250 ms)
+ *   -json        print JSON instead of CSV
+ *   -packed      use GLUT_VERTEX_FORMAT_PACKED for the OpenGL 2.0 path
+ *   -path name   only run the given path
+ *
+ * Rendering is done in a small window, so a display is needed. For
+ * headless runs use e.g. a virtual X server with Mesa's llvmpipe:
+ *   LIBGL_ALWAYS_SOFTWARE=1 xvfb-run ./fgbench -json > results.json
+ */
+#include <GL/freeglut.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * OpenGL 2+ shader mode needs some function and macro definitions,
+ * avoiding a dependency on additional libraries like GLEW or the
+ * GL/glext.h header
+ */
+#ifndef GL_FRAGMENT_SHADER
+#define GL_FRAGMENT_SHADER 0x8B30
+#endif
+
+#ifndef GL_VERTEX_SHADER
+#define GL_VERTEX_SHADER 0x8B31
+#endif
+
+#ifndef GL_LINK_STATUS
+#define GL_LINK_STATUS 0x8B82
+#endif
+
+typedef char ourGLchar;
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+#ifndef GL_VERSION_2_0
+typedef GLuint (APIENTRY *PFNGLCREATESHADERPROC) (GLenum type);
+typedef void (APIENTRY *PFNGLSHADERSOURCEPROC) (GLuint shader, GLsizei count, const ourGLchar **string, const GLint *length);
+typedef void (APIENTRY *PFNGLCOMPILESHADERPROC) (GLuint shader);
+typedef GLuint (APIENTRY *PFNGLCREATEPROGRAMPROC) (void);
+typedef void (APIENTRY *PFNGLATTACHSHADERPROC) (GLuint program, GLuint shader);
+typedef void (APIENTRY *PFNGLLINKPROGRAMPROC) (GLuint program);
+typedef void (APIENTRY *PFNGLUSEPROGRAMPROC) (GLuint program);
+typedef void (APIENTRY *PFNGLGETPROGRAMIVPROC) (GLenum target, GLenum pname, GLint *params);
+typedef GLint (APIENTRY *PFNGLGETATTRIBLOCATIONPROC) (GLuint program, const ourGLchar *name);
+#endif
+
+PFNGLCREATESHADERPROC gl_CreateShader;
+PFNGLSHADERSOURCEPROC gl_ShaderSource;
+PFNGLCOMPILESHADERPROC gl_CompileShader;
+PFNGLCREATEPROGRAMPROC gl_CreateProgram;
+PFNGLATTACHSHADERPROC gl_AttachShader;
+PFNGLLINKPROGRAMPROC gl_LinkProgram;
+PFNGLUSEPROGRAMPROC gl_UseProgram;
+PFNGLGETPROGRAMIVPROC gl_GetProgramiv;
+PFNGLGETATTRIBLOCATIONPROC gl_GetAttribLocation;
+
+/* Minimal shaders, we measure the vertex submission, not the shading */
+const ourGLchar *vertexShaderSource[] = {
+    "attribute vec3 fg_coord;",
+    "attribute vec3 fg_normal;",
+    "varying vec3 normal;",
+    "void main()",
+    "{",
+    "  normal = fg_normal;",
+    "  gl_Position = gl_ModelViewProjectionMatrix * vec4(fg_coord, 1.0);",
+    "}"
+};
+
+const ourGLchar *fragmentShaderSource[] = {
+    "varying vec3 normal;",
+    "void main()",
+    "{",
+    "  gl_FragColor = vec4(normal * 0.5 + 0.5, 1.0);",
+    "}"
+};
+
+GLuint program;
+GLint attribute_fg_coord = -1, attribute_fg_normal = -1;
+
+/*
+ * Build the shader program, returns 0 if the OpenGL 2.0 path can't be
+ * benchmarked
+ */
+int initShader(void)
+{
+    GLuint vertexShader, fragmentShader;
+    GLint status;
+
+    gl_CreateShader = (PFNGLCREATESHADERPROC) glutGetProcAddress ("glCreateShader");
+    gl_ShaderSource = (PFNGLSHADERSOURCEPROC) glutGetProcAddress ("glShaderSource");
+    gl_CompileShader = (PFNGLCOMPILESHADERPROC) glutGetProcAddress ("glCompileShader");
+    gl_CreateProgram = (PFNGLCREATEPROGRAMPROC) glutGetProcAddress ("glCreateProgram");
+    gl_AttachShader = (PFNGLATTACHSHADERPROC) glutGetProcAddress ("glAttachShader");
+    gl_LinkProgram = (PFNGLLINKPROGRAMPROC) glutGetProcAddress ("glLinkProgram");
+    gl_UseProgram = (PFNGLUSEPROGRAMPROC) glutGetProcAddress ("glUseProgram");
+    gl_GetProgramiv = (PFNGLGETPROGRAMIVPROC) glutGetProcAddress ("glGetProgramiv");
+    gl_GetAttribLocation = (PFNGLGETATTRIBLOCATIONPROC) glutGetProcAddress ("glGetAttribLocation");
+    if (!gl_CreateShader || !gl_ShaderSource || !gl_CompileShader || !gl_CreateProgram || !gl_AttachShader || !gl_LinkProgram || !gl_UseProgram || !gl_GetProgramiv || !gl_GetAttribLocation)
+        return 0;
+
+    vertexShader = gl_CreateShader (GL_VERTEX_SHADER);
+    gl_ShaderSource (vertexShader, sizeof(vertexShaderSource) / sizeof(ourGLchar*), vertexShaderSource, NULL);
+    gl_CompileShader (vertexShader);
+
+    fragmentShader = gl_CreateShader (GL_FRAGMENT_SHADER);
+    gl_ShaderSource (fragmentShader, sizeof(fragmentShaderSource) / sizeof(ourGLchar*), fragmentShaderSource, NULL);
+    gl_CompileShader (fragmentShader);
+
+    program = gl_CreateProgram ();
+    gl_AttachShader (program, vertexShader);
+    gl_AttachShader (program, fragmentShader);
+    gl_LinkProgram (program);
+    gl_GetProgramiv (program, GL_LINK_STATUS, &status);
+    if (status == GL_FALSE)
+        return 0;
+
+    attribute_fg_coord  = gl_GetAttribLocation (program, "fg_coord");
+    attribute_fg_normal = gl_GetAttribLocation (program, "fg_normal");
+    return attribute_fg_coord != -1 && attribute_fg_normal != -1;
+}
+
+/*
+ * The tests: a shape or text function, drawn in solid and wire mode for
+ * the shapes, at each of the tessellation levels for the round shapes
+ */
+enum
+{
+    T_CUBE, T_DODECAHEDRON, T_ICOSAHEDRON, T_OCTAHEDRON, T_RHOMBICDODECAHEDRON,
+    T_TETRAHEDRON, T_SIERPINSKISPONGE, T_SPHERE, T_CONE, T_CYLINDER, T_TORUS,
+    T_TEAPOT, T_TEACUP, T_TEASPOON, T_BITMAPSTRING, T_STROKESTRING
+};
+
+typedef struct
+{
+    const char *name;
+    int         test;
+    int         tessellated;    /* run at each of the levels below?          */
+    int         isText;         /* fixed function only, no solid/wire modes  */
+} Test;
+
+static const Test tests[] = {
+    { "cube",                T_CUBE,                0, 0 },
+    { "dodecahedron",        T_DODECAHEDRON,        0, 0 },
+    { "icosahedron",         T_ICOSAHEDRON,         0, 0 },
+    { "octahedron",          T_OCTAHEDRON,          0, 0 },
+    { "rhombicdodecahedron", T_RHOMBICDODECAHEDRON, 0, 0 },
+    { "tetrahedron",         T_TETRAHEDRON,         0, 0 },
+    { "sierpinskisponge",    T_SIERPINSKISPONGE,    1, 0 },
+    { "sphere",              T_SPHERE,              1, 0 },
+    { "cone",                T_CONE,                1, 0 },
+    { "cylinder",            T_CYLINDER,            1, 0 },
+    { "torus",               T_TORUS,               1, 0 },
+    { "teapot",              T_TEAPOT,              0, 0 },
+    { "teacup",              T_TEACUP,              0, 0 },
+    { "teaspoon",            T_TEASPOON,            0, 0 },
+    { "bitmapstring",        T_BITMAPSTRING,        0, 1 },
+    { "strokestring",        T_STROKESTRING,        0, 1 }
+};
+
+/* slices and stacks of the round shapes, the sponge uses levels/8 */
+static const int levels[] = { 8, 32, 128 };
+
+#define NUMBEROF(x) ((sizeof(x))/(sizeof(x[0])))
+
+static const unsigned char text[] = "The quick brown fox jumps over the lazy dog 0123456789";
+
+static void drawTest(int test, int wire, int level)
+{
+    static double offset[3] = { 0, 0, 0 };
+
+    switch (test)
+    {
+    case T_CUBE:                wire ? glutWireCube(1)                : glutSolidCube(1);                break;
+    case T_DODECAHEDRON:        wire ? glutWireDodecahedron()         : glutSolidDodecahedron();         break;
+    case T_ICOSAHEDRON:         wire ? glutWireIcosahedron()          : glutSolidIcosahedron();          break;
+    case T_OCTAHEDRON:          wire ? glutWireOctahedron()           : glutSolidOctahedron();           break;
+    case T_RHOMBICDODECAHEDRON: wire ? glutWireRhombicDodecahedron()  : glutSolidRhombicDodecahedron();  break;
+    case T_TETRAHEDRON:         wire ? glutWireTetrahedron()          : glutSolidTetrahedron();          break;
+    case T_SIERPINSKISPONGE:
+        wire ? glutWireSierpinskiSponge(level/8, offset, 1) : glutSolidSierpinskiSponge(level/8, offset, 1);
+        break;
+    case T_SPHERE:   wire ? glutWireSphere(1, level, level)          : glutSolidSphere(1, level, level);          break;
+    case T_CONE:     wire ? glutWireCone(1, 1, level, level)         : glutSolidCone(1, 1, level, level);         break;
+    case T_CYLINDER: wire ? glutWireCylinder(1, 1, level, level)     : glutSolidCylinder(1, 1, level, level);     break;
+    case T_TORUS:    wire ? glutWireTorus(.25, 1, level, level)      : glutSolidTorus(.25, 1, level, level);      break;
+    case T_TEAPOT:   wire ? glutWireTeapot(1)   : glutSolidTeapot(1);   break;
+    case T_TEACUP:   wire ? glutWireTeacup(1)   : glutSolidTeacup(1);   break;
+    case T_TEASPOON: wire ? glutWireTeaspoon(1) : glutSolidTeaspoon(1); break;
+    case T_BITMAPSTRING:
+        glRasterPos2f(-1.9f, 0.f);
+        glutBitmapString(GLUT_BITMAP_HELVETICA_18, text);
+        break;
+    case T_STROKESTRING:
+        glPushMatrix();
+        glTranslatef(-1.9f, 0.f, 0.f);
+        glScalef(.002f, .002f, .002f);
+        glutStrokeString(GLUT_STROKE_ROMAN, text);
+        glPopMatrix();
+        break;
+    }
+}
+
+/* Options */
+static int minTime = 250;
+static int printJSON = 0;
+static int packed = 0;
+static const char *onlyPath = NULL;
+
+static int numResults = 0;
+
+static void printResult(const char *path, const char *name, const char *mode, int level,
+                        int iterations, GLUTtime elapsedNs)
+{
+    double ms = elapsedNs / 1000000.;
+    double usPerDraw = iterations ? elapsedNs / 1000. / iterations : 0.;
+
+    if (printJSON)
+        printf("%s\n  { \"path\": \"%s\", \"test\": \"%s\", \"mode\": \"%s\", \"level\": %d, "
+               "\"iterations\": %d, \"ms\": %.3f, \"us_per_draw\": %.3f }",
+               numResults ? "," : "[", path, name, mode, level, iterations, ms, usPerDraw);
+    else
+    {
+        if (!numResults)
+            printf("path,test,mode,level,iterations,ms,us_per_draw\n");
+        printf("%s,%s,%s,%d,%d,%.3f,%.3f\n", path, name, mode, level, iterations, ms, usPerDraw);
+    }
+    numResults++;
+}
+
+/*
+ * Draw the test repeatedly for at least minTime ms. The first draw, which
+ * fills freeglut's caches, isn't timed. Timing is in nanoseconds, as a
+ * single draw often takes less than a millisecond.
+ */
+static void runTest(const char *path, const Test *t, int wire, int level)
+{
+    int iterations = 0, i;
+    GLUTtime start, elapsed;
+
+    drawTest(t->test, wire, level);
+    glFinish();
+
+    start = glutGet64(GLUT_ELAPSED_TIME_NS);
+    do
+    {
+        for (i=0; i<8; i++)
+            drawTest(t->test, wire, level);
+        glFinish();
+        iterations += 8;
+        elapsed = glutGet64(GLUT_ELAPSED_TIME_NS) - start;
+    }
+    while (elapsed < (GLUTtime)minTime * 1000000);
+
+    printResult(path, t->name, t->isText ? "text" : wire ? "wire" : "solid", t->tessellated ? level : 0,
+                iterations, elapsed);
+}
+
+static void runPath(const char *path, int shapesOnly)
+{
+    unsigned int i, l;
+    int wire;
+
+    if (onlyPath && strcmp(onlyPath, path))
+        return;
+
+    for (i=0; i<NUMBEROF(tests); i++)
+    {
+        const Test *t = &tests[i];
+
+        if (t->isText)
+        {
+            if (!shapesOnly)
+                runTest(path, t, 0, 0);
+            continue;
+        }
+
+        for (wire=0; wire<2; wire++)
+            for (l=0; l<(t->tessellated ? NUMBEROF(levels) : 1); l++)
+                runTest(path, t, wire, levels[l]);
+    }
+}
+
+static void display(void)
+{
+    static int done = 0;
+    if (done)
+        return;
+    done = 1;
+
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    glOrtho(-2, 2, -2, 2, -10, 10);
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_LIGHTING);
+    glEnable(GL_LIGHT0);
+    glColor3f(1, 1, 1);
+
+    runPath("fixed", 0);
+
+    glDisable(GL_LIGHTING);
+    if (initShader())
+    {
+        if (packed)
+            glutSetOption(GLUT_GEOMETRY_VERTEX_FORMAT, GLUT_VERTEX_FORMAT_PACKED);
+
+        gl_UseProgram(program);
+        glutSetVertexAttribCoord3(attribute_fg_coord);
+        glutSetVertexAttribNormal(attribute_fg_normal);
+
+        runPath("gl20", 1);
+
+        glutSetVertexAttribCoord3(-1);
+        glutSetVertexAttribNormal(-1);
+        gl_UseProgram(0);
+    }
+    else
+        fprintf(stderr, "fgbench: no OpenGL 2.0 shader support, skipping the gl20 path\n");
+
+    if (printJSON && numResults)
+        printf("\n]\n");
+
+    glutLeaveMainLoop();
+}
+
+int main(int argc, char *argv[])
+{
+    int i;
+
+    glutInitWindowSize(256, 256);
+    glutInit(&argc, argv);
+
+    for (i=1; i<argc; i++)
+    {
+        if (!strcmp(argv[i], "-time") && i+1 < argc)
+            minTime = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-json"))
+            printJSON = 1;
+        else if (!strcmp(argv[i], "-packed"))
+            packed = 1;
+        else if (!strcmp(argv[i], "-path") && i+1 < argc)
+            onlyPath = argv[++i];
+        else
+        {
+            fprintf(stderr, "usage: %s [-time ms] [-json] [-packed] [-path fixed|gl20]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    glutInitDisplayMode(GLUT_RGB | GLUT_DOUBLE | GLUT_DEPTH);
+    glutSetOption(GLUT_ACTION_ON_WINDOW_CLOSE, GLUT_ACTION_GLUTMAINLOOP_RETURNS);
+
+    glutCreateWindow("fgbench");
+    glutDisplayFunc(display);
+
+    glutMainLoop();
+
+    return 0;
+}
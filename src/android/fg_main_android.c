@@ -156,11 +156,20 @@ unsigned long fgPlatformSystemTime ( void )
   return now.tv_usec/1000 + now.tv_sec*1000;
 }
 
+/* Monotonic time in nanoseconds, the timebase of the timers, of
+ * GLUT_ELAPSED_TIME_NS and of the frame statistics */
+fg_time_t fgPlatformSystemTimeNs ( void )
+{
+  struct timespec now;
+  clock_gettime( CLOCK_MONOTONIC, &now );
+  return now.tv_nsec + now.tv_sec*(fg_time_t)1000000000;
+}
+
 /*
  * Does the magic required to relinquish the CPU until something interesting
  * happens.
  */
-void fgPlatformSleepForEvents( fg_time_t msec )
+void fgPlatformSleepForEvents( fg_time_t nsec )
 {
     /* Android's NativeActivity relies on a Looper/ALooper object to
        notify about events.  The Looper object is plugged on two
@@ -301,7 +310,7 @@ int32_t handle_input(struct android_app* app, AInputEvent* event) {
 	touchscreen.in_mmotion = false;
 	INVOKE_WCB(*window, Mouse, (GLUT_LEFT_BUTTON, GLUT_UP, x, y));
       } else if (action == AMOTION_EVENT_ACTION_MOVE && FETCH_WCB(*window, Motion)) {
-	INVOKE_WCB(*window, Motion, (x, y));
+	fgCoalesceEvent(window, FG_EVENT_MOTION, 0, x, y, 0);
       }
     }
     
@@ -82,6 +82,7 @@ void fgPlatformInitialize()
 
     /* Get start time */
     fgState.Time = fgSystemTime();
+    fgState.TimeNs = fgSystemTimeNs();
 
     fgState.Initialised = GL_TRUE;
 }
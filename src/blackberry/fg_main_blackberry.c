@@ -176,14 +176,32 @@ fg_time_t fgPlatformSystemTime ( void )
 #endif
 }
 
+/* Same clock in nanoseconds: the timebase of the timers and of
+ * GLUT_ELAPSED_TIME_NS, and of the frame statistics */
+fg_time_t fgPlatformSystemTimeNs ( void )
+{
+#ifdef CLOCK_MONOTONIC
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_nsec + now.tv_sec*(fg_time_t)1000000000;
+#elif defined(HAVE_GETTIMEOFDAY)
+    struct timeval now;
+    gettimeofday( &now, NULL );
+    return now.tv_usec*(fg_time_t)1000 + now.tv_sec*(fg_time_t)1000000000;
+#endif
+}
+
 /*
  * Does the magic required to relinquish the CPU until something interesting
  * happens.
  */
-void fgPlatformSleepForEvents( fg_time_t msec )
+void fgPlatformSleepForEvents( fg_time_t nsec )
 {
+    /* bps_get_event takes milliseconds, round up */
+    int msec = (int)( ( nsec + 999999 ) / 1000000 );
+
     if(fgStructure.CurrentWindow && fgDisplay.pDisplay.event == NULL &&
-            bps_get_event(&fgDisplay.pDisplay.event, (int)msec) != BPS_SUCCESS) {
+            bps_get_event(&fgDisplay.pDisplay.event, msec) != BPS_SUCCESS) {
         LOGW("BPS couldn't get event");
     }
 }
@@ -267,7 +285,7 @@ void handle_left_mouse(int x, int y, int height, int eventType, SFG_Window* wind
         window->State.MouseY = y;
 
         if(eventType == SCREEN_EVENT_MTOUCH_MOVE) {
-            INVOKE_WCB(*window, Motion, (x, y));
+            fgCoalesceEvent(window, FG_EVENT_MOTION, 0, x, y, 0);
         } else if(FETCH_WCB(*window, Mouse)) {
             touchscreen.in_mmotion = eventType == SCREEN_EVENT_MTOUCH_TOUCH;
             int glutTouchType = eventType == SCREEN_EVENT_MTOUCH_TOUCH ? GLUT_DOWN : GLUT_UP;
@@ -394,7 +412,7 @@ void fgPlatformProcessSingleEvent ( void )
                     INVOKE_WCB( *window, MultiEntry,  ( touchEvent.contact_id, GLUT_ENTERED ) );
                     INVOKE_WCB( *window, MultiButton, ( touchEvent.contact_id, touchEvent.x, touchEvent.y, 0, GLUT_DOWN ) );
                 } else if (eventType == SCREEN_EVENT_MTOUCH_MOVE) {
-                    INVOKE_WCB( *window, MultiMotion, ( touchEvent.contact_id, touchEvent.x, touchEvent.y ) );
+                    fgCoalesceEvent( window, FG_EVENT_MULTI_MOTION, touchEvent.contact_id, touchEvent.x, touchEvent.y, 0 );
                     //XXX No motion is performed without contact, thus MultiPassive is never used
                 } else if (eventType == SCREEN_EVENT_MTOUCH_RELEASE) {
                     INVOKE_WCB( *window, MultiButton, ( touchEvent.contact_id, touchEvent.x, touchEvent.y, 0, GLUT_UP ) );
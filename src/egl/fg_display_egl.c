@@ -26,8 +26,126 @@
 #include <GL/freeglut.h>
 #include "fg_internal.h"
 
+#ifndef EGL_BUFFER_AGE_EXT
+#define EGL_BUFFER_AGE_EXT 0x313D
+#endif
+
+typedef EGLBoolean (*fghSwapBuffersWithDamageProc)(EGLDisplay dpy, EGLSurface surface, const EGLint *rects, EGLint n_rects);
+
+/*
+ * What the display they were looked up for can do about partial updates.
+ * The KHR and EXT swap with damage functions are the same but for the name.
+ */
+static struct
+{
+  EGLDisplay Display;
+  fghSwapBuffersWithDamageProc SwapBuffersWithDamage;
+  EGLBoolean BufferAge; /* EGL_EXT_buffer_age */
+} fghPartialUpdate = { EGL_NO_DISPLAY, NULL, EGL_FALSE };
+
+static EGLBoolean fghHasEGLExtension(const char *extensions, const char *name)
+{
+  size_t len = strlen(name);
+  const char *p = extensions;
+
+  while (p && (p = strstr(p, name)) != NULL) {
+    if ((p == extensions || p[-1] == ' ') && (p[len] == ' ' || p[len] == '\0'))
+      return EGL_TRUE;
+    p += len;
+  }
+  return EGL_FALSE;
+}
+
+static void fghInitPartialUpdate(EGLDisplay display)
+{
+  const char *extensions;
+
+  if (fghPartialUpdate.Display == display)
+    return;
+
+  fghPartialUpdate.Display = display;
+  fghPartialUpdate.SwapBuffersWithDamage = NULL;
+
+  extensions = eglQueryString(display, EGL_EXTENSIONS);
+  if (fghHasEGLExtension(extensions, "EGL_KHR_swap_buffers_with_damage"))
+    fghPartialUpdate.SwapBuffersWithDamage = (fghSwapBuffersWithDamageProc)eglGetProcAddress("eglSwapBuffersWithDamageKHR");
+  else if (fghHasEGLExtension(extensions, "EGL_EXT_swap_buffers_with_damage"))
+    fghPartialUpdate.SwapBuffersWithDamage = (fghSwapBuffersWithDamageProc)eglGetProcAddress("eglSwapBuffersWithDamageEXT");
+  fghPartialUpdate.BufferAge = fghHasEGLExtension(extensions, "EGL_EXT_buffer_age");
+}
+
 void fgPlatformGlutSwapBuffers( SFG_PlatformDisplay *pDisplayPtr, SFG_Window* CurrentWindow )
 {
   if (!eglSwapBuffers(pDisplayPtr->egl.Display, CurrentWindow->Window.pContext.egl.Surface))
     fgError("eglSwapBuffers: error %x\n", eglGetError());
 }
+
+/*
+ * Swap only the damaged rectangles, which are laid out the way EGL wants
+ * them already. Without swap with damage, the whole surface is swapped.
+ */
+void fgPlatformGlutSwapBuffersWithDamage( SFG_PlatformDisplay *pDisplayPtr, SFG_Window* CurrentWindow, const int *rects, int n )
+{
+  fghInitPartialUpdate(pDisplayPtr->egl.Display);
+
+  if (fghPartialUpdate.SwapBuffersWithDamage == NULL) {
+    fgPlatformGlutSwapBuffers(pDisplayPtr, CurrentWindow);
+    return;
+  }
+
+  if (!fghPartialUpdate.SwapBuffersWithDamage(pDisplayPtr->egl.Display, CurrentWindow->Window.pContext.egl.Surface,
+                                              (const EGLint *)rects, n))
+    fgError("eglSwapBuffersWithDamage: error %x\n", eglGetError());
+}
+
+/*
+ * Return how many swaps ago the window's back buffer was drawn into, or 0
+ * if its contents can't be relied upon
+ */
+int fgPlatformGetBufferAge( SFG_Window *window )
+{
+  EGLint age = 0;
+
+  fghInitPartialUpdate(fgDisplay.pDisplay.egl.Display);
+
+  if (fghPartialUpdate.BufferAge &&
+      !eglQuerySurface(fgDisplay.pDisplay.egl.Display, window->Window.pContext.egl.Surface, EGL_BUFFER_AGE_EXT, &age))
+    age = 0;
+  return age;
+}
+
+/*
+ * Set the swap interval of a window, whose context is current. EGL has no
+ * late swap tearing, so negative intervals become positive ones, and clamps
+ * to the range the config allows: *interval is left with what it got.
+ */
+GLboolean fgPlatformSwapInterval( SFG_Window *window, int *interval )
+{
+  EGLint minInterval = 0, maxInterval = 0;
+  EGLConfig config = window->Window.pContext.egl.Config;
+
+  if (*interval < 0)
+    *interval = -*interval;
+
+  if (eglGetConfigAttrib(fgDisplay.pDisplay.egl.Display, config, EGL_MIN_SWAP_INTERVAL, &minInterval) &&
+      eglGetConfigAttrib(fgDisplay.pDisplay.egl.Display, config, EGL_MAX_SWAP_INTERVAL, &maxInterval)) {
+    if (*interval < minInterval)
+      *interval = minInterval;
+    if (*interval > maxInterval)
+      *interval = maxInterval;
+  }
+
+  if (!eglSwapInterval(fgDisplay.pDisplay.egl.Display, *interval)) {
+    fgWarning("eglSwapInterval: error %x\n", eglGetError());
+    return GL_FALSE;
+  }
+  return GL_TRUE;
+}
+
+/*
+ * EGL can't be asked for the swap interval, so go by what was set
+ */
+int fgPlatformGetSwapInterval( SFG_Window *window )
+{
+  return window->State.SwapInterval;
+}
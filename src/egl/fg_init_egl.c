@@ -67,6 +67,8 @@ void fghPlatformCloseDisplayEGL()
     fgDisplay.pDisplay.egl.MajorVersion = 0;
     fgDisplay.pDisplay.egl.MinorVersion = 0;
   }
+  fgDisplay.pDisplay.egl.NumConfigChoices = 0;
+  fgDisplay.pDisplay.egl.NextConfigChoice = 0;
 }
 
 /**
@@ -29,6 +29,20 @@
 #include <EGL/egl.h>
 
 /* -- GLOBAL TYPE DEFINITIONS ---------------------------------------------- */
+/*
+ * An EGLConfig fghChooseConfig picked, and the settings it was picked for,
+ * so that windows opened with the same ones don't ask eglChooseConfig again
+ */
+#define FG_NUM_CONFIG_CHOICES_EGL 4
+struct tagSFG_ConfigChoiceEGL
+{
+  unsigned int        DisplayMode;
+  int                 SampleNumber;
+  int                 AuxiliaryBufferNumber;
+  int                 MajorVersion;
+  EGLConfig           Config;
+};
+
 /* The structure used by display initialization in fg_init.c */
 struct tagSFG_Window;
 struct tagSFG_PlatformDisplayEGL
@@ -37,6 +51,11 @@ struct tagSFG_PlatformDisplayEGL
   EGLDisplay          Display;
   EGLint              MajorVersion;
   EGLint              MinorVersion;
+
+  /* The configs fghChooseConfig picked so far */
+  struct tagSFG_ConfigChoiceEGL ConfigChoices[FG_NUM_CONFIG_CHOICES_EGL];
+  int                 NumConfigChoices;
+  int                 NextConfigChoice;
 };
 
 
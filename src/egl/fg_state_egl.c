@@ -91,6 +91,18 @@ int fghPlatformGlutGetEGL ( GLenum eWhat )
     case GLUT_WINDOW_DOUBLEBUFFER:
         return 1; /* EGL is always double-buffered */
 
+    case GLUT_WINDOW_RGBA:
+        return 1; /* EGL has no color index configs */
+
+    /* No stereo or accumulation buffers and no sRGB configs with EGL */
+    case GLUT_WINDOW_STEREO:
+    case GLUT_WINDOW_ACCUM_RED_SIZE:
+    case GLUT_WINDOW_ACCUM_GREEN_SIZE:
+    case GLUT_WINDOW_ACCUM_BLUE_SIZE:
+    case GLUT_WINDOW_ACCUM_ALPHA_SIZE:
+    case GLUT_WINDOW_SRGB:
+        return 0;
+
     default:
         fgWarning( "glutGet(): missing enum handle %d", eWhat );
         break;
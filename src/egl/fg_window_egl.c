@@ -26,8 +26,7 @@
 #include <GL/freeglut.h>
 #include "fg_internal.h"
 
-int fghChooseConfig(EGLConfig* config) {
-  EGLint num_config;
+static int fghChooseNewConfig(EGLConfig* config, EGLint* num_config) {
   EGLint attributes[32];
   int where = 0;
   ATTRIB_VAL(EGL_SURFACE_TYPE, EGL_WINDOW_BIT);
@@ -70,7 +69,7 @@ int fghChooseConfig(EGLConfig* config) {
   ATTRIB(EGL_NONE);
 
   if (!eglChooseConfig(fgDisplay.pDisplay.egl.Display,
-               attributes, config, 1, &num_config)) {
+               attributes, config, 1, num_config)) {
     fgWarning("eglChooseConfig: error %x\n", eglGetError());
     return 0;
   }
@@ -78,6 +77,46 @@ int fghChooseConfig(EGLConfig* config) {
   return 1;
 }
 
+/**
+ * Pick the EGLConfig for the current display mode settings, or take the
+ * one picked earlier for the same settings.
+ */
+int fghChooseConfig(EGLConfig* config) {
+  struct tagSFG_ConfigChoiceEGL* choice;
+  EGLint num_config = 0;
+  int i;
+
+  for (i = 0; i < fgDisplay.pDisplay.egl.NumConfigChoices; i++) {
+    choice = &fgDisplay.pDisplay.egl.ConfigChoices[i];
+    if (choice->DisplayMode == fgState.DisplayMode &&
+        choice->SampleNumber == fgState.SampleNumber &&
+        choice->AuxiliaryBufferNumber == fgState.AuxiliaryBufferNumber &&
+        choice->MajorVersion == fgState.MajorVersion) {
+      *config = choice->Config;
+      return 1;
+    }
+  }
+
+  if (!fghChooseNewConfig(config, &num_config))
+    return 0;
+
+  /* Only keep actual matches, so a failed choice is retried next time */
+  if (num_config > 0) {
+    choice = &fgDisplay.pDisplay.egl.ConfigChoices[fgDisplay.pDisplay.egl.NextConfigChoice];
+    choice->DisplayMode = fgState.DisplayMode;
+    choice->SampleNumber = fgState.SampleNumber;
+    choice->AuxiliaryBufferNumber = fgState.AuxiliaryBufferNumber;
+    choice->MajorVersion = fgState.MajorVersion;
+    choice->Config = *config;
+
+    fgDisplay.pDisplay.egl.NextConfigChoice = (fgDisplay.pDisplay.egl.NextConfigChoice + 1) % FG_NUM_CONFIG_CHOICES_EGL;
+    if (fgDisplay.pDisplay.egl.NumConfigChoices < FG_NUM_CONFIG_CHOICES_EGL)
+      fgDisplay.pDisplay.egl.NumConfigChoices++;
+  }
+
+  return 1;
+}
+
 /**
  * Initialize an EGL context for the current display.
  */
@@ -124,7 +163,11 @@ EGLContext fghCreateNewContextEGL( SFG_Window* window ) {
 
 void fgPlatformSetWindow ( SFG_Window *window )
 {
-  if ( window != fgStructure.CurrentWindow && window) {
+  /* Check what is actually current in this thread rather than
+     fgStructure.CurrentWindow, see GLUT_DEFER_CONTEXT_RESTORE */
+  if ( window &&
+       ( eglGetCurrentContext() != window->Window.Context ||
+         eglGetCurrentSurface(EGL_DRAW) != window->Window.pContext.egl.Surface ) ) {
     if (eglMakeCurrent(fgDisplay.pDisplay.egl.Display,
                window->Window.pContext.egl.Surface,
                window->Window.pContext.egl.Surface,
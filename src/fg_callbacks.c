@@ -44,12 +44,12 @@ void FGAPIENTRY glutIdleFuncUcall( FGCBIdleUC callback, FGCBUserData userData )
 
 IMPLEMENT_GLUT_CALLBACK_FUNC_ARG0(Idle)
 
-/* Creates a timer and sets its callback */
-void FGAPIENTRY glutTimerFuncUcall( unsigned int timeOut, FGCBTimerUC callback, int timerID, FGCBUserData userData )
+/* Creates a timer with a nanosecond timeout and sets its callback */
+void FGAPIENTRY glutTimerFuncNsUcall( GLUTtime timeOut, FGCBTimerUC callback, int timerID, FGCBUserData userData )
 {
-    SFG_Timer *timer, *node;
+    SFG_Timer *timer;
 
-    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutTimerFuncUcall" );
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutTimerFuncNsUcall" );
 
     if( (timer = fgState.FreeTimers.Last) )
     {
@@ -65,16 +65,16 @@ void FGAPIENTRY glutTimerFuncUcall( unsigned int timeOut, FGCBTimerUC callback,
     timer->Callback     = callback;
     timer->CallbackData = userData;
     timer->ID           = timerID;
-    timer->TriggerTime  = fgElapsedTime() + timeOut;
+    timer->TriggerTime  = fgElapsedTimeNs() + timeOut;
 
-    /* Insert such that timers are sorted by end-time */
-    for( node = fgState.Timers.First; node; node = node->Node.Next )
-    {
-        if( node->TriggerTime > timer->TriggerTime )
-            break;
-    }
+    fgTimerQueuePush( &fgState.Timers, timer );
+}
 
-    fgListInsert( &fgState.Timers, node ? &node->Node : 0, &timer->Node );
+/* Creates a timer and sets its callback */
+void FGAPIENTRY glutTimerFuncUcall( unsigned int timeOut, FGCBTimerUC callback, int timerID, FGCBUserData userData )
+{
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutTimerFuncUcall" );
+    glutTimerFuncNsUcall( (GLUTtime)timeOut * 1000000, callback, timerID, userData );
 }
 
 IMPLEMENT_CALLBACK_FUNC_CB_ARG1(Timer, Timer)
@@ -91,6 +91,48 @@ void FGAPIENTRY glutTimerFunc( unsigned int timeOut, FGCBTimer callback, int tim
         glutTimerFuncUcall( timeOut, NULL, timerID, NULL );
 }
 
+/*
+ * Cancels all pending timers with the given ID, returns how many there were
+ */
+int FGAPIENTRY glutCancelTimer( int timerID )
+{
+    int i, numCancelled = 0;
+
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutCancelTimer" );
+
+    /* Scan backwards: removing a timer moves at most one unchecked timer,
+     * into the slot just emptied, so that slot is all we need to revisit */
+    i = fgState.Timers.Count;
+    while( i-- > 0 )
+    {
+        SFG_Timer *timer = fgState.Timers.Heap[ i ];
+
+        if( timer->ID != timerID )
+            continue;
+
+        fgTimerQueueRemove( &fgState.Timers, i );
+        fgListAppend( &fgState.FreeTimers, &timer->Node );
+        numCancelled++;
+
+        if( i < fgState.Timers.Count )
+            i++;
+    }
+
+    return numCancelled;
+}
+
+void FGAPIENTRY glutTimerFuncNs( GLUTtime timeOut, FGCBTimer callback, int timerID )
+{
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutTimerFuncNs" );
+    if( callback )
+    {
+        FGCBTimer* reference = &callback;
+        glutTimerFuncNsUcall( timeOut, fghTimerFuncCallback, timerID, *((FGCBUserData*)reference) );
+    }
+    else
+        glutTimerFuncNsUcall( timeOut, NULL, timerID, NULL );
+}
+
 /* Deprecated version of glutMenuStatusFunc callback setting method */
 void FGAPIENTRY glutMenuStateFunc( FGCBMenuState callback )
 {
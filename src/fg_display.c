@@ -31,42 +31,38 @@
 
 /* Function prototypes */
 extern void fgPlatformGlutSwapBuffers( SFG_PlatformDisplay *pDisplayPtr, SFG_Window* CurrentWindow );
+extern void fgPlatformGlutSwapBuffersWithDamage( SFG_PlatformDisplay *pDisplayPtr, SFG_Window* CurrentWindow, const int *rects, int n );
+extern GLboolean fgPlatformSwapInterval( SFG_Window *window, int *interval );
 
 
-/* -- INTERFACE FUNCTIONS -------------------------------------------------- */
+/* -- PRIVATE FUNCTIONS ---------------------------------------------------- */
 
 /*
- * Marks the current window to have the redisplay performed when possible...
+ * Swaps the current window's buffers, telling the platform which n
+ * rectangles changed if rects is not NULL
  */
-void FGAPIENTRY glutPostRedisplay( void )
+static void fghSwapBuffers( const int *rects, int n )
 {
-    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutPostRedisplay" );
-    if ( ! fgStructure.CurrentWindow )
-    {
-      fgError ( " ERROR:  Function <%s> called"
-                " with no current window defined.", "glutPostRedisplay" ) ;
-    }
-
-    fgStructure.CurrentWindow->State.WorkMask |= GLUT_DISPLAY_WORK;
-}
+    SFG_PhaseTimer timer;
 
-/*
- * Swaps the buffers for the current window (if any)
- */
-void FGAPIENTRY glutSwapBuffers( void )
-{
-    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutSwapBuffers" );
-    FREEGLUT_EXIT_IF_NO_WINDOW ( "glutSwapBuffers" );
+    fgFrameStatsBegin( &timer );
 
     /*
-     * "glXSwapBuffers" already performs an implicit call to "glFlush". What
-     * about "SwapBuffers"?
+     * Swapping, be it glXSwapBuffers, eglSwapBuffers or SwapBuffers, already
+     * flushes: only single buffered windows need it done here.
      */
-    glFlush( );
     if( ! fgStructure.CurrentWindow->Window.DoubleBuffered )
+    {
+        glFlush( );
+        fgFrameStatsEnd( &timer, GLUT_FRAME_PHASE_SWAP );
         return;
+    }
 
-    fgPlatformGlutSwapBuffers( &fgDisplay.pDisplay, fgStructure.CurrentWindow );
+    if( rects != NULL && n > 0 )
+        fgPlatformGlutSwapBuffersWithDamage( &fgDisplay.pDisplay, fgStructure.CurrentWindow, rects, n );
+    else
+        fgPlatformGlutSwapBuffers( &fgDisplay.pDisplay, fgStructure.CurrentWindow );
+    fgFrameStatsEnd( &timer, GLUT_FRAME_PHASE_SWAP );
 
     /* GLUT_FPS env var support */
     if( fgState.FPSInterval )
@@ -88,6 +84,67 @@ void FGAPIENTRY glutSwapBuffers( void )
     }
 }
 
+
+/* -- INTERFACE FUNCTIONS -------------------------------------------------- */
+
+/*
+ * Marks the current window to have the redisplay performed when possible...
+ */
+void FGAPIENTRY glutPostRedisplay( void )
+{
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutPostRedisplay" );
+    if ( ! fgStructure.CurrentWindow )
+    {
+      fgError ( " ERROR:  Function <%s> called"
+                " with no current window defined.", "glutPostRedisplay" ) ;
+    }
+
+    fgPostWork( fgStructure.CurrentWindow, GLUT_DISPLAY_WORK );
+}
+
+/*
+ * Swaps the buffers for the current window (if any)
+ */
+void FGAPIENTRY glutSwapBuffers( void )
+{
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutSwapBuffers" );
+    FREEGLUT_EXIT_IF_NO_WINDOW ( "glutSwapBuffers" );
+
+    fghSwapBuffers( NULL, 0 );
+}
+
+/*
+ * Swaps the buffers for the current window, where only the n rectangles
+ * in rects, as x, y, width and height in window pixels from the bottom left
+ * corner, changed since the last swap. Platforms that can't make use of
+ * that present the whole window.
+ */
+void FGAPIENTRY glutSwapBuffersWithDamage( const int *rects, int n )
+{
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutSwapBuffersWithDamage" );
+    FREEGLUT_EXIT_IF_NO_WINDOW ( "glutSwapBuffersWithDamage" );
+
+    fghSwapBuffers( rects, n );
+}
+
+/*
+ * Sets how many vertical retraces the current window's buffer swaps wait
+ * for. 0 turns waiting off, negative values wait but let a swap that came
+ * too late tear rather than wait for the next retrace. Where that is not
+ * supported, they act as the matching positive value.
+ */
+int FGAPIENTRY glutSwapInterval( int interval )
+{
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutSwapInterval" );
+    FREEGLUT_EXIT_IF_NO_WINDOW ( "glutSwapInterval" );
+
+    if( ! fgPlatformSwapInterval( fgStructure.CurrentWindow, &interval ) )
+        return 0;
+
+    fgStructure.CurrentWindow->State.SwapInterval = interval;
+    return 1;
+}
+
 /*
  * Mark appropriate window to be displayed
  */
@@ -98,7 +155,7 @@ void FGAPIENTRY glutPostWindowRedisplay( int windowID )
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutPostWindowRedisplay" );
     window = fgWindowByID( windowID );
     freeglut_return_if_fail( window );
-    window->State.WorkMask |= GLUT_DISPLAY_WORK;
+    fgPostWork( window, GLUT_DISPLAY_WORK );
 }
 
 /*** END OF FILE ***/
@@ -32,227 +32,283 @@
 extern SFG_Proc fgPlatformGetProcAddress( const char *procName );
 extern GLUTproc fgPlatformGetGLUTProcAddress( const char *procName );
 
+/*
+ * The GLUT entry points we hand out by name. Sorted by name on first use,
+ * so lookups are a binary search instead of a chain of string compares.
+ */
+typedef struct tagSFG_ProcEntry SFG_ProcEntry;
+struct tagSFG_ProcEntry
+{
+    const char* Name;
+    GLUTproc    Proc;
+};
+
+#define PROC_ENTRY(x) { #x, (GLUTproc)x },
+static SFG_ProcEntry fghProcTable[] =
+{
+    PROC_ENTRY(glutInit)
+    PROC_ENTRY(glutInitDisplayMode)
+    PROC_ENTRY(glutInitDisplayString)
+    PROC_ENTRY(glutInitWindowPosition)
+    PROC_ENTRY(glutInitWindowSize)
+    PROC_ENTRY(glutMainLoop)
+    PROC_ENTRY(glutExit)
+    PROC_ENTRY(glutCreateWindow)
+    PROC_ENTRY(glutCreateSubWindow)
+    PROC_ENTRY(glutDestroyWindow)
+    PROC_ENTRY(glutPostRedisplay)
+    PROC_ENTRY(glutPostWindowRedisplay)
+    PROC_ENTRY(glutSwapBuffers)
+    PROC_ENTRY(glutGetWindow)
+    PROC_ENTRY(glutSetWindow)
+    PROC_ENTRY(glutSetWindowTitle)
+    PROC_ENTRY(glutSetIconTitle)
+    PROC_ENTRY(glutPositionWindow)
+    PROC_ENTRY(glutReshapeWindow)
+    PROC_ENTRY(glutPopWindow)
+    PROC_ENTRY(glutPushWindow)
+    PROC_ENTRY(glutIconifyWindow)
+    PROC_ENTRY(glutShowWindow)
+    PROC_ENTRY(glutHideWindow)
+    PROC_ENTRY(glutFullScreen)
+    PROC_ENTRY(glutSetCursor)
+    PROC_ENTRY(glutWarpPointer)
+    PROC_ENTRY(glutEstablishOverlay)
+    PROC_ENTRY(glutRemoveOverlay)
+    PROC_ENTRY(glutUseLayer)
+    PROC_ENTRY(glutPostOverlayRedisplay)
+    PROC_ENTRY(glutPostWindowOverlayRedisplay)
+    PROC_ENTRY(glutShowOverlay)
+    PROC_ENTRY(glutHideOverlay)
+    PROC_ENTRY(glutCreateMenu)
+    PROC_ENTRY(glutDestroyMenu)
+    PROC_ENTRY(glutGetMenu)
+    PROC_ENTRY(glutSetMenu)
+    PROC_ENTRY(glutAddMenuEntry)
+    PROC_ENTRY(glutAddSubMenu)
+    PROC_ENTRY(glutChangeToMenuEntry)
+    PROC_ENTRY(glutChangeToSubMenu)
+    PROC_ENTRY(glutRemoveMenuItem)
+    PROC_ENTRY(glutAttachMenu)
+    PROC_ENTRY(glutDetachMenu)
+    PROC_ENTRY(glutDisplayFunc)
+    PROC_ENTRY(glutReshapeFunc)
+    PROC_ENTRY(glutPositionFunc)
+    PROC_ENTRY(glutKeyboardFunc)
+    PROC_ENTRY(glutMouseFunc)
+    PROC_ENTRY(glutMultiEntryFunc)
+    PROC_ENTRY(glutMultiMotionFunc)
+    PROC_ENTRY(glutMultiButtonFunc)
+    PROC_ENTRY(glutMultiPassiveFunc)
+    PROC_ENTRY(glutMotionFunc)
+    PROC_ENTRY(glutPassiveMotionFunc)
+    PROC_ENTRY(glutEntryFunc)
+    PROC_ENTRY(glutVisibilityFunc)
+    PROC_ENTRY(glutIdleFunc)
+    PROC_ENTRY(glutTimerFunc)
+    PROC_ENTRY(glutMenuStateFunc)
+    PROC_ENTRY(glutSpecialFunc)
+    PROC_ENTRY(glutSpaceballMotionFunc)
+    PROC_ENTRY(glutSpaceballRotateFunc)
+    PROC_ENTRY(glutSpaceballButtonFunc)
+    PROC_ENTRY(glutButtonBoxFunc)
+    PROC_ENTRY(glutDialsFunc)
+    PROC_ENTRY(glutTabletMotionFunc)
+    PROC_ENTRY(glutTabletButtonFunc)
+    PROC_ENTRY(glutMenuStatusFunc)
+    PROC_ENTRY(glutOverlayDisplayFunc)
+    PROC_ENTRY(glutWindowStatusFunc)
+    PROC_ENTRY(glutKeyboardUpFunc)
+    PROC_ENTRY(glutSpecialUpFunc)
+    PROC_ENTRY(glutSetColor)
+    PROC_ENTRY(glutGetColor)
+    PROC_ENTRY(glutCopyColormap)
+    PROC_ENTRY(glutGet)
+    PROC_ENTRY(glutDeviceGet)
+    PROC_ENTRY(glutExtensionSupported)
+    PROC_ENTRY(glutGetModifiers)
+    PROC_ENTRY(glutLayerGet)
+    PROC_ENTRY(glutBitmapCharacter)
+    PROC_ENTRY(glutBitmapWidth)
+    PROC_ENTRY(glutStrokeCharacter)
+    PROC_ENTRY(glutStrokeWidth)
+    PROC_ENTRY(glutStrokeWidthf)
+    PROC_ENTRY(glutBitmapLength)
+    PROC_ENTRY(glutStrokeLength)
+    PROC_ENTRY(glutStrokeLengthf)
+    PROC_ENTRY(glutWireSphere)
+    PROC_ENTRY(glutSolidSphere)
+    PROC_ENTRY(glutWireCone)
+    PROC_ENTRY(glutSolidCone)
+    PROC_ENTRY(glutWireTorus)
+    PROC_ENTRY(glutSolidTorus)
+    PROC_ENTRY(glutWireCylinder)
+    PROC_ENTRY(glutSolidCylinder)
+    PROC_ENTRY(glutWireTeapot)
+    PROC_ENTRY(glutSolidTeapot)
+    PROC_ENTRY(glutWireTeacup)
+    PROC_ENTRY(glutSolidTeacup)
+    PROC_ENTRY(glutWireTeaspoon)
+    PROC_ENTRY(glutSolidTeaspoon)
+    PROC_ENTRY(glutWireCube)
+    PROC_ENTRY(glutSolidCube)
+    PROC_ENTRY(glutWireDodecahedron)
+    PROC_ENTRY(glutSolidDodecahedron)
+    PROC_ENTRY(glutWireOctahedron)
+    PROC_ENTRY(glutSolidOctahedron)
+    PROC_ENTRY(glutWireTetrahedron)
+    PROC_ENTRY(glutSolidTetrahedron)
+    PROC_ENTRY(glutWireIcosahedron)
+    PROC_ENTRY(glutSolidIcosahedron)
+    PROC_ENTRY(glutWireRhombicDodecahedron)
+    PROC_ENTRY(glutSolidRhombicDodecahedron)
+    PROC_ENTRY(glutWireSierpinskiSponge)
+    PROC_ENTRY(glutSolidSierpinskiSponge)
+    PROC_ENTRY(glutVideoResizeGet)
+    PROC_ENTRY(glutSetupVideoResizing)
+    PROC_ENTRY(glutStopVideoResizing)
+    PROC_ENTRY(glutVideoResize)
+    PROC_ENTRY(glutVideoPan)
+    PROC_ENTRY(glutReportErrors)
+    PROC_ENTRY(glutIgnoreKeyRepeat)
+    PROC_ENTRY(glutSetKeyRepeat)
+
+    /* freeglut extensions */
+    PROC_ENTRY(glutMainLoopEvent)
+    PROC_ENTRY(glutLeaveMainLoop)
+    PROC_ENTRY(glutGetFrameStats)
+    PROC_ENTRY(glutCloseFunc)
+    PROC_ENTRY(glutWMCloseFunc)
+    PROC_ENTRY(glutMenuDestroyFunc)
+    PROC_ENTRY(glutTimerFuncNs)
+    PROC_ENTRY(glutCancelTimer)
+    PROC_ENTRY(glutFullScreenToggle)
+    PROC_ENTRY(glutLeaveFullScreen)
+    PROC_ENTRY(glutSwapInterval)
+    PROC_ENTRY(glutSwapBuffersWithDamage)
+    PROC_ENTRY(glutSetMenuFont)
+    PROC_ENTRY(glutSetOption)
+    PROC_ENTRY(glutGet64)
+    PROC_ENTRY(glutGetModeValues)
+    PROC_ENTRY(glutGetWindowConfig)
+    PROC_ENTRY(glutSetWindowData)
+    PROC_ENTRY(glutGetWindowData)
+    PROC_ENTRY(glutSetMenuData)
+    PROC_ENTRY(glutGetMenuData)
+    PROC_ENTRY(glutBitmapHeight)
+    PROC_ENTRY(glutStrokeHeight)
+    PROC_ENTRY(glutBitmapString)
+    PROC_ENTRY(glutStrokeString)
+    PROC_ENTRY(glutPrepareString)
+    PROC_ENTRY(glutDestroyPreparedString)
+    PROC_ENTRY(glutDrawPreparedString)
+    PROC_ENTRY(glutPreparedStringWidth)
+    PROC_ENTRY(glutPreparedStringLines)
+    PROC_ENTRY(glutGetProcAddress)
+    PROC_ENTRY(glutGetProcAddresses)
+    PROC_ENTRY(glutMouseWheelFunc)
+    PROC_ENTRY(glutJoystickGetNumAxes)
+    PROC_ENTRY(glutJoystickGetNumButtons)
+    PROC_ENTRY(glutJoystickNotWorking)
+    PROC_ENTRY(glutJoystickGetDeadBand)
+    PROC_ENTRY(glutJoystickSetDeadBand)
+    PROC_ENTRY(glutJoystickGetSaturation)
+    PROC_ENTRY(glutJoystickSetSaturation)
+    PROC_ENTRY(glutJoystickSetMinRange)
+    PROC_ENTRY(glutJoystickSetMaxRange)
+    PROC_ENTRY(glutJoystickSetCenter)
+    PROC_ENTRY(glutJoystickGetMinRange)
+    PROC_ENTRY(glutJoystickGetMaxRange)
+    PROC_ENTRY(glutJoystickGetCenter)
+    PROC_ENTRY(glutInitContextVersion)
+    PROC_ENTRY(glutInitContextFlags)
+    PROC_ENTRY(glutInitContextProfile)
+    PROC_ENTRY(glutInitErrorFunc)
+    PROC_ENTRY(glutInitWarningFunc)
+    PROC_ENTRY(glutInitContextFunc)
+    PROC_ENTRY(glutAppStatusFunc)
+    PROC_ENTRY(glutSetVertexAttribCoord3)
+    PROC_ENTRY(glutSetVertexAttribNormal)
+    PROC_ENTRY(glutSetVertexAttribTexCoord2)
+    PROC_ENTRY(glutSetVertexAttribInstance)
+    PROC_ENTRY(glutFlushGeometryCache)
+    PROC_ENTRY(glutWireShapeInstanced)
+    PROC_ENTRY(glutSolidShapeInstanced)
+    PROC_ENTRY(glutWireShapeLOD)
+    PROC_ENTRY(glutSolidShapeLOD)
+
+    /* freeglut user callback functions */
+    PROC_ENTRY(glutCreateMenuUcall)
+    PROC_ENTRY(glutTimerFuncUcall)
+    PROC_ENTRY(glutTimerFuncNsUcall)
+    PROC_ENTRY(glutIdleFuncUcall)
+    PROC_ENTRY(glutKeyboardFuncUcall)
+    PROC_ENTRY(glutSpecialFuncUcall)
+    PROC_ENTRY(glutReshapeFuncUcall)
+    PROC_ENTRY(glutVisibilityFuncUcall)
+    PROC_ENTRY(glutDisplayFuncUcall)
+    PROC_ENTRY(glutMouseFuncUcall)
+    PROC_ENTRY(glutMotionFuncUcall)
+    PROC_ENTRY(glutPassiveMotionFuncUcall)
+    PROC_ENTRY(glutEntryFuncUcall)
+    PROC_ENTRY(glutKeyboardUpFuncUcall)
+    PROC_ENTRY(glutSpecialUpFuncUcall)
+    PROC_ENTRY(glutJoystickFuncUcall)
+    PROC_ENTRY(glutMenuStatusFuncUcall)
+    PROC_ENTRY(glutOverlayDisplayFuncUcall)
+    PROC_ENTRY(glutWindowStatusFuncUcall)
+    PROC_ENTRY(glutSpaceballMotionFuncUcall)
+    PROC_ENTRY(glutSpaceballRotateFuncUcall)
+    PROC_ENTRY(glutSpaceballButtonFuncUcall)
+    PROC_ENTRY(glutButtonBoxFuncUcall)
+    PROC_ENTRY(glutDialsFuncUcall)
+    PROC_ENTRY(glutTabletMotionFuncUcall)
+    PROC_ENTRY(glutTabletButtonFuncUcall)
+    PROC_ENTRY(glutMouseWheelFuncUcall)
+    PROC_ENTRY(glutPositionFuncUcall)
+    PROC_ENTRY(glutCloseFuncUcall)
+    PROC_ENTRY(glutWMCloseFuncUcall)
+    PROC_ENTRY(glutMenuDestroyFuncUcall)
+    PROC_ENTRY(glutMultiEntryFuncUcall)
+    PROC_ENTRY(glutMultiButtonFuncUcall)
+    PROC_ENTRY(glutMultiMotionFuncUcall)
+    PROC_ENTRY(glutMultiPassiveFuncUcall)
+    PROC_ENTRY(glutInitErrorFuncUcall)
+    PROC_ENTRY(glutInitWarningFuncUcall)
+    PROC_ENTRY(glutInitContextFuncUcall)
+    PROC_ENTRY(glutAppStatusFuncUcall)
+#undef PROC_ENTRY
+};
+#define FGH_NUM_PROCS ( int )( sizeof( fghProcTable ) / sizeof( fghProcTable[ 0 ] ) )
+
+static GLboolean fghProcTableSorted = GL_FALSE;
+
+static int fghCompareProcEntries( const void *a, const void *b )
+{
+    return strcmp( ( ( const SFG_ProcEntry * )a )->Name,
+                   ( ( const SFG_ProcEntry * )b )->Name );
+}
+
 static GLUTproc fghGetGLUTProcAddress( const char* procName )
 {
+    SFG_ProcEntry key, *entry;
+
     /* optimization: quick initial check */
     if( strncmp( procName, "glut", 4 ) != 0 )
         return NULL;
 
-#define CHECK_NAME(x) if( strcmp( procName, #x ) == 0) return (GLUTproc)x;
-    CHECK_NAME(glutInit);
-    CHECK_NAME(glutInitDisplayMode);
-    CHECK_NAME(glutInitDisplayString);
-    CHECK_NAME(glutInitWindowPosition);
-    CHECK_NAME(glutInitWindowSize);
-    CHECK_NAME(glutMainLoop);
-    CHECK_NAME(glutExit);
-    CHECK_NAME(glutCreateWindow);
-    CHECK_NAME(glutCreateSubWindow);
-    CHECK_NAME(glutDestroyWindow);
-    CHECK_NAME(glutPostRedisplay);
-    CHECK_NAME(glutPostWindowRedisplay);
-    CHECK_NAME(glutSwapBuffers);
-    CHECK_NAME(glutGetWindow);
-    CHECK_NAME(glutSetWindow);
-    CHECK_NAME(glutSetWindowTitle);
-    CHECK_NAME(glutSetIconTitle);
-    CHECK_NAME(glutPositionWindow);
-    CHECK_NAME(glutReshapeWindow);
-    CHECK_NAME(glutPopWindow);
-    CHECK_NAME(glutPushWindow);
-    CHECK_NAME(glutIconifyWindow);
-    CHECK_NAME(glutShowWindow);
-    CHECK_NAME(glutHideWindow);
-    CHECK_NAME(glutFullScreen);
-    CHECK_NAME(glutSetCursor);
-    CHECK_NAME(glutWarpPointer);
-    CHECK_NAME(glutEstablishOverlay);
-    CHECK_NAME(glutRemoveOverlay);
-    CHECK_NAME(glutUseLayer);
-    CHECK_NAME(glutPostOverlayRedisplay);
-    CHECK_NAME(glutPostWindowOverlayRedisplay);
-    CHECK_NAME(glutShowOverlay);
-    CHECK_NAME(glutHideOverlay);
-    CHECK_NAME(glutCreateMenu);
-    CHECK_NAME(glutDestroyMenu);
-    CHECK_NAME(glutGetMenu);
-    CHECK_NAME(glutSetMenu);
-    CHECK_NAME(glutAddMenuEntry);
-    CHECK_NAME(glutAddSubMenu);
-    CHECK_NAME(glutChangeToMenuEntry);
-    CHECK_NAME(glutChangeToSubMenu);
-    CHECK_NAME(glutRemoveMenuItem);
-    CHECK_NAME(glutAttachMenu);
-    CHECK_NAME(glutDetachMenu);
-    CHECK_NAME(glutDisplayFunc);
-    CHECK_NAME(glutReshapeFunc);
-    CHECK_NAME(glutPositionFunc);
-    CHECK_NAME(glutKeyboardFunc);
-    CHECK_NAME(glutMouseFunc);
-    CHECK_NAME(glutMultiEntryFunc);
-    CHECK_NAME(glutMultiMotionFunc);
-    CHECK_NAME(glutMultiButtonFunc);
-    CHECK_NAME(glutMultiPassiveFunc);
-    CHECK_NAME(glutMotionFunc);
-    CHECK_NAME(glutPassiveMotionFunc);
-    CHECK_NAME(glutEntryFunc);
-    CHECK_NAME(glutVisibilityFunc);
-    CHECK_NAME(glutIdleFunc);
-    CHECK_NAME(glutTimerFunc);
-    CHECK_NAME(glutMenuStateFunc);
-    CHECK_NAME(glutSpecialFunc);
-    CHECK_NAME(glutSpaceballMotionFunc);
-    CHECK_NAME(glutSpaceballRotateFunc);
-    CHECK_NAME(glutSpaceballButtonFunc);
-    CHECK_NAME(glutButtonBoxFunc);
-    CHECK_NAME(glutDialsFunc);
-    CHECK_NAME(glutTabletMotionFunc);
-    CHECK_NAME(glutTabletButtonFunc);
-    CHECK_NAME(glutMenuStatusFunc);
-    CHECK_NAME(glutOverlayDisplayFunc);
-    CHECK_NAME(glutWindowStatusFunc);
-    CHECK_NAME(glutKeyboardUpFunc);
-    CHECK_NAME(glutSpecialUpFunc);
-    CHECK_NAME(glutSetColor);
-    CHECK_NAME(glutGetColor);
-    CHECK_NAME(glutCopyColormap);
-    CHECK_NAME(glutGet);
-    CHECK_NAME(glutDeviceGet);
-    CHECK_NAME(glutExtensionSupported);
-    CHECK_NAME(glutGetModifiers);
-    CHECK_NAME(glutLayerGet);
-    CHECK_NAME(glutBitmapCharacter);
-    CHECK_NAME(glutBitmapWidth);
-    CHECK_NAME(glutStrokeCharacter);
-    CHECK_NAME(glutStrokeWidth);
-    CHECK_NAME(glutStrokeWidthf);
-    CHECK_NAME(glutBitmapLength);
-    CHECK_NAME(glutStrokeLength);
-    CHECK_NAME(glutStrokeLengthf);
-    CHECK_NAME(glutWireSphere);
-    CHECK_NAME(glutSolidSphere);
-    CHECK_NAME(glutWireCone);
-    CHECK_NAME(glutSolidCone);
-    CHECK_NAME(glutWireTorus);
-    CHECK_NAME(glutSolidTorus);
-    CHECK_NAME(glutWireCylinder);
-    CHECK_NAME(glutSolidCylinder);
-    CHECK_NAME(glutWireTeapot);
-    CHECK_NAME(glutSolidTeapot);
-    CHECK_NAME(glutWireTeacup);
-    CHECK_NAME(glutSolidTeacup);
-    CHECK_NAME(glutWireTeaspoon);
-    CHECK_NAME(glutSolidTeaspoon);
-    CHECK_NAME(glutWireCube);
-    CHECK_NAME(glutSolidCube);
-    CHECK_NAME(glutWireDodecahedron);
-    CHECK_NAME(glutSolidDodecahedron);
-    CHECK_NAME(glutWireOctahedron);
-    CHECK_NAME(glutSolidOctahedron);
-    CHECK_NAME(glutWireTetrahedron);
-    CHECK_NAME(glutSolidTetrahedron);
-    CHECK_NAME(glutWireIcosahedron);
-    CHECK_NAME(glutSolidIcosahedron);
-    CHECK_NAME(glutWireRhombicDodecahedron);
-    CHECK_NAME(glutSolidRhombicDodecahedron);
-    CHECK_NAME(glutWireSierpinskiSponge);
-    CHECK_NAME(glutSolidSierpinskiSponge);
-    CHECK_NAME(glutVideoResizeGet);
-    CHECK_NAME(glutSetupVideoResizing);
-    CHECK_NAME(glutStopVideoResizing);
-    CHECK_NAME(glutVideoResize);
-    CHECK_NAME(glutVideoPan);
-    CHECK_NAME(glutReportErrors);
-    CHECK_NAME(glutIgnoreKeyRepeat);
-    CHECK_NAME(glutSetKeyRepeat);
-
-    /* freeglut extensions */
-    CHECK_NAME(glutMainLoopEvent);
-    CHECK_NAME(glutLeaveMainLoop);
-    CHECK_NAME(glutCloseFunc);
-    CHECK_NAME(glutWMCloseFunc);
-    CHECK_NAME(glutMenuDestroyFunc);
-    CHECK_NAME(glutFullScreenToggle);
-    CHECK_NAME(glutLeaveFullScreen);
-    CHECK_NAME(glutSetMenuFont);
-    CHECK_NAME(glutSetOption);
-    CHECK_NAME(glutGetModeValues);
-    CHECK_NAME(glutSetWindowData);
-    CHECK_NAME(glutGetWindowData);
-    CHECK_NAME(glutSetMenuData);
-    CHECK_NAME(glutGetMenuData);
-    CHECK_NAME(glutBitmapHeight);
-    CHECK_NAME(glutStrokeHeight);
-    CHECK_NAME(glutBitmapString);
-    CHECK_NAME(glutStrokeString);
-    CHECK_NAME(glutGetProcAddress);
-    CHECK_NAME(glutMouseWheelFunc);
-    CHECK_NAME(glutJoystickGetNumAxes);
-    CHECK_NAME(glutJoystickGetNumButtons);
-    CHECK_NAME(glutJoystickNotWorking);
-    CHECK_NAME(glutJoystickGetDeadBand);
-    CHECK_NAME(glutJoystickSetDeadBand);
-    CHECK_NAME(glutJoystickGetSaturation);
-    CHECK_NAME(glutJoystickSetSaturation);
-    CHECK_NAME(glutJoystickSetMinRange);
-    CHECK_NAME(glutJoystickSetMaxRange);
-    CHECK_NAME(glutJoystickSetCenter);
-    CHECK_NAME(glutJoystickGetMinRange);
-    CHECK_NAME(glutJoystickGetMaxRange);
-    CHECK_NAME(glutJoystickGetCenter);
-    CHECK_NAME(glutInitContextVersion);
-    CHECK_NAME(glutInitContextFlags);
-    CHECK_NAME(glutInitContextProfile);
-    CHECK_NAME(glutInitErrorFunc);
-    CHECK_NAME(glutInitWarningFunc);
-    CHECK_NAME(glutInitContextFunc);
-    CHECK_NAME(glutAppStatusFunc);
-    CHECK_NAME(glutSetVertexAttribCoord3);
-    CHECK_NAME(glutSetVertexAttribNormal);
-    CHECK_NAME(glutSetVertexAttribTexCoord2);
+    if( !fghProcTableSorted )
+    {
+        qsort( fghProcTable, FGH_NUM_PROCS, sizeof( SFG_ProcEntry ),
+               fghCompareProcEntries );
+        fghProcTableSorted = GL_TRUE;
+    }
 
-    /* freeglut user callback functions */
-    CHECK_NAME(glutCreateMenuUcall);
-    CHECK_NAME(glutTimerFuncUcall);
-    CHECK_NAME(glutIdleFuncUcall);
-    CHECK_NAME(glutKeyboardFuncUcall);
-    CHECK_NAME(glutSpecialFuncUcall);
-    CHECK_NAME(glutReshapeFuncUcall);
-    CHECK_NAME(glutVisibilityFuncUcall);
-    CHECK_NAME(glutDisplayFuncUcall);
-    CHECK_NAME(glutMouseFuncUcall);
-    CHECK_NAME(glutMotionFuncUcall);
-    CHECK_NAME(glutPassiveMotionFuncUcall);
-    CHECK_NAME(glutEntryFuncUcall);
-    CHECK_NAME(glutKeyboardUpFuncUcall);
-    CHECK_NAME(glutSpecialUpFuncUcall);
-    CHECK_NAME(glutJoystickFuncUcall);
-    CHECK_NAME(glutMenuStatusFuncUcall);
-    CHECK_NAME(glutOverlayDisplayFuncUcall);
-    CHECK_NAME(glutWindowStatusFuncUcall);
-    CHECK_NAME(glutSpaceballMotionFuncUcall);
-    CHECK_NAME(glutSpaceballRotateFuncUcall);
-    CHECK_NAME(glutSpaceballButtonFuncUcall);
-    CHECK_NAME(glutButtonBoxFuncUcall);
-    CHECK_NAME(glutDialsFuncUcall);
-    CHECK_NAME(glutTabletMotionFuncUcall);
-    CHECK_NAME(glutTabletButtonFuncUcall);
-    CHECK_NAME(glutMouseWheelFuncUcall);
-    CHECK_NAME(glutPositionFuncUcall);
-    CHECK_NAME(glutCloseFuncUcall);
-    CHECK_NAME(glutWMCloseFuncUcall);
-    CHECK_NAME(glutMenuDestroyFuncUcall);
-    CHECK_NAME(glutMultiEntryFuncUcall);
-    CHECK_NAME(glutMultiButtonFuncUcall);
-    CHECK_NAME(glutMultiMotionFuncUcall);
-    CHECK_NAME(glutMultiPassiveFuncUcall);
-    CHECK_NAME(glutInitErrorFuncUcall);
-    CHECK_NAME(glutInitWarningFuncUcall);
-    CHECK_NAME(glutInitContextFuncUcall);
-    CHECK_NAME(glutAppStatusFuncUcall);
-#undef CHECK_NAME
+    key.Name = procName;
+    entry = bsearch( &key, fghProcTable, FGH_NUM_PROCS, sizeof( SFG_ProcEntry ),
+                     fghCompareProcEntries );
 
-    return NULL;
+    return entry ? entry->Proc : NULL;
 }
 
 
@@ -272,3 +328,30 @@ glutGetProcAddress( const char *procName )
 
     return ( p != NULL ) ? p : fgPlatformGetProcAddress( procName );
 }
+
+/*
+ * Resolves count names at once, the same way glutGetProcAddress does.
+ * Names that can't be resolved get NULL. Returns the number resolved.
+ */
+int FGAPIENTRY
+glutGetProcAddresses( const char **procNames, GLUTproc *procs, int count )
+{
+    int i, found = 0;
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutGetProcAddresses" );
+
+    for( i = 0; i < count; i++ )
+    {
+        GLUTproc p = fghGetGLUTProcAddress( procNames[ i ] );
+
+        if ( !p )
+            p = fgPlatformGetGLUTProcAddress( procNames[ i ] );
+        if ( !p )
+            p = fgPlatformGetProcAddress( procNames[ i ] );
+
+        procs[ i ] = p;
+        if( p )
+            found++;
+    }
+
+    return found;
+}
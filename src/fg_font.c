@@ -27,6 +27,7 @@
 
 #include <GL/freeglut.h>
 #include "fg_internal.h"
+#include "fg_gl2.h"
 
 /*
  * TODO BEFORE THE STABLE RELEASE:
@@ -90,6 +91,754 @@ static SFG_StrokeFont* fghStrokeByID( void* font )
     return 0;
 }
 
+/* -- BITMAP FONT ATLASES -------------------------------------------------- */
+/*
+ * glBitmap is slow on many drivers and gone from core profiles. With
+ * GLUT_BITMAP_FONT_ATLAS set (and always on core profiles), the glyphs of
+ * a font are expanded once per window (and thus per context) into a
+ * texture, laid out on a 16x16 grid of cells, and a string is drawn as
+ * batches of textured triangles.
+ *
+ * On the fixed function path the quads are placed and coloured exactly
+ * like glBitmap would place the glyphs at the current raster position,
+ * which is advanced afterwards. When the current window has both a
+ * coordinate and a texture coordinate attribute set (see
+ * glutSetVertexAttribCoord3 and glutSetVertexAttribTexCoord2), the quads
+ * go through those attributes instead: in font pixel units, starting at
+ * the origin, with the glyph texture bound to the active texture unit.
+ * There the glyph coverage is in the alpha channel, or in the red channel
+ * on core profiles.
+ */
+#define FGH_DRAW_BITMAP     0   /* glBitmap                                */
+#define FGH_DRAW_QUADS      1   /* Textured quads at the raster position   */
+#define FGH_DRAW_ATTRIBUTES 2   /* Textured quads through vertex attributes */
+
+#define FGH_GLYPHS_PER_BATCH 64
+#define FGH_FLOATS_PER_GLYPH 24 /* Two triangles of x, y, s, t            */
+
+static SFG_Font* const fghBitmapFonts[ FG_NUM_BITMAP_FONTS ] =
+{
+    &fgFontFixed8x13, &fgFontFixed9x15, &fgFontTimesRoman10,
+    &fgFontTimesRoman24, &fgFontHelvetica10, &fgFontHelvetica12,
+    &fgFontHelvetica18
+};
+
+/* Size of the glyph cells and of the texture, the same in every context */
+typedef struct tagSFG_FontAtlasLayout SFG_FontAtlasLayout;
+struct tagSFG_FontAtlasLayout
+{
+    int CellWidth, CellHeight;
+    int Width, Height;
+};
+static SFG_FontAtlasLayout fghAtlasLayouts[ FG_NUM_BITMAP_FONTS ];
+
+static int fghBitmapFontIndex( const SFG_Font* font )
+{
+    int i;
+
+    for( i = 0; i < FG_NUM_BITMAP_FONTS; i++ )
+        if( fghBitmapFonts[ i ] == font )
+            return i;
+
+    return -1;
+}
+
+static GLboolean fghIsCoreProfile( void )
+{
+    return ( fgState.ContextProfile == GLUT_CORE_PROFILE ) ||
+           ( ( fgState.ContextFlags & GLUT_FORWARD_COMPATIBLE ) &&
+             fgState.MajorVersion >= 3 );
+}
+
+/*
+ * How should bitmap text be drawn in the current window? The glyph
+ * textures are used if atlas is set, and always on core profiles.
+ */
+static int fghBitmapDrawMode( GLboolean atlas )
+{
+    SFG_Window *window = fgStructure.CurrentWindow;
+    GLboolean core = fghIsCoreProfile( );
+
+    if( !window || ( !atlas && !core ) )
+        return FGH_DRAW_BITMAP;
+
+    if( fgState.HasOpenGL20 &&
+        window->Window.attribute_v_coord != -1 &&
+        window->Window.attribute_v_texture != -1 )
+        return FGH_DRAW_ATTRIBUTES;
+
+    if( !core )
+    {
+        /* Quads need the raster position when drawn, not when compiled */
+        GLint list;
+        glGetIntegerv( GL_LIST_INDEX, &list );
+        return list ? FGH_DRAW_BITMAP : FGH_DRAW_QUADS;
+    }
+
+    /* There is nothing else left to try on core profiles */
+    return FGH_DRAW_BITMAP;
+}
+
+static const SFG_FontAtlasLayout* fghAtlasLayout( int index )
+{
+    SFG_FontAtlasLayout *layout = &fghAtlasLayouts[ index ];
+
+    if( !layout->Width )
+    {
+        const SFG_Font *font = fghBitmapFonts[ index ];
+        int c, maxWidth = 0;
+
+        for( c = 1; c < 256; c++ )
+            if( font->Characters[ c ][ 0 ] > maxWidth )
+                maxWidth = font->Characters[ c ][ 0 ];
+
+        /* One texel between the cells, and power of two sizes for OpenGL 1.x */
+        layout->CellWidth  = maxWidth + 1;
+        layout->CellHeight = font->Height + 1;
+        for( layout->Width = 1; layout->Width < 16 * layout->CellWidth; layout->Width *= 2 )
+            ;
+        for( layout->Height = 1; layout->Height < 16 * layout->CellHeight; layout->Height *= 2 )
+            ;
+    }
+
+    return layout;
+}
+
+/*
+ * Returns the current window's glyph texture of a font, expanding the
+ * font's bitmaps into a new one if there isn't one yet
+ */
+static GLuint fghFontAtlas( int index )
+{
+    SFG_Window *window = fgStructure.CurrentWindow;
+    const SFG_Font *font = fghBitmapFonts[ index ];
+    const SFG_FontAtlasLayout *layout;
+    GLubyte *texels;
+    GLenum format = fghIsCoreProfile( ) ? GL_RED : GL_ALPHA;
+    GLint binding, align, rowlen, skiprows, skippix;
+    int c, row, col;
+
+    if( window->Window.FontAtlases[ index ] )
+        return window->Window.FontAtlases[ index ];
+
+    layout = fghAtlasLayout( index );
+    texels = calloc( layout->Width * layout->Height, 1 );
+    if( !texels )
+        return 0;
+
+    /* Rows of glBitmap data go bottom to top, most significant bit first */
+    for( c = 1; c < 256; c++ )
+    {
+        const GLubyte *face = font->Characters[ c ];
+        int rowBytes = ( face[ 0 ] + 7 ) / 8;
+        GLubyte *cell = texels + ( c / 16 ) * layout->CellHeight * layout->Width +
+                                 ( c % 16 ) * layout->CellWidth;
+
+        for( row = 0; row < font->Height; row++ )
+            for( col = 0; col < face[ 0 ]; col++ )
+                if( face[ 1 + row * rowBytes + col / 8 ] & ( 0x80 >> ( col % 8 ) ) )
+                    cell[ row * layout->Width + col ] = 255;
+    }
+
+    glGetIntegerv( GL_TEXTURE_BINDING_2D, &binding );
+    glGetIntegerv( GL_UNPACK_ALIGNMENT, &align );
+    glGetIntegerv( GL_UNPACK_ROW_LENGTH, &rowlen );
+    glGetIntegerv( GL_UNPACK_SKIP_ROWS, &skiprows );
+    glGetIntegerv( GL_UNPACK_SKIP_PIXELS, &skippix );
+    glPixelStorei( GL_UNPACK_ALIGNMENT,   1 );
+    glPixelStorei( GL_UNPACK_ROW_LENGTH,  0 );
+    glPixelStorei( GL_UNPACK_SKIP_ROWS,   0 );
+    glPixelStorei( GL_UNPACK_SKIP_PIXELS, 0 );
+
+    glGenTextures( 1, &window->Window.FontAtlases[ index ] );
+    glBindTexture( GL_TEXTURE_2D, window->Window.FontAtlases[ index ] );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+    glTexImage2D( GL_TEXTURE_2D, 0, format, layout->Width, layout->Height, 0,
+                  format, GL_UNSIGNED_BYTE, texels );
+    window->Window.NumFontAtlases++;
+
+    glBindTexture( GL_TEXTURE_2D, binding );
+    glPixelStorei( GL_UNPACK_ALIGNMENT,   align );
+    glPixelStorei( GL_UNPACK_ROW_LENGTH,  rowlen );
+    glPixelStorei( GL_UNPACK_SKIP_ROWS,   skiprows );
+    glPixelStorei( GL_UNPACK_SKIP_PIXELS, skippix );
+
+    free( texels );
+    return window->Window.FontAtlases[ index ];
+}
+
+void fgFreeFontAtlases( SFG_Window *window )
+{
+    int i;
+
+    for( i = 0; i < FG_NUM_BITMAP_FONTS; i++ )
+        if( window->Window.FontAtlases[ i ] )
+        {
+            glDeleteTextures( 1, &window->Window.FontAtlases[ i ] );
+            window->Window.FontAtlases[ i ] = 0;
+        }
+    window->Window.NumFontAtlases = 0;
+
+    if( window->Window.FontBuffer )
+    {
+        fghDeleteBuffers( 1, &window->Window.FontBuffer );
+        window->Window.FontBuffer = 0;
+    }
+}
+
+/*
+ * Writes the two triangles of a glyph with its origin at x, y. Like
+ * glBitmap, the fixed function path snaps glyphs to whole pixels.
+ */
+static GLfloat* fghGlyphTriangles( GLfloat *v, const SFG_Font *font,
+                                   const SFG_FontAtlasLayout *layout,
+                                   int c, GLfloat x, GLfloat y, GLboolean snap )
+{
+    GLfloat x0 = x - font->xorig, y0 = y - font->yorig, x1, y1;
+    GLfloat s0, t0, s1, t1;
+    int width = font->Characters[ c ][ 0 ];
+
+    if( snap )
+    {
+        x0 = ( GLfloat )floor( x0 );
+        y0 = ( GLfloat )floor( y0 );
+    }
+    x1 = x0 + width;
+    y1 = y0 + font->Height;
+
+    s0 = ( GLfloat )( ( c % 16 ) * layout->CellWidth  ) / layout->Width;
+    t0 = ( GLfloat )( ( c / 16 ) * layout->CellHeight ) / layout->Height;
+    s1 = s0 + ( GLfloat )width / layout->Width;
+    t1 = t0 + ( GLfloat )font->Height / layout->Height;
+
+    *v++ = x0; *v++ = y0; *v++ = s0; *v++ = t0;
+    *v++ = x1; *v++ = y0; *v++ = s1; *v++ = t0;
+    *v++ = x1; *v++ = y1; *v++ = s1; *v++ = t1;
+    *v++ = x0; *v++ = y0; *v++ = s0; *v++ = t0;
+    *v++ = x1; *v++ = y1; *v++ = s1; *v++ = t1;
+    *v++ = x0; *v++ = y1; *v++ = s0; *v++ = t1;
+
+    return v;
+}
+
+static void fghFlushGlyphs( int mode, const GLfloat *vertices, GLsizei numVertices )
+{
+    if( !numVertices )
+        return;
+
+    if( mode == FGH_DRAW_ATTRIBUTES )
+    {
+        SFG_Window *window = fgStructure.CurrentWindow;
+
+        fghBindBuffer( FGH_ARRAY_BUFFER, window->Window.FontBuffer );
+        fghBufferData( FGH_ARRAY_BUFFER, numVertices * 4 * sizeof( GLfloat ),
+                       vertices, FGH_STREAM_DRAW );
+        fghVertexAttribPointer( window->Window.attribute_v_coord, 2, GL_FLOAT,
+                                GL_FALSE, 4 * sizeof( GLfloat ), 0 );
+        fghVertexAttribPointer( window->Window.attribute_v_texture, 2, GL_FLOAT,
+                                GL_FALSE, 4 * sizeof( GLfloat ),
+                                ( const GLvoid * )( 2 * sizeof( GLfloat ) ) );
+        fghBindBuffer( FGH_ARRAY_BUFFER, 0 );
+    }
+    else
+    {
+        glVertexPointer( 2, GL_FLOAT, 4 * sizeof( GLfloat ), vertices );
+        glTexCoordPointer( 2, GL_FLOAT, 4 * sizeof( GLfloat ), vertices + 2 );
+    }
+
+    glDrawArrays( GL_TRIANGLES, 0, numVertices );
+}
+
+/*
+ * Sets up drawing glyphs from a font's texture, returning the window
+ * coordinates the text starts at in origin. Returns GL_FALSE if there is
+ * nothing to draw. The texture binding to put back is left in binding.
+ */
+static GLboolean fghBeginAtlas( int mode, const SFG_Font *font,
+                                GLfloat *origin, GLint *binding )
+{
+    SFG_Window *window = fgStructure.CurrentWindow;
+    GLfloat raster[ 4 ], color[ 4 ];
+    GLint viewport[ 4 ];
+    GLuint atlas;
+    int i;
+
+    atlas = fghFontAtlas( fghBitmapFontIndex( font ) );
+    if( !atlas )
+        return GL_FALSE;
+
+    origin[ 0 ] = origin[ 1 ] = 0.0f;
+    *binding = 0;
+
+    if( mode == FGH_DRAW_ATTRIBUTES )
+    {
+        if( !window->Window.FontBuffer )
+            fghGenBuffers( 1, &window->Window.FontBuffer );
+
+        glGetIntegerv( GL_TEXTURE_BINDING_2D, binding );
+        glBindTexture( GL_TEXTURE_2D, atlas );
+        fghEnableVertexAttribArray( window->Window.attribute_v_coord );
+        fghEnableVertexAttribArray( window->Window.attribute_v_texture );
+    }
+    else
+    {
+        GLboolean valid;
+
+        /* Like glBitmap, draw nothing (and stay put) if the position is invalid */
+        glGetBooleanv( GL_CURRENT_RASTER_POSITION_VALID, &valid );
+        if( !valid )
+            return GL_FALSE;
+        glGetFloatv( GL_CURRENT_RASTER_POSITION, raster );
+        glGetFloatv( GL_CURRENT_RASTER_COLOR, color );
+        glGetIntegerv( GL_VIEWPORT, viewport );
+        origin[ 0 ] = raster[ 0 ];
+        origin[ 1 ] = raster[ 1 ];
+
+        /*
+         * Bitmaps skip the vertex pipeline: draw in window coordinates,
+         * at the raster position's depth, and only keep the per fragment
+         * operations.
+         */
+        glPushAttrib( GL_ENABLE_BIT | GL_CURRENT_BIT | GL_COLOR_BUFFER_BIT |
+                      GL_TEXTURE_BIT | GL_POLYGON_BIT | GL_VIEWPORT_BIT |
+                      GL_TRANSFORM_BIT );
+        glPushClientAttrib( GL_CLIENT_VERTEX_ARRAY_BIT );
+
+        glDisable( GL_LIGHTING );
+        glDisable( GL_CULL_FACE );
+        glDisable( GL_POLYGON_STIPPLE );
+        glDisable( GL_POLYGON_OFFSET_FILL );
+        glDisable( GL_TEXTURE_GEN_S );
+        glDisable( GL_TEXTURE_GEN_T );
+        glDisable( GL_TEXTURE_1D );
+        for( i = 0; i < 6; i++ )
+            glDisable( GL_CLIP_PLANE0 + i );
+        glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
+        glDepthRange( 0.0, 1.0 );
+
+        glEnable( GL_TEXTURE_2D );
+        glBindTexture( GL_TEXTURE_2D, atlas );
+        glTexEnvi( GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE );
+        glEnable( GL_ALPHA_TEST );
+        glAlphaFunc( GL_GREATER, 0.0f );
+        glColor4fv( color );
+
+        glMatrixMode( GL_TEXTURE );
+        glPushMatrix( );
+        glLoadIdentity( );
+        glMatrixMode( GL_PROJECTION );
+        glPushMatrix( );
+        glLoadIdentity( );
+        glOrtho( viewport[ 0 ], viewport[ 0 ] + viewport[ 2 ],
+                 viewport[ 1 ], viewport[ 1 ] + viewport[ 3 ], 0.0, -1.0 );
+        glMatrixMode( GL_MODELVIEW );
+        glPushMatrix( );
+        glLoadIdentity( );
+        glTranslatef( 0.0f, 0.0f, raster[ 2 ] );
+
+        if( fgState.HasOpenGL20 )
+            fghBindBuffer( FGH_ARRAY_BUFFER, 0 );
+        glDisableClientState( GL_COLOR_ARRAY );
+        glEnableClientState( GL_VERTEX_ARRAY );
+        glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+    }
+
+    return GL_TRUE;
+}
+
+/*
+ * Undoes fghBeginAtlas, and moves the raster position by x, y as glBitmap
+ * would
+ */
+static void fghEndAtlas( int mode, GLint binding, GLfloat x, GLfloat y )
+{
+    SFG_Window *window = fgStructure.CurrentWindow;
+
+    if( mode == FGH_DRAW_ATTRIBUTES )
+    {
+        fghDisableVertexAttribArray( window->Window.attribute_v_coord );
+        fghDisableVertexAttribArray( window->Window.attribute_v_texture );
+        glBindTexture( GL_TEXTURE_2D, binding );
+    }
+    else
+    {
+        glMatrixMode( GL_TEXTURE );
+        glPopMatrix( );
+        glMatrixMode( GL_PROJECTION );
+        glPopMatrix( );
+        glMatrixMode( GL_MODELVIEW );
+        glPopMatrix( );
+        glPopClientAttrib( );
+        glPopAttrib( );
+
+        /* The raster position was restored too, move it past the string */
+        glBitmap( 0, 0, 0, 0, x, y, NULL );
+    }
+}
+
+/*
+ * Draws length characters of a string from the font's glyph texture.
+ * Newlines are only interpreted as such if newlines is set, as
+ * glutBitmapCharacter draws them like any other character.
+ */
+static void fghDrawAtlasString( int mode, const SFG_Font *font,
+                                const unsigned char *string, int length,
+                                GLboolean newlines )
+{
+    const SFG_FontAtlasLayout *layout = fghAtlasLayout( fghBitmapFontIndex( font ) );
+    GLfloat vertices[ FGH_GLYPHS_PER_BATCH * FGH_FLOATS_PER_GLYPH ];
+    GLfloat *v = vertices;
+    GLfloat origin[ 2 ], x = 0.0f, y = 0.0f;
+    GLint binding;
+    int i;
+
+    if( !fghBeginAtlas( mode, font, origin, &binding ) )
+        return;
+
+    for( i = 0; i < length; i++ )
+    {
+        int c = string[ i ];
+
+        if( c == '\n' && newlines )
+        {
+            x = 0.0f;
+            y -= font->Height;
+            continue;
+        }
+
+        if( font->Characters[ c ][ 0 ] )
+            v = fghGlyphTriangles( v, font, layout, c, origin[ 0 ] + x, origin[ 1 ] + y,
+                                   ( GLboolean )( mode == FGH_DRAW_QUADS ) );
+        x += font->Characters[ c ][ 0 ];
+
+        if( v == vertices + FGH_GLYPHS_PER_BATCH * FGH_FLOATS_PER_GLYPH )
+        {
+            fghFlushGlyphs( mode, vertices, FGH_GLYPHS_PER_BATCH * 6 );
+            v = vertices;
+        }
+    }
+    fghFlushGlyphs( mode, vertices, ( GLsizei )( v - vertices ) / 4 );
+
+    fghEndAtlas( mode, binding, x, y );
+}
+
+
+/* -- STROKE FONT LINES ---------------------------------------------------- */
+/*
+ * Drawing the strips of a stroke font with glBegin/glVertex takes hundreds
+ * of calls per line of text, and doesn't work on core profiles. Instead,
+ * the strips of each font are flattened once into line segments, with the
+ * first vertex and number of vertices of every character, and a string is
+ * drawn by copying its characters' segments, moved along the line, into
+ * one array that takes a single glDrawArrays. Like the geometry, that goes
+ * through the attribute set with glutSetVertexAttribCoord3 if there is one.
+ */
+typedef struct tagSFG_StrokeLines SFG_StrokeLines;
+struct tagSFG_StrokeLines
+{
+    GLfloat*        Vertices;     /* x, y of both ends of every segment */
+    int*            First;        /* Per character, first vertex...     */
+    int*            Count;        /* ...and number of vertices          */
+};
+static SFG_StrokeLines fghStrokeLines[ 2 ];
+
+/* Vertices of the string being drawn, kept to save reallocations */
+static GLfloat* fghStrokeBatch;
+static int      fghStrokeBatchSize;
+
+static const SFG_StrokeLines* fghGetStrokeLines( const SFG_StrokeFont* font )
+{
+    SFG_StrokeLines *lines = &fghStrokeLines[ font == &fgStrokeMonoRoman ? 1 : 0 ];
+    GLfloat *v;
+    int c, i, j, numVertices = 0;
+
+    if( lines->Vertices )
+        return lines;
+
+    for( c = 0; c < font->Quantity; c++ )
+        if( font->Characters[ c ] )
+            for( i = 0; i < font->Characters[ c ]->Number; i++ )
+                if( font->Characters[ c ]->Strips[ i ].Number > 1 )
+                    numVertices += 2 * ( font->Characters[ c ]->Strips[ i ].Number - 1 );
+
+    /* Bail out if memory allocation fails, fgError never returns */
+    lines->Vertices = malloc( ( numVertices ? numVertices : 1 ) * 2 * sizeof( GLfloat ) );
+    lines->First    = calloc( font->Quantity, sizeof( int ) );
+    lines->Count    = calloc( font->Quantity, sizeof( int ) );
+    if( !lines->Vertices || !lines->First || !lines->Count )
+        fgError( "Failed to allocate memory in fghGetStrokeLines" );
+
+    v = lines->Vertices;
+    for( c = 0; c < font->Quantity; c++ )
+    {
+        const SFG_StrokeChar *schar = font->Characters[ c ];
+
+        lines->First[ c ] = ( int )( v - lines->Vertices ) / 2;
+        if( !schar )
+            continue;
+
+        for( i = 0; i < schar->Number; i++ )
+        {
+            const SFG_StrokeStrip *strip = &schar->Strips[ i ];
+
+            for( j = 1; j < strip->Number; j++ )
+            {
+                *v++ = strip->Vertices[ j - 1 ].X;
+                *v++ = strip->Vertices[ j - 1 ].Y;
+                *v++ = strip->Vertices[ j ].X;
+                *v++ = strip->Vertices[ j ].Y;
+            }
+        }
+        lines->Count[ c ] = ( int )( v - lines->Vertices ) / 2 - lines->First[ c ];
+    }
+
+    return lines;
+}
+
+void fgFreeStrokeFontLines( void )
+{
+    int i;
+
+    for( i = 0; i < 2; i++ )
+    {
+        free( fghStrokeLines[ i ].Vertices );
+        free( fghStrokeLines[ i ].First );
+        free( fghStrokeLines[ i ].Count );
+        fghStrokeLines[ i ].Vertices = NULL;
+        fghStrokeLines[ i ].First = fghStrokeLines[ i ].Count = NULL;
+    }
+
+    free( fghStrokeBatch );
+    fghStrokeBatch = NULL;
+    fghStrokeBatchSize = 0;
+}
+
+/*
+ * Draws numVertices vertices of line segments, and the dots joining them
+ * if requested, in the current window
+ */
+static void fghDrawStrokeLines( const GLfloat *vertices, GLsizei numVertices, GLboolean dots )
+{
+    SFG_Window *window = fgStructure.CurrentWindow;
+
+    if( !numVertices )
+        return;
+
+    if( fgState.HasOpenGL20 && window && window->Window.attribute_v_coord != -1 )
+    {
+        GLint attribute_v_coord = window->Window.attribute_v_coord;
+
+        if( !window->Window.FontBuffer )
+            fghGenBuffers( 1, &window->Window.FontBuffer );
+
+        fghBindBuffer( FGH_ARRAY_BUFFER, window->Window.FontBuffer );
+        fghBufferData( FGH_ARRAY_BUFFER, numVertices * 2 * sizeof( GLfloat ),
+                       vertices, FGH_STREAM_DRAW );
+        fghEnableVertexAttribArray( attribute_v_coord );
+        fghVertexAttribPointer( attribute_v_coord, 2, GL_FLOAT, GL_FALSE, 0, 0 );
+        fghBindBuffer( FGH_ARRAY_BUFFER, 0 );
+
+        glDrawArrays( GL_LINES, 0, numVertices );
+        if( dots )
+            glDrawArrays( GL_POINTS, 0, numVertices );
+
+        fghDisableVertexAttribArray( attribute_v_coord );
+    }
+    else
+    {
+        GLint binding = 0;
+
+        /* The vertices are in client memory, not in a buffer the
+         * application may have bound
+         */
+        if( fgState.HasOpenGL20 )
+        {
+            glGetIntegerv( FGH_ARRAY_BUFFER_BINDING, &binding );
+            if( binding )
+                fghBindBuffer( FGH_ARRAY_BUFFER, 0 );
+        }
+
+        glEnableClientState( GL_VERTEX_ARRAY );
+        glVertexPointer( 2, GL_FLOAT, 0, vertices );
+
+        glDrawArrays( GL_LINES, 0, numVertices );
+        if( dots )
+            glDrawArrays( GL_POINTS, 0, numVertices );
+
+        glDisableClientState( GL_VERTEX_ARRAY );
+
+        if( binding )
+            fghBindBuffer( FGH_ARRAY_BUFFER, binding );
+    }
+}
+
+#ifdef GL_LINE_STIPPLE
+/*
+ * Line stipple patterns run on along a line strip, but start over with
+ * every segment of GL_LINES. With stippling on, characters are drawn strip
+ * by strip instead, as they were before the segment arrays.
+ */
+static GLboolean fghUseStrokeStrips( void )
+{
+    SFG_Window *window = fgStructure.CurrentWindow;
+
+    if( fghIsCoreProfile( ) ||
+        ( fgState.HasOpenGL20 && window && window->Window.attribute_v_coord != -1 ) )
+        return GL_FALSE;
+    return glIsEnabled( GL_LINE_STIPPLE );
+}
+
+static void fghDrawStrokeStrips( const SFG_StrokeChar *schar, GLboolean dots )
+{
+    const SFG_StrokeStrip *strip = schar->Strips;
+    int i, j;
+
+    for( i = 0; i < schar->Number; i++, strip++ )
+    {
+        glBegin( GL_LINE_STRIP );
+        for( j = 0; j < strip->Number; j++ )
+            glVertex2f( strip->Vertices[ j ].X, strip->Vertices[ j ].Y );
+        glEnd( );
+
+        if( dots )
+        {
+            glBegin( GL_POINTS );
+            for( j = 0; j < strip->Number; j++ )
+                glVertex2f( strip->Vertices[ j ].X, strip->Vertices[ j ].Y );
+            glEnd( );
+        }
+    }
+}
+
+/* Draws a string strip by strip, moving along as glutStrokeString does */
+static void fghDrawStrokeStringStrips( const SFG_StrokeFont *font, const unsigned char *string )
+{
+    unsigned char c;
+    GLfloat length = 0.0f;
+
+    while( ( c = *string++ ) )
+        if( c < font->Quantity )
+        {
+            if( c == '\n' )
+            {
+                glTranslatef( -length, -font->Height, 0.0 );
+                length = 0.0f;
+            }
+            else if( font->Characters[ c ] )
+            {
+                fghDrawStrokeStrips( font->Characters[ c ], GL_FALSE );
+                length += font->Characters[ c ]->Right;
+                glTranslatef( font->Characters[ c ]->Right, 0.0, 0.0 );
+            }
+        }
+}
+#endif
+
+/* Number of vertices the segments of a string take */
+static GLsizei fghStrokeStringVertices( const SFG_StrokeFont *font,
+                                        const SFG_StrokeLines *lines,
+                                        const unsigned char *string )
+{
+    unsigned char c;
+    GLsizei numVertices = 0;
+
+    while( ( c = *string++ ) )
+        if( c < font->Quantity && c != '\n' )
+            numVertices += lines->Count[ c ];
+
+    return numVertices;
+}
+
+/*
+ * Copies the segments of a string's characters to vertices, moved along
+ * the line. A newline will simply move the next character's insertion
+ * point back to the start of the line and down one line. Returns where
+ * the string ends in x and y.
+ */
+static void fghLayoutStrokeString( const SFG_StrokeFont *font,
+                                   const SFG_StrokeLines *lines,
+                                   const unsigned char *string,
+                                   GLfloat *v, GLfloat *x, GLfloat *y )
+{
+    unsigned char c;
+    int i;
+
+    *x = *y = 0.0f;
+    while( ( c = *string++) )
+        if( c < font->Quantity )
+        {
+            if( c == '\n' )
+            {
+                *x = 0.0f;
+                *y -= font->Height;
+            }
+            else  /* Not an EOL, add the stroke character */
+            {
+                const SFG_StrokeChar *schar = font->Characters[ c ];
+                if( schar )
+                {
+                    const GLfloat *src = lines->Vertices + 2 * lines->First[ c ];
+
+                    for( i = 0; i < lines->Count[ c ]; i++ )
+                    {
+                        *v++ = *src++ + *x;
+                        *v++ = *src++ + *y;
+                    }
+
+                    *x += schar->Right;
+                }
+            }
+        }
+}
+
+/* -- PREPARED STRINGS ----------------------------------------------------- */
+/*
+ * HUDs and the like measure and draw the same labels every frame. A
+ * prepared string keeps its font, text and measurements, and for stroke
+ * fonts the laid out segments, so drawing it again takes no measuring
+ * and no layout.
+ */
+typedef struct tagSFG_PreparedString SFG_PreparedString;
+struct tagSFG_PreparedString
+{
+    SFG_Node        Node;
+    int             ID;
+    void*           FontID;       /* As passed to glutPrepareString     */
+    SFG_StrokeFont* StrokeFont;   /* NULL for bitmap fonts              */
+    unsigned char*  Text;
+    GLfloat         Width;        /* Of the longest line                */
+    int             NumLines;
+    GLfloat*        Vertices;     /* Laid out segments of stroke fonts, */
+    GLsizei         NumVertices;  /* or glyph triangles of bitmap fonts */
+    GLfloat         EndX, EndY;   /* Where the string ends              */
+};
+static SFG_List    fghPreparedStrings = { NULL, NULL };
+static SFG_HashMap fghPreparedStringsByID = { NULL, 0, 0 };
+static int         fghPreparedStringID = 0;
+
+static SFG_PreparedString* fghPreparedStringByID( int stringID )
+{
+    return ( SFG_PreparedString * )fgHashFind( &fghPreparedStringsByID, ( size_t )stringID );
+}
+
+static void fghDestroyPreparedString( SFG_PreparedString *prepared )
+{
+    fgListRemove( &fghPreparedStrings, &prepared->Node );
+    fgHashRemove( &fghPreparedStringsByID, ( size_t )prepared->ID, prepared );
+    free( prepared->Text );
+    free( prepared->Vertices );
+    free( prepared );
+}
+
+void fgFreePreparedStrings( void )
+{
+    while( fghPreparedStrings.First )
+        fghDestroyPreparedString( ( SFG_PreparedString * )fghPreparedStrings.First );
+
+    fgHashFree( &fghPreparedStringsByID );
+    fghPreparedStringID = 0;
+}
 
 /* -- INTERFACE FUNCTIONS -------------------------------------------------- */
 
@@ -100,6 +849,7 @@ void FGAPIENTRY glutBitmapCharacter( void* fontID, int character )
 {
     const GLubyte* face;
     SFG_Font* font;
+    int mode;
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutBitmapCharacter" );
     font = fghFontByID( fontID );
     if (!font)
@@ -109,6 +859,14 @@ void FGAPIENTRY glutBitmapCharacter( void* fontID, int character )
     }
     freeglut_return_if_fail( ( character >= 1 )&&( character < 256 ) );
 
+    mode = fghBitmapDrawMode( fgState.BitmapFontAtlas );
+    if( mode != FGH_DRAW_BITMAP )
+    {
+        unsigned char c = ( unsigned char )character;
+        fghDrawAtlasString( mode, font, &c, 1, GL_FALSE );
+        return;
+    }
+
     /*
      * Find the character we want to draw (???)
      */
@@ -157,6 +915,7 @@ void FGAPIENTRY glutBitmapString( void* fontID, const unsigned char *string )
     unsigned char c;
     float x = 0.0f ;
     SFG_Font* font;
+    int mode;
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutBitmapString" );
     font = fghFontByID( fontID );
     if (!font)
@@ -167,6 +926,14 @@ void FGAPIENTRY glutBitmapString( void* fontID, const unsigned char *string )
     if ( !string || ! *string )
         return;
 
+    mode = fghBitmapDrawMode( fgState.BitmapFontAtlas );
+    if( mode != FGH_DRAW_BITMAP )
+    {
+        fghDrawAtlasString( mode, font, string, ( int )strlen( ( const char * )string ),
+                            GL_TRUE );
+        return;
+    }
+
 #ifdef GL_VERSION_1_1
     glPushClientAttrib( GL_CLIENT_PIXEL_STORE_BIT );
 #else
@@ -299,8 +1066,7 @@ int FGAPIENTRY glutBitmapHeight( void* fontID )
 void FGAPIENTRY glutStrokeCharacter( void* fontID, int character )
 {
     const SFG_StrokeChar *schar;
-    const SFG_StrokeStrip *strip;
-    int i, j;
+    const SFG_StrokeLines *lines;
     SFG_StrokeFont* font;
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutStrokeCharacter" );
     font = fghStrokeByID( fontID );
@@ -314,31 +1080,30 @@ void FGAPIENTRY glutStrokeCharacter( void* fontID, int character )
 
     schar = font->Characters[ character ];
     freeglut_return_if_fail( schar );
-    strip = schar->Strips;
 
-    for( i = 0; i < schar->Number; i++, strip++ )
+#ifdef GL_LINE_STIPPLE
+    if( fghUseStrokeStrips( ) )
     {
-        glBegin( GL_LINE_STRIP );
-        for( j = 0; j < strip->Number; j++ )
-            glVertex2f( strip->Vertices[ j ].X, strip->Vertices[ j ].Y );
-        glEnd( );
-        
-        if (fgState.StrokeFontDrawJoinDots)
-        {
-            glBegin( GL_POINTS );
-            for( j = 0; j < strip->Number; j++ )
-                glVertex2f( strip->Vertices[ j ].X, strip->Vertices[ j ].Y );
-            glEnd( );
-        }
+        fghDrawStrokeStrips( schar, fgState.StrokeFontDrawJoinDots );
+        glTranslatef( schar->Right, 0.0, 0.0 );
+        return;
     }
-    glTranslatef( schar->Right, 0.0, 0.0 );
+#endif
+
+    lines = fghGetStrokeLines( font );
+    fghDrawStrokeLines( lines->Vertices + 2 * lines->First[ character ],
+                        lines->Count[ character ], fgState.StrokeFontDrawJoinDots );
+
+    /* There is no matrix stack to move along on core profiles */
+    if( !fghIsCoreProfile( ) )
+        glTranslatef( schar->Right, 0.0, 0.0 );
 }
 
 void FGAPIENTRY glutStrokeString( void* fontID, const unsigned char *string )
 {
-    unsigned char c;
-    int i, j;
-    float length = 0.0;
+    const SFG_StrokeLines *lines;
+    GLfloat x, y;
+    GLsizei numVertices;
     SFG_StrokeFont* font;
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutStrokeString" );
     font = fghStrokeByID( fontID );
@@ -350,41 +1115,31 @@ void FGAPIENTRY glutStrokeString( void* fontID, const unsigned char *string )
     if ( !string || ! *string )
         return;
 
-    /*
-     * Step through the string, drawing each character.
-     * A newline will simply translate the next character's insertion
-     * point back to the start of the line and down one line.
-     */
-    while( ( c = *string++) )
-        if( c < font->Quantity )
-        {
-            if( c == '\n' )
-            {
-                glTranslatef ( -length, -( float )( font->Height ), 0.0 );
-                length = 0.0;
-            }
-            else  /* Not an EOL, draw the bitmap character */
-            {
-                const SFG_StrokeChar *schar = font->Characters[ c ];
-                if( schar )
-                {
-                    const SFG_StrokeStrip *strip = schar->Strips;
+#ifdef GL_LINE_STIPPLE
+    if( fghUseStrokeStrips( ) )
+    {
+        fghDrawStrokeStringStrips( font, string );
+        return;
+    }
+#endif
 
-                    for( i = 0; i < schar->Number; i++, strip++ )
-                    {
-                        glBegin( GL_LINE_STRIP );
-                        for( j = 0; j < strip->Number; j++ )
-                            glVertex2f( strip->Vertices[ j ].X,
-                                        strip->Vertices[ j ].Y);
+    lines = fghGetStrokeLines( font );
+    numVertices = fghStrokeStringVertices( font, lines, string );
+    if( numVertices > fghStrokeBatchSize )
+    {
+        free( fghStrokeBatch );
+        fghStrokeBatch = malloc( numVertices * 2 * sizeof( GLfloat ) );
+        if( !fghStrokeBatch )
+            fgError( "Failed to allocate memory in glutStrokeString" );
+        fghStrokeBatchSize = numVertices;
+    }
 
-                        glEnd( );
-                    }
+    fghLayoutStrokeString( font, lines, string, fghStrokeBatch, &x, &y );
+    fghDrawStrokeLines( fghStrokeBatch, numVertices, GL_FALSE );
 
-                    length += schar->Right;
-                    glTranslatef( schar->Right, 0.0, 0.0 );
-                }
-            }
-        }
+    /* Leave the origin where the last character ended, as before */
+    if( !fghIsCoreProfile( ) )
+        glTranslatef( x, y, 0.0 );
 }
 
 /*
@@ -475,4 +1230,172 @@ GLfloat FGAPIENTRY glutStrokeHeight( void* fontID )
     return font->Height;
 }
 
+/*
+ * Measures a string drawn with a bitmap or stroke font, and for stroke
+ * fonts lays it out, for drawing later. Returns the prepared string's ID,
+ * or 0 if the font isn't known.
+ */
+int FGAPIENTRY glutPrepareString( void* fontID, const unsigned char *string )
+{
+    SFG_PreparedString *prepared;
+    const unsigned char *p;
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutPrepareString" );
+
+    if( !fghFontByID( fontID ) && !fghStrokeByID( fontID ) )
+    {
+        fgWarning("glutPrepareString: font 0x%08x not found.\n",fontID);
+        return 0;
+    }
+    if( !string )
+        string = ( const unsigned char * )"";
+
+    prepared = calloc( 1, sizeof( SFG_PreparedString ) );
+    if( !prepared || !( prepared->Text = ( unsigned char * )strdup( ( const char * )string ) ) )
+        fgError( "Failed to allocate memory in glutPrepareString" );
+
+    prepared->FontID = fontID;
+    prepared->NumLines = 1;
+    for( p = string; *p; p++ )
+        if( *p == '\n' )
+            prepared->NumLines++;
+
+    prepared->StrokeFont = fghStrokeByID( fontID );
+    if( prepared->StrokeFont )
+    {
+        const SFG_StrokeLines *lines = fghGetStrokeLines( prepared->StrokeFont );
+
+        prepared->Width = glutStrokeLengthf( fontID, string );
+        prepared->NumVertices = fghStrokeStringVertices( prepared->StrokeFont, lines, string );
+        prepared->Vertices = malloc( ( prepared->NumVertices ? prepared->NumVertices : 1 ) * 2 * sizeof( GLfloat ) );
+        if( !prepared->Vertices )
+            fgError( "Failed to allocate memory in glutPrepareString" );
+        fghLayoutStrokeString( prepared->StrokeFont, lines, string, prepared->Vertices,
+                               &prepared->EndX, &prepared->EndY );
+    }
+    else
+    {
+        const SFG_Font *font = fghFontByID( fontID );
+        const SFG_FontAtlasLayout *layout = fghAtlasLayout( fghBitmapFontIndex( font ) );
+        GLfloat *v;
+        GLsizei numGlyphs = 0;
+
+        prepared->Width = ( GLfloat )glutBitmapLength( fontID, string );
+
+        /* The glyphs' triangles from the string's start, moved to the raster position when drawn */
+        for( p = string; *p; p++ )
+            if( *p != '\n' && font->Characters[ *p ][ 0 ] )
+                numGlyphs++;
+        prepared->Vertices = malloc( ( numGlyphs ? numGlyphs : 1 ) * FGH_FLOATS_PER_GLYPH * sizeof( GLfloat ) );
+        if( !prepared->Vertices )
+            fgError( "Failed to allocate memory in glutPrepareString" );
+        prepared->NumVertices = numGlyphs * 6;
+
+        v = prepared->Vertices;
+        for( p = string; *p; p++ )
+        {
+            if( *p == '\n' )
+            {
+                prepared->EndX = 0.0f;
+                prepared->EndY -= font->Height;
+                continue;
+            }
+            if( font->Characters[ *p ][ 0 ] )
+                v = fghGlyphTriangles( v, font, layout, *p, prepared->EndX, prepared->EndY, GL_FALSE );
+            prepared->EndX += font->Characters[ *p ][ 0 ];
+        }
+    }
+
+    prepared->ID = ++fghPreparedStringID;
+    fgListAppend( &fghPreparedStrings, &prepared->Node );
+    fgHashInsert( &fghPreparedStringsByID, ( size_t )prepared->ID, prepared );
+
+    return prepared->ID;
+}
+
+void FGAPIENTRY glutDestroyPreparedString( int stringID )
+{
+    SFG_PreparedString *prepared;
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutDestroyPreparedString" );
+    prepared = fghPreparedStringByID( stringID );
+    freeglut_return_if_fail( prepared );
+
+    fghDestroyPreparedString( prepared );
+}
+
+/*
+ * Draws a prepared string the way glutBitmapString or glutStrokeString
+ * would draw it. Bitmap fonts are drawn from their glyph textures, with
+ * or without GLUT_BITMAP_FONT_ATLAS, as the triangles for that are ready.
+ */
+void FGAPIENTRY glutDrawPreparedString( int stringID )
+{
+    SFG_PreparedString *prepared;
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutDrawPreparedString" );
+    prepared = fghPreparedStringByID( stringID );
+    freeglut_return_if_fail( prepared );
+
+    if( !prepared->StrokeFont )
+    {
+        int mode = fghBitmapDrawMode( GL_TRUE );
+        GLfloat origin[ 2 ];
+        GLint binding;
+
+        /* E.g. while compiling a display list */
+        if( mode == FGH_DRAW_BITMAP )
+        {
+            glutBitmapString( prepared->FontID, prepared->Text );
+            return;
+        }
+
+        if( fghBeginAtlas( mode, fghFontByID( prepared->FontID ), origin, &binding ) )
+        {
+            /* Glyph origins are whole pixels, snap the start as glBitmap would */
+            if( mode == FGH_DRAW_QUADS )
+                glTranslatef( ( GLfloat )floor( origin[ 0 ] ), ( GLfloat )floor( origin[ 1 ] ), 0.0f );
+            fghFlushGlyphs( mode, prepared->Vertices, prepared->NumVertices );
+            fghEndAtlas( mode, binding, prepared->EndX, prepared->EndY );
+        }
+        return;
+    }
+
+#ifdef GL_LINE_STIPPLE
+    if( fghUseStrokeStrips( ) )
+    {
+        fghDrawStrokeStringStrips( prepared->StrokeFont, prepared->Text );
+        return;
+    }
+#endif
+
+    fghDrawStrokeLines( prepared->Vertices, prepared->NumVertices, GL_FALSE );
+    if( !fghIsCoreProfile( ) )
+        glTranslatef( prepared->EndX, prepared->EndY, 0.0 );
+}
+
+/*
+ * Returns the width of a prepared string's longest line, as
+ * glutBitmapLength or glutStrokeLengthf would
+ */
+GLfloat FGAPIENTRY glutPreparedStringWidth( int stringID )
+{
+    SFG_PreparedString *prepared;
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutPreparedStringWidth" );
+    prepared = fghPreparedStringByID( stringID );
+    freeglut_return_val_if_fail( prepared, 0.0f );
+
+    return prepared->Width;
+}
+
+/*
+ * Returns the number of lines of a prepared string
+ */
+int FGAPIENTRY glutPreparedStringLines( int stringID )
+{
+    SFG_PreparedString *prepared;
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutPreparedStringLines" );
+    prepared = fghPreparedStringByID( stringID );
+    freeglut_return_val_if_fail( prepared, 0 );
+
+    return prepared->NumLines;
+}
+
 /*** END OF FILE ***/
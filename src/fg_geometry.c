@@ -60,15 +60,33 @@ static void fghDrawGeometrySolid11(GLfloat *vertices, GLfloat *normals, GLfloat
 static void fghDrawGeometryWire20(GLfloat *vertices, GLfloat *normals, GLsizei numVertices,
                                   GLushort *vertIdxs, GLsizei numParts, GLsizei numVertPerPart, GLenum vertexMode,
                                   GLushort *vertIdxs2, GLsizei numParts2, GLsizei numVertPerPart2,
+                                  const SFG_GeometryKey *key,
                                   GLint attribute_v_coord, GLint attribute_v_normal);
 static void fghDrawGeometrySolid20(GLfloat *vertices, GLfloat *normals, GLfloat *textcs, GLsizei numVertices,
                                    GLushort *vertIdxs, GLsizei numParts, GLsizei numVertIdxsPerPart,
+                                   const SFG_GeometryKey *key,
                                    GLint attribute_v_coord, GLint attribute_v_normal, GLint attribute_v_texture);
 /* declare function for generating visualization of normals */
 static void fghGenerateNormalVisualization(GLfloat *vertices, GLfloat *normals, GLsizei numVertices);
 static void fghDrawNormalVisualization11(void);
 static void fghDrawNormalVisualization20(GLint attribute_v_coord);
 
+/*
+ * Instanced drawing: while glutSolidShapeInstanced or glutWireShapeInstanced
+ * draws a shape, numInstances is set and the functions below draw it once per
+ * transform in instanceData. For OpenGL (ES) >= 2.0 the transform is passed
+ * to the shader in the attribute set with glutSetVertexAttribInstance, for
+ * older versions it is multiplied onto the modelview matrix.
+ */
+static GLenum         instanceFormat = GLUT_INSTANCE_OFFSET_SCALE;
+static GLsizei        numInstances   = 0;
+static const GLfloat *instanceData   = NULL;
+/* Triangles (or lines) of the last round shape drawn, for glutSolidShapeLOD */
+static GLsizei        numPrimitivesDrawn = 0;
+/* Number of vec4s per instance */
+#define FGH_INSTANCE_VEC4S (instanceFormat == GLUT_INSTANCE_MATRIX ? 4 : 1)
+static void fghMultInstanceMatrix11(int instance);
+
 /* Drawing geometry:
  * Explanation of the functions has to be separate for the polyhedra and
  * the non-polyhedra (objects with a circular cross-section).
@@ -132,12 +150,16 @@ static void fghDrawNormalVisualization20(GLint attribute_v_coord);
  * GLushort *vertIdxs2, GLsizei numParts2, GLsizei numVertPerPart2
  *   non-polyhedra only: same as the above, but now for subdivisions along
  *   the other axis. Always drawn as GL_LINE_LOOP.
+ * const SFG_GeometryKey *key
+ *   identifies the shape for the geometry buffer cache, optional (the
+ *   buffers are not cached if NULL)
  *
  * Feel free to contribute better naming ;)
  */
 void fghDrawGeometryWire(GLfloat *vertices, GLfloat *normals, GLsizei numVertices,
                                 GLushort *vertIdxs, GLsizei numParts, GLsizei numVertPerPart, GLenum vertexMode,
-                                GLushort *vertIdxs2, GLsizei numParts2, GLsizei numVertPerPart2
+                                GLushort *vertIdxs2, GLsizei numParts2, GLsizei numVertPerPart2,
+                                const SFG_GeometryKey *key
     )
 {
     SFG_Window *win = fgStructure.CurrentWindow;
@@ -150,7 +172,20 @@ void fghDrawGeometryWire(GLfloat *vertices, GLfloat *normals, GLsizei numVertice
         fghDrawGeometryWire20(vertices, normals, numVertices,
                               vertIdxs, numParts, numVertPerPart, vertexMode,
                               vertIdxs2, numParts2, numVertPerPart2,
-                              attribute_v_coord, attribute_v_normal);
+                              key, attribute_v_coord, attribute_v_normal);
+    else if (numInstances > 0)
+    {
+        int i;
+        for (i=0; i<numInstances; i++)
+        {
+            glPushMatrix();
+            fghMultInstanceMatrix11(i);
+            fghDrawGeometryWire11(vertices, normals,
+                                  vertIdxs, numParts, numVertPerPart, vertexMode,
+                                  vertIdxs2, numParts2, numVertPerPart2);
+            glPopMatrix();
+        }
+    }
     else
         fghDrawGeometryWire11(vertices, normals,
                               vertIdxs, numParts, numVertPerPart, vertexMode,
@@ -182,12 +217,17 @@ void fghDrawGeometryWire(GLfloat *vertices, GLfloat *normals, GLsizei numVertice
        processed at each draw call.
  *   numParts * numVertPerPart gives the number of entries in the vertex
  *     array vertIdxs
+ * const SFG_GeometryKey *key
+ *   identifies the shape for the geometry buffer cache, optional (the
+ *   buffers are not cached if NULL)
  */
 void fghDrawGeometrySolid(GLfloat *vertices, GLfloat *normals, GLfloat *textcs, GLsizei numVertices,
-                          GLushort *vertIdxs, GLsizei numParts, GLsizei numVertIdxsPerPart)
+                          GLushort *vertIdxs, GLsizei numParts, GLsizei numVertIdxsPerPart,
+                          const SFG_GeometryKey *key)
 {
     GLint attribute_v_coord, attribute_v_normal, attribute_v_texture;
     SFG_Window *win = fgStructure.CurrentWindow;
+    GLboolean visualizeNormals = win && win->State.VisualizeNormals && numInstances == 0;
     if(win) {
         attribute_v_coord   = win->Window.attribute_v_coord;
         attribute_v_normal  = win->Window.attribute_v_normal;
@@ -196,7 +236,7 @@ void fghDrawGeometrySolid(GLfloat *vertices, GLfloat *normals, GLfloat *textcs,
         attribute_v_coord = attribute_v_normal = attribute_v_texture = -1;
     }
 
-    if (win && win->State.VisualizeNormals)
+    if (visualizeNormals)
         /* generate normals for each vertex to be drawn as well */
         fghGenerateNormalVisualization(vertices, normals, numVertices);
 
@@ -205,18 +245,30 @@ void fghDrawGeometrySolid(GLfloat *vertices, GLfloat *normals, GLfloat *textcs,
         /* User requested a 2.0 draw */
         fghDrawGeometrySolid20(vertices, normals, textcs, numVertices,
                                vertIdxs, numParts, numVertIdxsPerPart,
-                               attribute_v_coord, attribute_v_normal, attribute_v_texture);
+                               key, attribute_v_coord, attribute_v_normal, attribute_v_texture);
 
-        if (win && win->State.VisualizeNormals)
+        if (visualizeNormals)
             /* draw normals for each vertex as well */
             fghDrawNormalVisualization20(attribute_v_coord);
     }
+    else if (numInstances > 0)
+    {
+        int i;
+        for (i=0; i<numInstances; i++)
+        {
+            glPushMatrix();
+            fghMultInstanceMatrix11(i);
+            fghDrawGeometrySolid11(vertices, normals, textcs, numVertices,
+                                   vertIdxs, numParts, numVertIdxsPerPart);
+            glPopMatrix();
+        }
+    }
     else
     {
         fghDrawGeometrySolid11(vertices, normals, textcs, numVertices,
                                vertIdxs, numParts, numVertIdxsPerPart);
 
-        if (win && win->State.VisualizeNormals)
+        if (visualizeNormals)
             /* draw normals for each vertex as well */
             fghDrawNormalVisualization11();
     }
@@ -325,6 +377,69 @@ static void fghDrawGeometrySolid10(GLfloat *varr, GLfloat *narr, GLfloat *tarr,
 }
 #endif
 
+/* Apply the transform of an instance to the modelview matrix */
+static void fghMultInstanceMatrix11(int instance)
+{
+    const GLfloat *data = instanceData + instance * FGH_INSTANCE_VEC4S * 4;
+
+    if (instanceFormat == GLUT_INSTANCE_MATRIX)
+        glMultMatrixf(data);
+    else
+    {
+        glTranslatef(data[0], data[1], data[2]);
+        glScalef(data[3], data[3], data[3]);
+    }
+}
+
+#if defined(GL_VERSION_1_1) || defined(GL_VERSION_ES_CM_1_0)
+/* Max. number of parts submitted per glMultiDraw* call */
+#define FGH_MULTI_DRAW_PARTS 256
+
+/*
+ * Draw numParts parts of numVertPerPart vertices each, stored one after
+ * the other in the vertex arrays, or if indexed, in the vertex index array
+ * vertIdxs (an offset when an element array buffer is bound). Submits all
+ * parts with glMultiDrawArrays/Elements if available.
+ */
+static void fghDrawParts(GLenum vertexMode, GLboolean indexed, const GLushort *vertIdxs,
+                         GLsizei numParts, GLsizei numVertPerPart)
+{
+    int i, j;
+
+    if (fgState.HasMultiDraw && numParts > 1)
+    {
+        GLint         firsts [FGH_MULTI_DRAW_PARTS];
+        GLsizei       counts [FGH_MULTI_DRAW_PARTS];
+        const GLvoid *indices[FGH_MULTI_DRAW_PARTS];
+
+        for (i=0; i<numParts; i+=FGH_MULTI_DRAW_PARTS)
+        {
+            GLsizei numDraws = numParts-i < FGH_MULTI_DRAW_PARTS ? numParts-i : FGH_MULTI_DRAW_PARTS;
+
+            for (j=0; j<numDraws; j++)
+            {
+                firsts[j]  = (i+j)*numVertPerPart;
+                counts[j]  = numVertPerPart;
+                indices[j] = vertIdxs + (i+j)*numVertPerPart;
+            }
+
+            if (indexed)
+                fghMultiDrawElements(vertexMode, counts, GL_UNSIGNED_SHORT, indices, numDraws);
+            else
+                fghMultiDrawArrays(vertexMode, firsts, counts, numDraws);
+        }
+    }
+    else
+    {
+        for (i=0; i<numParts; i++)
+            if (indexed)
+                glDrawElements(vertexMode, numVertPerPart, GL_UNSIGNED_SHORT, vertIdxs+i*numVertPerPart);
+            else
+                glDrawArrays(vertexMode, i*numVertPerPart, numVertPerPart);
+    }
+}
+#endif
+
 /* Version for OpenGL (ES) 1.1 */
 static void fghDrawGeometryWire11(GLfloat *vertices, GLfloat *normals,
                                   GLushort *vertIdxs, GLsizei numParts, GLsizei numVertPerPart, GLenum vertexMode,
@@ -332,8 +447,6 @@ static void fghDrawGeometryWire11(GLfloat *vertices, GLfloat *normals,
     )
 {
 #if defined(GL_VERSION_1_1) || defined(GL_VERSION_ES_CM_1_0)
-    int i;
-
     glEnableClientState(GL_VERTEX_ARRAY);
     glEnableClientState(GL_NORMAL_ARRAY);
 
@@ -341,17 +454,11 @@ static void fghDrawGeometryWire11(GLfloat *vertices, GLfloat *normals,
     glNormalPointer(GL_FLOAT, 0, normals);
 
 
-    if (!vertIdxs)
-        /* Draw per face (TODO: could use glMultiDrawArrays if available) */
-        for (i=0; i<numParts; i++)
-            glDrawArrays(vertexMode, i*numVertPerPart, numVertPerPart);
-    else
-        for (i=0; i<numParts; i++)
-            glDrawElements(vertexMode,numVertPerPart,GL_UNSIGNED_SHORT,vertIdxs+i*numVertPerPart);
+    /* Draw per face (polyhedra) or per subdivision */
+    fghDrawParts(vertexMode, vertIdxs != NULL, vertIdxs, numParts, numVertPerPart);
 
     if (vertIdxs2)
-        for (i=0; i<numParts2; i++)
-            glDrawElements(GL_LINE_LOOP,numVertPerPart2,GL_UNSIGNED_SHORT,vertIdxs2+i*numVertPerPart2);
+        fghDrawParts(GL_LINE_LOOP, GL_TRUE, vertIdxs2, numParts2, numVertPerPart2);
 
     glDisableClientState(GL_VERTEX_ARRAY);
     glDisableClientState(GL_NORMAL_ARRAY);
@@ -366,8 +473,6 @@ static void fghDrawGeometrySolid11(GLfloat *vertices, GLfloat *normals, GLfloat
                                    GLushort *vertIdxs, GLsizei numParts, GLsizei numVertIdxsPerPart)
 {
 #if defined(GL_VERSION_1_1) || defined(GL_VERSION_ES_CM_1_0)
-    int i;
-
     glEnableClientState(GL_VERTEX_ARRAY);
     glEnableClientState(GL_NORMAL_ARRAY);
 
@@ -384,8 +489,7 @@ static void fghDrawGeometrySolid11(GLfloat *vertices, GLfloat *normals, GLfloat
         glDrawArrays(GL_TRIANGLES, 0, numVertices);
     else
         if (numParts>1)
-            for (i=0; i<numParts; i++)
-                glDrawElements(GL_TRIANGLE_STRIP, numVertIdxsPerPart, GL_UNSIGNED_SHORT, vertIdxs+i*numVertIdxsPerPart);
+            fghDrawParts(GL_TRIANGLE_STRIP, GL_TRUE, vertIdxs, numParts, numVertIdxsPerPart);
         else
             glDrawElements(GL_TRIANGLES, numVertIdxsPerPart, GL_UNSIGNED_SHORT, vertIdxs);
 
@@ -398,235 +502,676 @@ static void fghDrawGeometrySolid11(GLfloat *vertices, GLfloat *normals, GLfloat
 #endif
 }
 
-/* Version for OpenGL (ES) >= 2.0 */
-static void fghDrawGeometryWire20(GLfloat *vertices, GLfloat *normals, GLsizei numVertices,
-                                  GLushort *vertIdxs, GLsizei numParts, GLsizei numVertPerPart, GLenum vertexMode,
-                                  GLushort *vertIdxs2, GLsizei numParts2, GLsizei numVertPerPart2,
-                                  GLint attribute_v_coord, GLint attribute_v_normal)
+/* -- GEOMETRY BUFFER CACHE ------------------------------------------------ */
+/*
+ * Drawing through the OpenGL (ES) >= 2.0 vertex attribute path requires
+ * the geometry to be uploaded into buffer objects. Instead of creating and
+ * deleting them at every draw, the buffers of the shapes that identify
+ * themselves with a SFG_GeometryKey are kept in a per window (and thus per
+ * context) list, most recently used first, so that drawing the same shape
+ * again only requires binding them. The list holds at most
+ * GLUT_GEOMETRY_BUFFER_CACHE_SIZE entries (set with glutSetOption, 0
+ * disables the cache), is emptied by glutFlushGeometryCache and freed when
+ * the window is destroyed.
+ */
+void fghInitGeometryKey(SFG_GeometryKey *key, int shape, GLboolean useWireMode,
+                        GLint slices, GLint stacks,
+                        GLfloat param0, GLfloat param1, GLfloat param2, GLfloat param3)
+{
+    key->Shape     = shape;
+    key->WireMode  = useWireMode;
+    key->Slices    = slices;
+    key->Stacks    = stacks;
+    key->Params[0] = param0;
+    key->Params[1] = param1;
+    key->Params[2] = param2;
+    key->Params[3] = param3;
+    key->VertexFormat = 0;
+}
+
+static GLboolean fghGeometryKeyEqual(const SFG_GeometryKey *a, const SFG_GeometryKey *b)
+{
+    return a->Shape     == b->Shape     &&
+           a->WireMode  == b->WireMode  &&
+           a->Slices    == b->Slices    &&
+           a->Stacks    == b->Stacks    &&
+           a->Params[0] == b->Params[0] &&
+           a->Params[1] == b->Params[1] &&
+           a->Params[2] == b->Params[2] &&
+           a->Params[3] == b->Params[3] &&
+           a->VertexFormat == b->VertexFormat;
+}
+
+static GLboolean fghSameVertex(const GLfloat *vertices, GLushort a, GLushort b)
 {
+    return a == b ||
+           (vertices[a*3  ] == vertices[b*3  ] &&
+            vertices[a*3+1] == vertices[b*3+1] &&
+            vertices[a*3+2] == vertices[b*3+2]);
+}
+
+/*
+ * Count the triangles of a solid shape, or the line segments of a wire
+ * one, as kept with its mesh and buffers. Triangles with two corners in
+ * the same place, which the strips make at the poles of spheres and the
+ * tips of cones, are left out.
+ */
+static GLsizei fghCountPrimitives(const GLfloat *vertices, GLenum vertexMode, const GLushort *vertIdxs,
+                                  GLsizei numParts, GLsizei numVertPerPart,
+                                  GLsizei numParts2, GLsizei numVertPerPart2)
+{
+    GLsizei count = 0;
+    int i, j;
+
+    switch (vertexMode)
+    {
+    case GL_TRIANGLES:
+    case GL_TRIANGLE_STRIP:
+        if (!vertIdxs)
+            /* Separate triangles, the polyhedra */
+            return numParts*numVertPerPart/3;
+
+        for (i=0; i<numParts; i++)
+        {
+            const GLushort *idx = vertIdxs + i*numVertPerPart;
+            for (j=0; j+2<numVertPerPart; j+=(vertexMode == GL_TRIANGLES ? 3 : 1))
+                if (!fghSameVertex(vertices, idx[j  ], idx[j+1]) &&
+                    !fghSameVertex(vertices, idx[j+1], idx[j+2]) &&
+                    !fghSameVertex(vertices, idx[j  ], idx[j+2]))
+                    count++;
+        }
+        return count;
+    case GL_LINES:
+        count = numParts*(numVertPerPart/2);
+        break;
+    case GL_LINE_STRIP:
+        count = numParts*(numVertPerPart-1);
+        break;
+    default:
+        /* GL_LINE_LOOP */
+        count = numParts*numVertPerPart;
+        break;
+    }
+
+    /* The second parts are always GL_LINE_LOOPs */
+    return count + numParts2*numVertPerPart2;
+}
+
 #if defined(GL_VERSION_1_1) || defined(GL_VERSION_ES_CM_1_0)
-    GLuint vbo_coords = 0, vbo_normals = 0,
-        ibo_elements = 0, ibo_elements2 = 0;
-    GLsizei numVertIdxs = numParts * numVertPerPart;
-    GLsizei numVertIdxs2 = numParts2 * numVertPerPart2;
+/* Number of indices of numParts parts joined by restart indices */
+#define FGH_JOINED_PARTS_SIZE(numParts,numVertPerPart) ((numParts)*((numVertPerPart)+1)-1)
+
+/*
+ * Copy the parts of a vertex index array into a new array, separated by
+ * restart indices, so that they can be drawn with one call
+ */
+static GLushort *fghJoinParts(const GLushort *vertIdxs, GLsizei numParts, GLsizei numVertPerPart)
+{
+    GLushort *joined = malloc(FGH_JOINED_PARTS_SIZE(numParts, numVertPerPart) * sizeof(GLushort));
     int i;
 
-    if (numVertices > 0 && attribute_v_coord != -1) {
-        fghGenBuffers(1, &vbo_coords);
-        fghBindBuffer(FGH_ARRAY_BUFFER, vbo_coords);
+    if (!joined)
+        return NULL;
+
+    for (i=0; i<numParts; i++)
+    {
+        memcpy(joined + i*(numVertPerPart+1), vertIdxs + i*numVertPerPart, numVertPerPart * sizeof(GLushort));
+        if (i < numParts-1)
+            joined[i*(numVertPerPart+1) + numVertPerPart] = FGH_PRIMITIVE_RESTART_INDEX;
+    }
+    return joined;
+}
+
+/*
+ * Vertex of the GLUT_VERTEX_FORMAT_PACKED layout: 24 bytes instead of the
+ * 32 of the separate float arrays, in a single buffer. Normals are stored as
+ * normalized shorts (the fourth only pads to 4 byte alignment), texture
+ * coordinates, which are in [0,1] for all shapes, as normalized unsigned
+ * shorts.
+ */
+typedef struct
+{
+    GLfloat  Coord[3];
+    GLshort  Normal[4];
+    GLushort Texc[2];
+} SFG_PackedVertex;
+
+static GLshort fghPackSnorm16(GLfloat value)
+{
+    if (value >  1.f) value =  1.f;
+    if (value < -1.f) value = -1.f;
+    return (GLshort)(value * 32767.f + (value < 0.f ? -.5f : .5f));
+}
+
+static GLushort fghPackUnorm16(GLfloat value)
+{
+    if (value > 1.f) value = 1.f;
+    if (value < 0.f) value = 0.f;
+    return (GLushort)(value * 65535.f + .5f);
+}
+
+/*
+ * Interleave the arrays that are passed (not NULL) into one buffer object,
+ * which becomes the VBO of each of them. Returns GL_FALSE if out of memory.
+ */
+static GLboolean fghGenPackedVertexBuffer(SFG_GeometryBuffers *buffers,
+                                          GLfloat *vertices, GLfloat *normals, GLfloat *textcs)
+{
+    GLsizei numVertices = buffers->NumVertices;
+    SFG_PackedVertex *packed = calloc(numVertices, sizeof(SFG_PackedVertex));
+    GLuint vbo;
+    int i;
+
+    if (!packed)
+        return GL_FALSE;
+
+    for (i=0; i<numVertices; i++)
+    {
+        if (vertices)
+        {
+            packed[i].Coord[0] = vertices[i*3+0];
+            packed[i].Coord[1] = vertices[i*3+1];
+            packed[i].Coord[2] = vertices[i*3+2];
+        }
+        if (normals)
+        {
+            packed[i].Normal[0] = fghPackSnorm16(normals[i*3+0]);
+            packed[i].Normal[1] = fghPackSnorm16(normals[i*3+1]);
+            packed[i].Normal[2] = fghPackSnorm16(normals[i*3+2]);
+        }
+        if (textcs)
+        {
+            packed[i].Texc[0] = fghPackUnorm16(textcs[i*2+0]);
+            packed[i].Texc[1] = fghPackUnorm16(textcs[i*2+1]);
+        }
+    }
+
+    fghGenBuffers(1, &vbo);
+    fghBindBuffer(FGH_ARRAY_BUFFER, vbo);
+    fghBufferData(FGH_ARRAY_BUFFER, numVertices * sizeof(SFG_PackedVertex),
+                  packed, FGH_STATIC_DRAW);
+    fghBindBuffer(FGH_ARRAY_BUFFER, 0);
+    free(packed);
+
+    buffers->VertexFormat = GLUT_VERTEX_FORMAT_PACKED;
+    buffers->VboCoords    = vertices ? vbo : 0;
+    buffers->VboNormals   = normals  ? vbo : 0;
+    buffers->VboTexcs     = textcs   ? vbo : 0;
+    return GL_TRUE;
+}
+
+static void fghGenIndexBuffer(GLuint *ibo, const GLushort *vertIdxs, GLsizei numVertIdxs)
+{
+    fghGenBuffers(1, ibo);
+    fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, *ibo);
+    fghBufferData(FGH_ELEMENT_ARRAY_BUFFER, numVertIdxs * sizeof(vertIdxs[0]),
+                  vertIdxs, FGH_STATIC_DRAW);
+    fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+/*
+ * Upload the arrays that are passed (not NULL) into new buffer objects.
+ * If primitive restart is available, the parts of the vertex index arrays
+ * are joined so that they can be drawn with one call each.
+ */
+static void fghGenGeometryBuffers(SFG_GeometryBuffers *buffers,
+                                  GLfloat *vertices, GLfloat *normals, GLfloat *textcs,
+                                  GLushort *vertIdxs, GLushort *vertIdxs2)
+{
+    GLsizei numVertices  = buffers->NumVertices;
+    GLsizei numVertIdxs  = buffers->NumParts  * buffers->NumVertPerPart;
+    GLsizei numVertIdxs2 = buffers->NumParts2 * buffers->NumVertPerPart2;
+    GLushort *joined = NULL, *joined2 = NULL;
+
+    buffers->PrimitiveRestart = 0;
+    if (fgState.PrimitiveRestart &&
+        ((vertIdxs && buffers->NumParts > 1) || (vertIdxs2 && buffers->NumParts2 > 1)))
+    {
+        if (vertIdxs)
+            joined  = fghJoinParts(vertIdxs,  buffers->NumParts,  buffers->NumVertPerPart);
+        if (vertIdxs2)
+            joined2 = fghJoinParts(vertIdxs2, buffers->NumParts2, buffers->NumVertPerPart2);
+
+        if ((!vertIdxs || joined) && (!vertIdxs2 || joined2))
+        {
+            buffers->PrimitiveRestart = fgState.PrimitiveRestart;
+            if (vertIdxs)
+            {
+                vertIdxs    = joined;
+                numVertIdxs = FGH_JOINED_PARTS_SIZE(buffers->NumParts, buffers->NumVertPerPart);
+            }
+            if (vertIdxs2)
+            {
+                vertIdxs2    = joined2;
+                numVertIdxs2 = FGH_JOINED_PARTS_SIZE(buffers->NumParts2, buffers->NumVertPerPart2);
+            }
+        }
+    }
+
+    buffers->VertexFormat = GLUT_VERTEX_FORMAT_FLOAT;
+    if (fgState.GeometryVertexFormat == GLUT_VERTEX_FORMAT_PACKED &&
+        numVertices > 0 && (vertices || normals || textcs) &&
+        fghGenPackedVertexBuffer(buffers, vertices, normals, textcs))
+        /* Done with the vertex arrays */
+        vertices = normals = textcs = NULL;
+
+    if (numVertices > 0 && vertices) {
+        fghGenBuffers(1, &buffers->VboCoords);
+        fghBindBuffer(FGH_ARRAY_BUFFER, buffers->VboCoords);
         fghBufferData(FGH_ARRAY_BUFFER, numVertices * 3 * sizeof(vertices[0]),
                       vertices, FGH_STATIC_DRAW);
+        fghBindBuffer(FGH_ARRAY_BUFFER, 0);
     }
 
-    if (numVertices > 0 && attribute_v_normal != -1) {
-        fghGenBuffers(1, &vbo_normals);
-        fghBindBuffer(FGH_ARRAY_BUFFER, vbo_normals);
+    if (numVertices > 0 && normals) {
+        fghGenBuffers(1, &buffers->VboNormals);
+        fghBindBuffer(FGH_ARRAY_BUFFER, buffers->VboNormals);
         fghBufferData(FGH_ARRAY_BUFFER, numVertices * 3 * sizeof(normals[0]),
                       normals, FGH_STATIC_DRAW);
+        fghBindBuffer(FGH_ARRAY_BUFFER, 0);
     }
 
-    if (vertIdxs != NULL) {
-        fghGenBuffers(1, &ibo_elements);
-        fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, ibo_elements);
-        fghBufferData(FGH_ELEMENT_ARRAY_BUFFER, numVertIdxs * sizeof(vertIdxs[0]),
-                      vertIdxs, FGH_STATIC_DRAW);
-        fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, 0);
+    if (numVertices > 0 && textcs) {
+        fghGenBuffers(1, &buffers->VboTexcs);
+        fghBindBuffer(FGH_ARRAY_BUFFER, buffers->VboTexcs);
+        fghBufferData(FGH_ARRAY_BUFFER, numVertices * 2 * sizeof(textcs[0]),
+                      textcs, FGH_STATIC_DRAW);
+        fghBindBuffer(FGH_ARRAY_BUFFER, 0);
     }
 
-    if (vertIdxs2 != NULL) {
-        fghGenBuffers(1, &ibo_elements2);
-        fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, ibo_elements2);
-        fghBufferData(FGH_ELEMENT_ARRAY_BUFFER, numVertIdxs2 * sizeof(vertIdxs2[0]),
-                      vertIdxs2, FGH_STATIC_DRAW);
-        fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, 0);
-    }
+    if (vertIdxs != NULL)
+        fghGenIndexBuffer(&buffers->IboElements, vertIdxs, numVertIdxs);
+    if (vertIdxs2 != NULL)
+        fghGenIndexBuffer(&buffers->IboElements2, vertIdxs2, numVertIdxs2);
 
-    if (vbo_coords) {
-        fghEnableVertexAttribArray(attribute_v_coord);
-        fghBindBuffer(FGH_ARRAY_BUFFER, vbo_coords);
-        fghVertexAttribPointer(
-            attribute_v_coord,  /* attribute */
-            3,                  /* number of elements per vertex, here (x,y,z) */
-            GL_FLOAT,           /* the type of each element */
-            GL_FALSE,           /* take our values as-is */
-            0,                  /* no extra data between each position */
-            0                   /* offset of first element */
-        );
-        fghBindBuffer(FGH_ARRAY_BUFFER, 0);
+    free(joined);
+    free(joined2);
+}
+
+static void fghDeleteGeometryBuffers(SFG_GeometryBuffers *buffers)
+{
+    if (buffers->VertexFormat == GLUT_VERTEX_FORMAT_PACKED)
+    {
+        /* One buffer, shared by the attributes that are present */
+        GLuint vbo = buffers->VboCoords ? buffers->VboCoords :
+                     buffers->VboNormals ? buffers->VboNormals : buffers->VboTexcs;
+        if (vbo != 0)
+            fghDeleteBuffers(1, &vbo);
+        buffers->VboCoords = buffers->VboNormals = buffers->VboTexcs = 0;
     }
+    if (buffers->VboCoords != 0)
+        fghDeleteBuffers(1, &buffers->VboCoords);
+    if (buffers->VboNormals != 0)
+        fghDeleteBuffers(1, &buffers->VboNormals);
+    if (buffers->VboTexcs != 0)
+        fghDeleteBuffers(1, &buffers->VboTexcs);
+    if (buffers->IboElements != 0)
+        fghDeleteBuffers(1, &buffers->IboElements);
+    if (buffers->IboElements2 != 0)
+        fghDeleteBuffers(1, &buffers->IboElements2);
+}
 
-    if (vbo_normals) {
-        fghEnableVertexAttribArray(attribute_v_normal);
-        fghBindBuffer(FGH_ARRAY_BUFFER, vbo_normals);
-        fghVertexAttribPointer(
-            attribute_v_normal, /* attribute */
-            3,                  /* number of elements per vertex, here (x,y,z) */
-            GL_FLOAT,           /* the type of each element */
-            GL_FALSE,           /* take our values as-is */
-            0,                  /* no extra data between each position */
-            0                   /* offset of first element */
+static void fghEnableGeometryAttrib(GLint attribute, GLuint vbo, GLint size,
+                                    GLenum type, GLsizei stride, size_t offset)
+{
+    fghEnableVertexAttribArray(attribute);
+    fghBindBuffer(FGH_ARRAY_BUFFER, vbo);
+    fghVertexAttribPointer(
+        attribute,          /* attribute */
+        size,               /* number of elements per vertex, (x,y,z) or (s,t) */
+        type,               /* the type of each element */
+        type != GL_FLOAT,   /* take floats as-is, map packed values to [-1,1] or [0,1] */
+        stride,             /* 0: no extra data between each position */
+        (GLvoid*)offset     /* offset of first element */
         );
-        fghBindBuffer(FGH_ARRAY_BUFFER, 0);
+    fghBindBuffer(FGH_ARRAY_BUFFER, 0);
+}
+
+/*
+ * Draw the parts in the bound element array buffer. When they are joined
+ * by restart indices this is a single draw call, otherwise one per part or
+ * one glMultiDrawElements. If instances is non-zero, use the instanced
+ * draw calls.
+ */
+static void fghDrawElementParts(GLenum vertexMode, GLsizei numParts, GLsizei numVertPerPart,
+                                GLenum primitiveRestart, GLsizei instances)
+{
+    int i;
+
+    if (primitiveRestart)
+    {
+        numVertPerPart = FGH_JOINED_PARTS_SIZE(numParts, numVertPerPart);
+        numParts       = 1;
     }
 
-    if (!vertIdxs) {
-        /* Draw per face (TODO: could use glMultiDrawArrays if available) */
+    if (instances)
         for (i=0; i<numParts; i++)
-            glDrawArrays(vertexMode, i*numVertPerPart, numVertPerPart);
+            fghDrawElementsInstanced(vertexMode, numVertPerPart,
+                                     GL_UNSIGNED_SHORT, (GLvoid*)(sizeof(GLushort)*i*numVertPerPart), instances);
+    else
+        fghDrawParts(vertexMode, GL_TRUE, NULL, numParts, numVertPerPart);
+}
+
+/*
+ * Issue the draw calls for the buffer objects, the attributes are already
+ * set up. If instances is non-zero, use the instanced draw calls.
+ */
+static void fghDrawGeometryParts(SFG_GeometryBuffers *buffers, GLsizei instances)
+{
+    GLsizei numVertPerPart = buffers->NumVertPerPart;
+    int i;
+
+    if (buffers->PrimitiveRestart)
+    {
+        if (buffers->PrimitiveRestart == FGH_PRIMITIVE_RESTART)
+            fghPrimitiveRestartIndex(FGH_PRIMITIVE_RESTART_INDEX);
+        glEnable(buffers->PrimitiveRestart);
+    }
+
+    if (!buffers->IboElements) {
+        /* Draw per face */
+        if (instances)
+            for (i=0; i<buffers->NumParts; i++)
+                fghDrawArraysInstanced(buffers->VertexMode, i*numVertPerPart, numVertPerPart, instances);
+        else
+            fghDrawParts(buffers->VertexMode, GL_FALSE, NULL, buffers->NumParts, numVertPerPart);
     } else {
-        fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, ibo_elements);
-        for (i=0; i<numParts; i++)
-            glDrawElements(vertexMode, numVertPerPart,
-                           GL_UNSIGNED_SHORT, (GLvoid*)(sizeof(vertIdxs[0])*i*numVertPerPart));
+        fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, buffers->IboElements);
+        fghDrawElementParts(buffers->VertexMode, buffers->NumParts, numVertPerPart,
+                            buffers->PrimitiveRestart, instances);
         /* Clean existing bindings before clean-up */
         /* Android showed instability otherwise */
         fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, 0);
     }
 
-    if (vertIdxs2) {
-        fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, ibo_elements2);
-        for (i=0; i<numParts2; i++)
-            glDrawElements(GL_LINE_LOOP, numVertPerPart2,
-                           GL_UNSIGNED_SHORT, (GLvoid*)(sizeof(vertIdxs2[0])*i*numVertPerPart2));
-        /* Clean existing bindings before clean-up */
-        /* Android showed instability otherwise */
+    if (buffers->IboElements2) {
+        fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, buffers->IboElements2);
+        fghDrawElementParts(GL_LINE_LOOP, buffers->NumParts2, buffers->NumVertPerPart2,
+                            buffers->PrimitiveRestart, instances);
         fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, 0);
     }
 
-    if (vbo_coords != 0)
+    if (buffers->PrimitiveRestart)
+        glDisable(buffers->PrimitiveRestart);
+}
+
+/*
+ * Draw the buffer objects once per instance. With instanced arrays the
+ * instance data is streamed into the window's instance buffer and drawn
+ * with one call per part, otherwise the instance attribute is set to a
+ * constant value before drawing each instance.
+ */
+static void fghDrawGeometryInstances(SFG_GeometryBuffers *buffers)
+{
+    SFG_Window *win = fgStructure.CurrentWindow;
+    GLint attribute_v_instance = win->Window.attribute_v_instance;
+    GLint numVec4s = FGH_INSTANCE_VEC4S;
+    int i, j;
+
+    if (attribute_v_instance == -1)
+    {
+        fgWarning("instanced shape drawn without an instance attribute, see glutSetVertexAttribInstance");
+        return;
+    }
+
+    if (fgState.HasInstancedArrays)
+    {
+        if (!win->Window.InstanceBuffer)
+            fghGenBuffers(1, &win->Window.InstanceBuffer);
+        fghBindBuffer(FGH_ARRAY_BUFFER, win->Window.InstanceBuffer);
+        fghBufferData(FGH_ARRAY_BUFFER, numInstances * numVec4s * 4 * sizeof(GLfloat),
+                      instanceData, FGH_STREAM_DRAW);
+        for (j=0; j<numVec4s; j++)
+        {
+            fghEnableVertexAttribArray(attribute_v_instance + j);
+            fghVertexAttribPointer(attribute_v_instance + j, 4, GL_FLOAT, GL_FALSE,
+                                   numVec4s * 4 * sizeof(GLfloat),
+                                   (GLvoid*)(j * 4 * sizeof(GLfloat)));
+            fghVertexAttribDivisor(attribute_v_instance + j, 1);
+        }
+        fghBindBuffer(FGH_ARRAY_BUFFER, 0);
+
+        fghDrawGeometryParts(buffers, numInstances);
+
+        for (j=0; j<numVec4s; j++)
+        {
+            fghVertexAttribDivisor(attribute_v_instance + j, 0);
+            fghDisableVertexAttribArray(attribute_v_instance + j);
+        }
+    }
+    else
+    {
+        for (i=0; i<numInstances; i++)
+        {
+            for (j=0; j<numVec4s; j++)
+                fghVertexAttrib4fv(attribute_v_instance + j, instanceData + (i * numVec4s + j) * 4);
+            fghDrawGeometryParts(buffers, 0);
+        }
+    }
+}
+
+/* Bind the buffer objects to the attributes that are in use and draw */
+static void fghDrawGeometryBuffers(SFG_GeometryBuffers *buffers,
+                                   GLint attribute_v_coord, GLint attribute_v_normal, GLint attribute_v_texture)
+{
+    GLboolean useCoords  = buffers->VboCoords  != 0 && attribute_v_coord   != -1;
+    GLboolean useNormals = buffers->VboNormals != 0 && attribute_v_normal  != -1;
+    GLboolean useTextcs  = buffers->VboTexcs   != 0 && attribute_v_texture != -1;
+    GLboolean packed     = buffers->VertexFormat == GLUT_VERTEX_FORMAT_PACKED;
+
+    if (useCoords)
+        fghEnableGeometryAttrib(attribute_v_coord, buffers->VboCoords, 3, GL_FLOAT,
+                                packed ? sizeof(SFG_PackedVertex) : 0,
+                                packed ? offsetof(SFG_PackedVertex, Coord) : 0);
+    if (useNormals)
+        fghEnableGeometryAttrib(attribute_v_normal, buffers->VboNormals, 3,
+                                packed ? GL_SHORT : GL_FLOAT,
+                                packed ? sizeof(SFG_PackedVertex) : 0,
+                                packed ? offsetof(SFG_PackedVertex, Normal) : 0);
+    if (useTextcs)
+        fghEnableGeometryAttrib(attribute_v_texture, buffers->VboTexcs, 2,
+                                packed ? GL_UNSIGNED_SHORT : GL_FLOAT,
+                                packed ? sizeof(SFG_PackedVertex) : 0,
+                                packed ? offsetof(SFG_PackedVertex, Texc) : 0);
+
+    if (numInstances > 0)
+        fghDrawGeometryInstances(buffers);
+    else
+        fghDrawGeometryParts(buffers, 0);
+
+    if (useCoords)
         fghDisableVertexAttribArray(attribute_v_coord);
-    if (vbo_normals != 0)
+    if (useNormals)
         fghDisableVertexAttribArray(attribute_v_normal);
-
-    if (vbo_coords != 0)
-        fghDeleteBuffers(1, &vbo_coords);
-    if (vbo_normals != 0)
-        fghDeleteBuffers(1, &vbo_normals);
-    if (ibo_elements != 0)
-        fghDeleteBuffers(1, &ibo_elements);
-    if (ibo_elements2 != 0)
-        fghDeleteBuffers(1, &ibo_elements2);
-#endif	/* GL version at least 1.1 */
+    if (useTextcs)
+        fghDisableVertexAttribArray(attribute_v_texture);
 }
 
+/*
+ * Upload and draw the geometry described by buffers. If a key is given and
+ * the cache is enabled, the buffer objects are kept for later draws of the
+ * same shape, otherwise they are deleted again right away.
+ */
+static void fghDrawGeometry20(SFG_GeometryBuffers *buffers, const SFG_GeometryKey *key,
+                              GLfloat *vertices, GLfloat *normals, GLfloat *textcs,
+                              GLushort *vertIdxs, GLushort *vertIdxs2,
+                              GLint attribute_v_coord, GLint attribute_v_normal, GLint attribute_v_texture)
+{
+    SFG_Window *win = fgStructure.CurrentWindow;
+    SFG_GeometryBuffers *entry = NULL;
 
+    if (key && win && fgState.GeometryBufferCacheSize > 0)
+        entry = malloc(sizeof(SFG_GeometryBuffers));
 
+    if (entry)
+    {
+        /* Upload all the arrays, later draws may use other attributes */
+        *entry = *buffers;
+        entry->Key = *key;
+        entry->Key.VertexFormat = fgState.GeometryVertexFormat;
+        entry->NumPrimitives = fghCountPrimitives(vertices, buffers->VertexMode, vertIdxs,
+                                                  buffers->NumParts, buffers->NumVertPerPart,
+                                                  buffers->NumParts2, buffers->NumVertPerPart2);
+        fghGenGeometryBuffers(entry, vertices, normals, textcs, vertIdxs, vertIdxs2);
+        fghDrawGeometryBuffers(entry, attribute_v_coord, attribute_v_normal, attribute_v_texture);
+
+        fgListInsert(&win->Window.GeometryBuffers, win->Window.GeometryBuffers.First, &entry->Node);
+        win->Window.NumGeometryBuffers++;
+        while (win->Window.NumGeometryBuffers > fgState.GeometryBufferCacheSize)
+        {
+            SFG_GeometryBuffers *last = win->Window.GeometryBuffers.Last;
+            fgListRemove(&win->Window.GeometryBuffers, &last->Node);
+            win->Window.NumGeometryBuffers--;
+            fghDeleteGeometryBuffers(last);
+            free(last);
+        }
+    }
+    else
+    {
+        fghGenGeometryBuffers(buffers,
+                              attribute_v_coord   != -1 ? vertices : NULL,
+                              attribute_v_normal  != -1 ? normals  : NULL,
+                              attribute_v_texture != -1 ? textcs   : NULL,
+                              vertIdxs, vertIdxs2);
+        fghDrawGeometryBuffers(buffers, attribute_v_coord, attribute_v_normal, attribute_v_texture);
+        fghDeleteGeometryBuffers(buffers);
+    }
+}
+#endif	/* GL version at least 1.1 */
 
-/* Version for OpenGL (ES) >= 2.0 */
-static void fghDrawGeometrySolid20(GLfloat *vertices, GLfloat *normals, GLfloat *textcs, GLsizei numVertices,
-                                   GLushort *vertIdxs, GLsizei numParts, GLsizei numVertIdxsPerPart,
-                                   GLint attribute_v_coord, GLint attribute_v_normal, GLint attribute_v_texture)
+/*
+ * Draw the shape identified by key from the current window's buffer cache.
+ * Returns GL_FALSE if it isn't there, or the cache can't be used for this
+ * draw, in which case the caller has to generate the geometry.
+ */
+static GLboolean fghDrawCachedGeometry(const SFG_GeometryKey *key)
 {
 #if defined(GL_VERSION_1_1) || defined(GL_VERSION_ES_CM_1_0)
-    GLuint vbo_coords = 0, vbo_normals = 0, vbo_textcs = 0, ibo_elements = 0;
-    GLsizei numVertIdxs = numParts * numVertIdxsPerPart;
-    int i;
+    SFG_Window *win = fgStructure.CurrentWindow;
+    SFG_GeometryBuffers *buffers;
+    SFG_GeometryKey bufferKey;
+
+    if (!win || !fgState.HasOpenGL20 || fgState.GeometryBufferCacheSize <= 0)
+        return GL_FALSE;
+    if (win->Window.attribute_v_coord == -1 && win->Window.attribute_v_normal == -1)
+        /* Not an OpenGL 2.0 draw */
+        return GL_FALSE;
+    if (win->State.VisualizeNormals)
+        /* The normals are visualized from the generated arrays */
+        return GL_FALSE;
+
+    /* Buffers made before the vertex format was changed don't match, and age out */
+    bufferKey = *key;
+    bufferKey.VertexFormat = fgState.GeometryVertexFormat;
+
+    for (buffers = (SFG_GeometryBuffers *)win->Window.GeometryBuffers.First;
+         buffers;
+         buffers = (SFG_GeometryBuffers *)buffers->Node.Next)
+    {
+        if (fghGeometryKeyEqual(&buffers->Key, &bufferKey))
+        {
+            /* Move to front, the least recently used shapes are evicted first */
+            if (buffers->Node.Prev)
+            {
+                fgListRemove(&win->Window.GeometryBuffers, &buffers->Node);
+                fgListInsert(&win->Window.GeometryBuffers, win->Window.GeometryBuffers.First, &buffers->Node);
+            }
 
-    if (numVertices > 0 && attribute_v_coord != -1) {
-        fghGenBuffers(1, &vbo_coords);
-        fghBindBuffer(FGH_ARRAY_BUFFER, vbo_coords);
-        fghBufferData(FGH_ARRAY_BUFFER, numVertices * 3 * sizeof(vertices[0]),
-                      vertices, FGH_STATIC_DRAW);
-        fghBindBuffer(FGH_ARRAY_BUFFER, 0);
+            fghDrawGeometryBuffers(buffers,
+                                   win->Window.attribute_v_coord,
+                                   win->Window.attribute_v_normal,
+                                   win->Window.attribute_v_texture);
+            numPrimitivesDrawn = buffers->NumPrimitives;
+            return GL_TRUE;
+        }
     }
+#endif	/* GL version at least 1.1 */
 
-    if (numVertices > 0 && attribute_v_normal != -1) {
-        fghGenBuffers(1, &vbo_normals);
-        fghBindBuffer(FGH_ARRAY_BUFFER, vbo_normals);
-        fghBufferData(FGH_ARRAY_BUFFER, numVertices * 3 * sizeof(normals[0]),
-                      normals, FGH_STATIC_DRAW);
-        fghBindBuffer(FGH_ARRAY_BUFFER, 0);
-    }
+    return GL_FALSE;
+}
 
-    if (numVertices > 0 && attribute_v_texture != -1 && textcs) {
-        fghGenBuffers(1, &vbo_textcs);
-        fghBindBuffer(FGH_ARRAY_BUFFER, vbo_textcs);
-        fghBufferData(FGH_ARRAY_BUFFER, numVertices * 2 * sizeof(textcs[0]),
-                      textcs, FGH_STATIC_DRAW);
-        fghBindBuffer(FGH_ARRAY_BUFFER, 0);
+void fgFreeGeometryBuffers(SFG_Window *window)
+{
+    SFG_GeometryBuffers *buffers;
+
+    while ((buffers = (SFG_GeometryBuffers *)window->Window.GeometryBuffers.First))
+    {
+        fgListRemove(&window->Window.GeometryBuffers, &buffers->Node);
+#if defined(GL_VERSION_1_1) || defined(GL_VERSION_ES_CM_1_0)
+        fghDeleteGeometryBuffers(buffers);
+#endif
+        free(buffers);
     }
+    window->Window.NumGeometryBuffers = 0;
 
-    if (vertIdxs != NULL) {
-        fghGenBuffers(1, &ibo_elements);
-        fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, ibo_elements);
-        fghBufferData(FGH_ELEMENT_ARRAY_BUFFER, numVertIdxs * sizeof(vertIdxs[0]),
-                      vertIdxs, FGH_STATIC_DRAW);
-        fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, 0);
+#if defined(GL_VERSION_1_1) || defined(GL_VERSION_ES_CM_1_0)
+    if (window->Window.InstanceBuffer)
+    {
+        fghDeleteBuffers(1, &window->Window.InstanceBuffer);
+        window->Window.InstanceBuffer = 0;
     }
+#endif
+}
 
-    if (vbo_coords) {
-        fghEnableVertexAttribArray(attribute_v_coord);
-        fghBindBuffer(FGH_ARRAY_BUFFER, vbo_coords);
-        fghVertexAttribPointer(
-            attribute_v_coord,  /* attribute */
-            3,                  /* number of elements per vertex, here (x,y,z) */
-            GL_FLOAT,           /* the type of each element */
-            GL_FALSE,           /* take our values as-is */
-            0,                  /* no extra data between each position */
-            0                   /* offset of first element */
-        );
-        fghBindBuffer(FGH_ARRAY_BUFFER, 0);
-    };
+/* Version for OpenGL (ES) >= 2.0 */
+static void fghDrawGeometryWire20(GLfloat *vertices, GLfloat *normals, GLsizei numVertices,
+                                  GLushort *vertIdxs, GLsizei numParts, GLsizei numVertPerPart, GLenum vertexMode,
+                                  GLushort *vertIdxs2, GLsizei numParts2, GLsizei numVertPerPart2,
+                                  const SFG_GeometryKey *key,
+                                  GLint attribute_v_coord, GLint attribute_v_normal)
+{
+#if defined(GL_VERSION_1_1) || defined(GL_VERSION_ES_CM_1_0)
+    SFG_GeometryBuffers buffers;
+
+    memset(&buffers, 0, sizeof(buffers));
+    buffers.NumVertices     = numVertices;
+    buffers.VertexMode      = vertexMode;
+    buffers.NumParts        = numParts;
+    buffers.NumVertPerPart  = numVertPerPart;
+    if (vertIdxs2)
+    {
+        buffers.NumParts2       = numParts2;
+        buffers.NumVertPerPart2 = numVertPerPart2;
+    }
 
-    if (vbo_normals) {
-        fghEnableVertexAttribArray(attribute_v_normal);
-        fghBindBuffer(FGH_ARRAY_BUFFER, vbo_normals);
-        fghVertexAttribPointer(
-            attribute_v_normal, /* attribute */
-            3,                  /* number of elements per vertex, here (x,y,z) */
-            GL_FLOAT,           /* the type of each element */
-            GL_FALSE,           /* take our values as-is */
-            0,                  /* no extra data between each position */
-            0                   /* offset of first element */
-        );
-        fghBindBuffer(FGH_ARRAY_BUFFER, 0);
-    };
+    fghDrawGeometry20(&buffers, key,
+                      vertices, normals, NULL, vertIdxs, vertIdxs2,
+                      attribute_v_coord, attribute_v_normal, -1);
+#endif	/* GL version at least 1.1 */
+}
 
-    if (vbo_textcs) {
-        fghEnableVertexAttribArray(attribute_v_texture);
-        fghBindBuffer(FGH_ARRAY_BUFFER, vbo_textcs);
-        fghVertexAttribPointer(
-            attribute_v_texture,/* attribute */
-            2,                  /* number of elements per vertex, here (s,t) */
-            GL_FLOAT,           /* the type of each element */
-            GL_FALSE,           /* take our values as-is */
-            0,                  /* no extra data between each position */
-            0                   /* offset of first element */
-            );
-        fghBindBuffer(FGH_ARRAY_BUFFER, 0);
-    };
 
+
+
+/* Version for OpenGL (ES) >= 2.0 */
+static void fghDrawGeometrySolid20(GLfloat *vertices, GLfloat *normals, GLfloat *textcs, GLsizei numVertices,
+                                   GLushort *vertIdxs, GLsizei numParts, GLsizei numVertIdxsPerPart,
+                                   const SFG_GeometryKey *key,
+                                   GLint attribute_v_coord, GLint attribute_v_normal, GLint attribute_v_texture)
+{
+#if defined(GL_VERSION_1_1) || defined(GL_VERSION_ES_CM_1_0)
+    SFG_GeometryBuffers buffers;
+
+    memset(&buffers, 0, sizeof(buffers));
+    buffers.NumVertices = numVertices;
     if (vertIdxs == NULL) {
-        glDrawArrays(GL_TRIANGLES, 0, numVertices);
+        /* Separate triangles, one glDrawArrays */
+        buffers.VertexMode     = GL_TRIANGLES;
+        buffers.NumParts       = 1;
+        buffers.NumVertPerPart = numVertices;
+    } else if (numParts>1) {
+        buffers.VertexMode     = GL_TRIANGLE_STRIP;
+        buffers.NumParts       = numParts;
+        buffers.NumVertPerPart = numVertIdxsPerPart;
     } else {
-        fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, ibo_elements);
-        if (numParts>1) {
-            for (i=0; i<numParts; i++) {
-                glDrawElements(GL_TRIANGLE_STRIP, numVertIdxsPerPart, GL_UNSIGNED_SHORT, (GLvoid*)(sizeof(vertIdxs[0])*i*numVertIdxsPerPart));
-            }
-        } else {
-            glDrawElements(GL_TRIANGLES, numVertIdxsPerPart, GL_UNSIGNED_SHORT, 0);
-        }
-        /* Clean existing bindings before clean-up */
-        /* Android showed instability otherwise */
-        fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, 0);
+        buffers.VertexMode     = GL_TRIANGLES;
+        buffers.NumParts       = 1;
+        buffers.NumVertPerPart = numVertIdxsPerPart;
     }
 
-    if (vbo_coords != 0)
-        fghDisableVertexAttribArray(attribute_v_coord);
-    if (vbo_normals != 0)
-        fghDisableVertexAttribArray(attribute_v_normal);
-    if (vbo_textcs != 0)
-        fghDisableVertexAttribArray(attribute_v_texture);
-
-    if (vbo_coords != 0)
-        fghDeleteBuffers(1, &vbo_coords);
-    if (vbo_normals != 0)
-        fghDeleteBuffers(1, &vbo_normals);
-    if (vbo_textcs != 0)
-        fghDeleteBuffers(1, &vbo_textcs);
-    if (ibo_elements != 0)
-        fghDeleteBuffers(1, &ibo_elements);
+    fghDrawGeometry20(&buffers, key,
+                      vertices, normals, textcs, vertIdxs, NULL,
+                      attribute_v_coord, attribute_v_normal, attribute_v_texture);
 #endif	/* GL version at least 1.1 */
 }
 
@@ -1650,6 +2195,11 @@ void fghGenerateTorus(
 #define _DECLARE_INTERNAL_DRAW_DO_DECLARE(name,nameICaps,nameCaps,vertIdxs)\
     static void fgh##nameICaps( GLboolean useWireMode )\
     {\
+        SFG_GeometryKey key;\
+        fghInitGeometryKey(&key, FGH_SHAPE_##nameCaps, useWireMode, 0, 0, 0.f, 0.f, 0.f, 0.f);\
+        if (fghDrawCachedGeometry(&key))\
+            return;\
+        \
         if (!name##Cached)\
         {\
             fgh##nameICaps##Generate();\
@@ -1660,12 +2210,12 @@ void fghGenerateTorus(
         {\
             fghDrawGeometryWire (name##_verts,name##_norms,nameCaps##_VERT_PER_OBJ, \
                                  NULL,nameCaps##_NUM_FACES,nameCaps##_NUM_EDGE_PER_FACE,GL_LINE_LOOP,\
-                                 NULL,0,0);\
+                                 NULL,0,0,&key);\
         }\
         else\
         {\
             fghDrawGeometrySolid(name##_verts,name##_norms,NULL,nameCaps##_VERT_PER_OBJ,\
-                                 vertIdxs, 1, nameCaps##_VERT_PER_OBJ_TRI); \
+                                 vertIdxs, 1, nameCaps##_VERT_PER_OBJ_TRI, &key); \
         }\
     }
 #define DECLARE_INTERNAL_DRAW(name,nameICaps,nameCaps)                        _DECLARE_INTERNAL_DRAW_DO_DECLARE(name,nameICaps,nameCaps,NULL)
@@ -1674,6 +2224,11 @@ void fghGenerateTorus(
 static void fghCube( GLfloat dSize, GLboolean useWireMode )
 {
     GLfloat *vertices;
+    SFG_GeometryKey key;
+
+    fghInitGeometryKey(&key, FGH_SHAPE_CUBE, useWireMode, 0, 0, dSize, 0.f, 0.f, 0.f);
+    if (fghDrawCachedGeometry(&key))
+        return;
 
     if (!cubeCached)
     {
@@ -1704,10 +2259,10 @@ static void fghCube( GLfloat dSize, GLboolean useWireMode )
     if (useWireMode)
         fghDrawGeometryWire(vertices, cube_norms, CUBE_VERT_PER_OBJ,
                             NULL,CUBE_NUM_FACES, CUBE_NUM_EDGE_PER_FACE,GL_LINE_LOOP,
-                            NULL,0,0);
+                            NULL,0,0,&key);
     else
         fghDrawGeometrySolid(vertices, cube_norms, NULL, CUBE_VERT_PER_OBJ,
-                             cube_vertIdxs, 1, CUBE_VERT_PER_OBJ_TRI);
+                             cube_vertIdxs, 1, CUBE_VERT_PER_OBJ_TRI, &key);
 
     if (dSize!=1.f)
         /* cleanup allocated memory */
@@ -1730,6 +2285,13 @@ static void fghSierpinskiSponge ( int numLevels, double offset[3], GLfloat scale
 
     if (numTetr)
     {
+        SFG_GeometryKey key;
+
+        fghInitGeometryKey(&key, FGH_SHAPE_SIERPINSKISPONGE, useWireMode, numLevels, 0,
+                           (GLfloat)offset[0], (GLfloat)offset[1], (GLfloat)offset[2], scale);
+        if (fghDrawCachedGeometry(&key))
+            return;
+
         /* Allocate memory */
         vertices = malloc(numVert*3 * sizeof(GLfloat));
         normals  = malloc(numVert*3 * sizeof(GLfloat));
@@ -1748,9 +2310,9 @@ static void fghSierpinskiSponge ( int numLevels, double offset[3], GLfloat scale
         if (useWireMode)
             fghDrawGeometryWire (vertices,normals,numVert,
                                  NULL,numFace,TETRAHEDRON_NUM_EDGE_PER_FACE,GL_LINE_LOOP,
-                                 NULL,0,0);
+                                 NULL,0,0,&key);
         else
-            fghDrawGeometrySolid(vertices,normals,NULL,numVert,NULL,1,0);
+            fghDrawGeometrySolid(vertices,normals,NULL,numVert,NULL,1,0,&key);
 
         free(vertices);
         free(normals );
@@ -1758,8 +2320,223 @@ static void fghSierpinskiSponge ( int numLevels, double offset[3], GLfloat scale
 }
 
 
-static void fghSphere( GLfloat radius, GLint slices, GLint stacks, GLboolean useWireMode )
+/* -- MESH CACHE ----------------------------------------------------------- */
+/*
+ * Generating the round shapes requires trigonometry and a handful of
+ * allocations for the vertex, normal and index arrays. As programs tend to
+ * draw the same shapes frame after frame, the generated arrays are kept in
+ * a global list, most recently used first, of at most
+ * GLUT_GEOMETRY_MESH_CACHE_SIZE entries (0 disables the cache). Meshes are
+ * generated at unit size where possible and scaled at draw time, so that
+ * shapes differing only in size share an entry:
+ *   - sphere: unit radius, scaled uniformly by the radius
+ *   - cylinder: unit radius and height, scaled in x/y by the radius and in
+ *     z by the height (the normals don't depend on either)
+ *   - cone: keyed on the base to height ratio, scaled uniformly
+ *   - torus: keyed on the inner to outer radius ratio, scaled uniformly
+ *   - teapot, teacup and teaspoon: keyed on the number of patch
+ *     subdivisions, scaled uniformly (generated in fg_teapot.c). These are
+ *     not kept in the list but pinned in fg_teapot.c, one per shape, draw
+ *     mode, sign of the scale and subdivision level, so other shapes can't
+ *     evict them and a cache size of 0 doesn't disable them.
+ * Only the magnitude is factored out, so that negative sizes still give
+ * the same geometry (and normals) as before.
+ */
+typedef void (*FGHMeshGenerator)(SFG_GeometryMesh *mesh);
+
+static GLfloat *scaledVertices = NULL;     /* scratch buffer for scaled mesh vertices */
+static GLsizei  numScaledVertices = 0;
+
+/* The magnitude of a size, dividing by which leaves its sign (or zero) */
+static GLfloat fghUnitScale(GLfloat size)
+{
+    GLfloat scale = (GLfloat)fabs(size);
+    return scale != 0.f ? scale : 1.f;
+}
+
+void fghFreeGeometryMeshArrays(SFG_GeometryMesh *mesh)
+{
+    free(mesh->Vertices);
+    free(mesh->Normals);
+    free(mesh->Texcs);
+    free(mesh->VertIdxs);
+    free(mesh->VertIdxs2);
+}
+
+static void fghTrimGeometryMeshes(int maxMeshes)
+{
+    while (fgState.NumGeometryMeshes > maxMeshes)
+    {
+        SFG_GeometryMesh *last = fgState.GeometryMeshes.Last;
+        fgListRemove(&fgState.GeometryMeshes, &last->Node);
+        fgState.NumGeometryMeshes--;
+        fghFreeGeometryMeshArrays(last);
+        free(last);
+    }
+}
+
+/* Solid meshes are drawn as fghDrawGeometrySolid20 draws them */
+static void fghCountMeshPrimitives(SFG_GeometryMesh *mesh)
+{
+    GLenum vertexMode = mesh->Key.WireMode ? mesh->VertexMode :
+                        mesh->NumParts > 1 ? GL_TRIANGLE_STRIP : GL_TRIANGLES;
+
+    mesh->NumPrimitives = fghCountPrimitives(mesh->Vertices, vertexMode, mesh->VertIdxs,
+                                             mesh->NumParts, mesh->NumVertPerPart,
+                                             mesh->NumParts2, mesh->NumVertPerPart2);
+}
+
+void fgFreeGeometryMeshes(void)
+{
+    fghTrimGeometryMeshes(0);
+    fgFreeTeasetMeshes();
+
+    free(scaledVertices);
+    scaledVertices = NULL;
+    numScaledVertices = 0;
+}
+
+/*
+ * Return the mesh for key from the cache, or generate it. If the cache is
+ * disabled the mesh is generated into the caller's tmpMesh, which the
+ * caller then has to free with fghFreeGeometryMeshArrays.
+ */
+static SFG_GeometryMesh *fghGetGeometryMesh(const SFG_GeometryKey *key, FGHMeshGenerator generate, SFG_GeometryMesh *tmpMesh)
+{
+    SFG_GeometryMesh *mesh = NULL;
+
+    if (fgState.GeometryMeshCacheSize > 0)
+    {
+        for (mesh = (SFG_GeometryMesh *)fgState.GeometryMeshes.First;
+             mesh;
+             mesh = (SFG_GeometryMesh *)mesh->Node.Next)
+        {
+            if (fghGeometryKeyEqual(&mesh->Key, key))
+            {
+                /* Move to front, the least recently used meshes are evicted first */
+                if (mesh->Node.Prev)
+                {
+                    fgListRemove(&fgState.GeometryMeshes, &mesh->Node);
+                    fgListInsert(&fgState.GeometryMeshes, fgState.GeometryMeshes.First, &mesh->Node);
+                }
+                fgState.GeometryMeshCacheHits++;
+                return mesh;
+            }
+        }
+
+        mesh = malloc(sizeof(SFG_GeometryMesh));
+    }
+    fgState.GeometryMeshCacheMisses++;
+
+    if (!mesh)
+        mesh = tmpMesh;
+    memset(mesh, 0, sizeof(SFG_GeometryMesh));
+    mesh->Key = *key;
+    generate(mesh);
+    fghCountMeshPrimitives(mesh);
+
+    if (mesh != tmpMesh)
+    {
+        fgListInsert(&fgState.GeometryMeshes, fgState.GeometryMeshes.First, &mesh->Node);
+        fgState.NumGeometryMeshes++;
+        fghTrimGeometryMeshes(fgState.GeometryMeshCacheSize);
+    }
+
+    return mesh;
+}
+
+/* Draw a mesh, scaling its vertices by sx, sy and sz */
+static void fghDrawGeometryMesh(SFG_GeometryMesh *mesh, GLfloat sx, GLfloat sy, GLfloat sz, const SFG_GeometryKey *key)
+{
+    GLfloat *vertices = mesh->Vertices;
+
+    numPrimitivesDrawn = mesh->NumPrimitives;
+    if (mesh->NumVertices == 0)
+        /* nothing to draw */
+        return;
+
+    if (sx != 1.f || sy != 1.f || sz != 1.f)
+    {
+        int i;
+
+        if (numScaledVertices < mesh->NumVertices)
+        {
+            GLfloat *buf = realloc(scaledVertices, mesh->NumVertices*3*sizeof(GLfloat));
+            /* Bail out if memory allocation fails, fgError never returns */
+            if (!buf)
+                fgError("Failed to allocate memory in fghDrawGeometryMesh");
+            scaledVertices    = buf;
+            numScaledVertices = mesh->NumVertices;
+        }
+
+        vertices = scaledVertices;
+        for (i=0; i<mesh->NumVertices*3; i+=3)
+        {
+            vertices[i  ] = sx*mesh->Vertices[i  ];
+            vertices[i+1] = sy*mesh->Vertices[i+1];
+            vertices[i+2] = sz*mesh->Vertices[i+2];
+        }
+    }
+
+    if (key->WireMode)
+        fghDrawGeometryWire(vertices, mesh->Normals, mesh->NumVertices,
+                            mesh->VertIdxs, mesh->NumParts, mesh->NumVertPerPart, mesh->VertexMode,
+                            mesh->VertIdxs2, mesh->NumParts2, mesh->NumVertPerPart2, key);
+    else
+        fghDrawGeometrySolid(vertices, mesh->Normals, mesh->Texcs, mesh->NumVertices,
+                             mesh->VertIdxs, mesh->NumParts, mesh->NumVertPerPart, key);
+}
+
+/*
+ * Draw a round shape: from the buffer cache if possible, else from its
+ * (possibly cached) mesh, generated at the size given by meshKey.
+ */
+static void fghDrawRoundShape(const SFG_GeometryKey *key, const SFG_GeometryKey *meshKey,
+                              GLfloat sx, GLfloat sy, GLfloat sz, FGHMeshGenerator generate)
+{
+    SFG_GeometryMesh tmpMesh, *mesh;
+
+    if (fghDrawCachedGeometry(key))
+        return;
+
+    mesh = fghGetGeometryMesh(meshKey, generate, &tmpMesh);
+    fghDrawGeometryMesh(mesh, sx, sy, sz, key);
+
+    if (mesh == &tmpMesh)
+        fghFreeGeometryMeshArrays(&tmpMesh);
+}
+
+/*
+ * As fghDrawRoundShape, but from a mesh the caller keeps itself instead of
+ * one in the mesh cache. The mesh is regenerated if it was made for
+ * another meshKey (a zeroed mesh is made for none).
+ */
+void fghDrawPinnedShape(const SFG_GeometryKey *key, const SFG_GeometryKey *meshKey, SFG_GeometryMesh *mesh,
+                        GLfloat sx, GLfloat sy, GLfloat sz, FGHMeshGenerator generate)
+{
+    if (fghDrawCachedGeometry(key))
+        return;
+
+    if (fghGeometryKeyEqual(&mesh->Key, meshKey))
+        fgState.GeometryMeshCacheHits++;
+    else
+    {
+        fghFreeGeometryMeshArrays(mesh);
+        memset(mesh, 0, sizeof(SFG_GeometryMesh));
+        mesh->Key = *meshKey;
+        generate(mesh);
+        fghCountMeshPrimitives(mesh);
+        fgState.GeometryMeshCacheMisses++;
+    }
+
+    fghDrawGeometryMesh(mesh, sx, sy, sz, key);
+}
+
+
+static void fghGenerateSphereMesh( SFG_GeometryMesh *mesh )
 {
+    GLfloat radius = mesh->Key.Params[0];
+    GLint slices = mesh->Key.Slices, stacks = mesh->Key.Stacks;
     int i,j,idx, nVert;
     GLfloat *vertices, *normals;
 
@@ -1770,7 +2547,11 @@ static void fghSphere( GLfloat radius, GLint slices, GLint stacks, GLboolean use
         /* nothing to draw */
         return;
 
-    if (useWireMode)
+    mesh->Vertices    = vertices;
+    mesh->Normals     = normals;
+    mesh->NumVertices = nVert;
+
+    if (mesh->Key.WireMode)
     {
         GLushort  *sliceIdx, *stackIdx;
         /* First, generate vertex index arrays for drawing with glDrawElements
@@ -1809,14 +2590,14 @@ static void fghSphere( GLfloat radius, GLint slices, GLint stacks, GLboolean use
             sliceIdx[idx++] = nVert-1;              /* zero based index, last element in array... */
         }
 
-        /* draw */
-        fghDrawGeometryWire(vertices,normals,nVert,
-            sliceIdx,slices,stacks+1,GL_LINE_STRIP,
-            stackIdx,stacks-1,slices);
-
-        /* cleanup allocated memory */
-        free(sliceIdx);
-        free(stackIdx);
+        /* draw as GL_LINE_STRIPs along the slices, GL_LINE_LOOPs around the stacks */
+        mesh->VertIdxs        = sliceIdx;
+        mesh->VertexMode      = GL_LINE_STRIP;
+        mesh->NumParts        = slices;
+        mesh->NumVertPerPart  = stacks+1;
+        mesh->VertIdxs2       = stackIdx;
+        mesh->NumParts2       = stacks-1;
+        mesh->NumVertPerPart2 = slices;
     }
     else
     {
@@ -1871,20 +2652,28 @@ static void fghSphere( GLfloat radius, GLint slices, GLint stacks, GLboolean use
         stripIdx[idx+1] = offset;
 
 
-        /* draw */
-        fghDrawGeometrySolid(vertices,normals,NULL,nVert,stripIdx,stacks,(slices+1)*2);
-
-        /* cleanup allocated memory */
-        free(stripIdx);
+        /* draw as one GL_TRIANGLE_STRIP per stack */
+        mesh->VertIdxs       = stripIdx;
+        mesh->NumParts       = stacks;
+        mesh->NumVertPerPart = (slices+1)*2;
     }
+}
+
+static void fghSphere( GLfloat radius, GLint slices, GLint stacks, GLboolean useWireMode )
+{
+    SFG_GeometryKey key, meshKey;
+    GLfloat scale = fghUnitScale(radius);
 
-    /* cleanup allocated memory */
-    free(vertices);
-    free(normals);
+    fghInitGeometryKey(&key,     FGH_SHAPE_SPHERE, useWireMode, slices, stacks, radius,       0.f, 0.f, 0.f);
+    fghInitGeometryKey(&meshKey, FGH_SHAPE_SPHERE, useWireMode, slices, stacks, radius/scale, 0.f, 0.f, 0.f);
+
+    fghDrawRoundShape(&key, &meshKey, scale, scale, scale, fghGenerateSphereMesh);
 }
 
-static void fghCone( GLfloat base, GLfloat height, GLint slices, GLint stacks, GLboolean useWireMode )
+static void fghGenerateConeMesh( SFG_GeometryMesh *mesh )
 {
+    GLfloat base = mesh->Key.Params[0], height = mesh->Key.Params[1];
+    GLint slices = mesh->Key.Slices, stacks = mesh->Key.Stacks;
     int i,j,idx, nVert;
     GLfloat *vertices, *normals;
 
@@ -1896,7 +2685,11 @@ static void fghCone( GLfloat base, GLfloat height, GLint slices, GLint stacks, G
         /* nothing to draw */
         return;
 
-    if (useWireMode)
+    mesh->Vertices    = vertices;
+    mesh->Normals     = normals;
+    mesh->NumVertices = nVert;
+
+    if (mesh->Key.WireMode)
     {
         GLushort  *sliceIdx, *stackIdx;
         /* First, generate vertex index arrays for drawing with glDrawElements
@@ -1931,14 +2724,14 @@ static void fghCone( GLfloat base, GLfloat height, GLint slices, GLint stacks, G
             sliceIdx[idx++] = offset+(stacks+1)*slices;
         }
 
-        /* draw */
-        fghDrawGeometryWire(vertices,normals,nVert,
-            sliceIdx,1,slices*2,GL_LINES,
-            stackIdx,stacks,slices);
-
-        /* cleanup allocated memory */
-        free(sliceIdx);
-        free(stackIdx);
+        /* draw as GL_LINES along the slices, GL_LINE_LOOPs around the stacks */
+        mesh->VertIdxs        = sliceIdx;
+        mesh->VertexMode      = GL_LINES;
+        mesh->NumParts        = 1;
+        mesh->NumVertPerPart  = slices*2;
+        mesh->VertIdxs2       = stackIdx;
+        mesh->NumParts2       = stacks;
+        mesh->NumVertPerPart2 = slices;
     }
     else
     {
@@ -1982,20 +2775,29 @@ static void fghCone( GLfloat base, GLfloat height, GLint slices, GLint stacks, G
             stripIdx[idx+1] = offset+slices;
         }
 
-        /* draw */
-        fghDrawGeometrySolid(vertices,normals,NULL,nVert,stripIdx,stacks+1,(slices+1)*2);
-
-        /* cleanup allocated memory */
-        free(stripIdx);
+        /* draw as one GL_TRIANGLE_STRIP per stack, plus the bottom */
+        mesh->VertIdxs       = stripIdx;
+        mesh->NumParts       = stacks+1;
+        mesh->NumVertPerPart = (slices+1)*2;
     }
+}
+
+static void fghCone( GLfloat base, GLfloat height, GLint slices, GLint stacks, GLboolean useWireMode )
+{
+    SFG_GeometryKey key, meshKey;
+    /* The normals only depend on the base to height ratio */
+    GLfloat scale = fghUnitScale(height != 0.f ? height : base);
 
-    /* cleanup allocated memory */
-    free(vertices);
-    free(normals);
+    fghInitGeometryKey(&key,     FGH_SHAPE_CONE, useWireMode, slices, stacks, base,       height,       0.f, 0.f);
+    fghInitGeometryKey(&meshKey, FGH_SHAPE_CONE, useWireMode, slices, stacks, base/scale, height/scale, 0.f, 0.f);
+
+    fghDrawRoundShape(&key, &meshKey, scale, scale, scale, fghGenerateConeMesh);
 }
 
-static void fghCylinder( GLfloat radius, GLfloat height, GLint slices, GLint stacks, GLboolean useWireMode )
+static void fghGenerateCylinderMesh( SFG_GeometryMesh *mesh )
 {
+    GLfloat radius = mesh->Key.Params[0], height = mesh->Key.Params[1];
+    GLint slices = mesh->Key.Slices, stacks = mesh->Key.Stacks;
     int i,j,idx, nVert;
     GLfloat *vertices, *normals;
 
@@ -2007,7 +2809,11 @@ static void fghCylinder( GLfloat radius, GLfloat height, GLint slices, GLint sta
         /* nothing to draw */
         return;
 
-    if (useWireMode)
+    mesh->Vertices    = vertices;
+    mesh->Normals     = normals;
+    mesh->NumVertices = nVert;
+
+    if (mesh->Key.WireMode)
     {
         GLushort  *sliceIdx, *stackIdx;
         /* First, generate vertex index arrays for drawing with glDrawElements
@@ -2042,14 +2848,14 @@ static void fghCylinder( GLfloat radius, GLfloat height, GLint slices, GLint sta
             sliceIdx[idx++] = offset+(stacks+1)*slices;
         }
 
-        /* draw */
-        fghDrawGeometryWire(vertices,normals,nVert,
-            sliceIdx,1,slices*2,GL_LINES,
-            stackIdx,stacks+1,slices);
-
-        /* cleanup allocated memory */
-        free(sliceIdx);
-        free(stackIdx);
+        /* draw as GL_LINES along the slices, GL_LINE_LOOPs around the stacks */
+        mesh->VertIdxs        = sliceIdx;
+        mesh->VertexMode      = GL_LINES;
+        mesh->NumParts        = 1;
+        mesh->NumVertPerPart  = slices*2;
+        mesh->VertIdxs2       = stackIdx;
+        mesh->NumParts2       = stacks+1;
+        mesh->NumVertPerPart2 = slices;
     }
     else
     {
@@ -2103,20 +2909,29 @@ static void fghCylinder( GLfloat radius, GLfloat height, GLint slices, GLint sta
         stripIdx[idx  ] = offset;
         stripIdx[idx+1] = nVert-1;                  /* repeat first slice's idx for closing off shape */
 
-        /* draw */
-        fghDrawGeometrySolid(vertices,normals,NULL,nVert,stripIdx,stacks+2,(slices+1)*2);
-
-        /* cleanup allocated memory */
-        free(stripIdx);
+        /* draw as one GL_TRIANGLE_STRIP per stack, plus top and bottom */
+        mesh->VertIdxs       = stripIdx;
+        mesh->NumParts       = stacks+2;
+        mesh->NumVertPerPart = (slices+1)*2;
     }
+}
+
+static void fghCylinder( GLfloat radius, GLfloat height, GLint slices, GLint stacks, GLboolean useWireMode )
+{
+    SFG_GeometryKey key, meshKey;
+    GLfloat scaleXY = fghUnitScale(radius);
+    GLfloat scaleZ  = fghUnitScale(height);
 
-    /* cleanup allocated memory */
-    free(vertices);
-    free(normals);
+    fghInitGeometryKey(&key,     FGH_SHAPE_CYLINDER, useWireMode, slices, stacks, radius,         height,        0.f, 0.f);
+    fghInitGeometryKey(&meshKey, FGH_SHAPE_CYLINDER, useWireMode, slices, stacks, radius/scaleXY, height/scaleZ, 0.f, 0.f);
+
+    fghDrawRoundShape(&key, &meshKey, scaleXY, scaleXY, scaleZ, fghGenerateCylinderMesh);
 }
 
-static void fghTorus( GLfloat dInnerRadius, GLfloat dOuterRadius, GLint nSides, GLint nRings, GLboolean useWireMode )
+static void fghGenerateTorusMesh( SFG_GeometryMesh *mesh )
 {
+    GLfloat dInnerRadius = mesh->Key.Params[0], dOuterRadius = mesh->Key.Params[1];
+    GLint nSides = mesh->Key.Slices, nRings = mesh->Key.Stacks;
     int i,j,idx, nVert;
     GLfloat *vertices, *normals;
 
@@ -2127,7 +2942,11 @@ static void fghTorus( GLfloat dInnerRadius, GLfloat dOuterRadius, GLint nSides,
         /* nothing to draw */
         return;
 
-    if (useWireMode)
+    mesh->Vertices    = vertices;
+    mesh->Normals     = normals;
+    mesh->NumVertices = nVert;
+
+    if (mesh->Key.WireMode)
     {
         GLushort  *sideIdx, *ringIdx;
         /* First, generate vertex index arrays for drawing with glDrawElements
@@ -2154,14 +2973,14 @@ static void fghTorus( GLfloat dInnerRadius, GLfloat dOuterRadius, GLint nSides,
             for( j=0; j<nRings; j++, idx++ )
                 sideIdx[idx] = j * nSides + i;
 
-        /* draw */
-        fghDrawGeometryWire(vertices,normals,nVert,
-            ringIdx,nRings,nSides,GL_LINE_LOOP,
-            sideIdx,nSides,nRings);
-
-        /* cleanup allocated memory */
-        free(sideIdx);
-        free(ringIdx);
+        /* draw as GL_LINE_LOOPs around the rings and the sides */
+        mesh->VertIdxs        = ringIdx;
+        mesh->VertexMode      = GL_LINE_LOOP;
+        mesh->NumParts        = nRings;
+        mesh->NumVertPerPart  = nSides;
+        mesh->VertIdxs2       = sideIdx;
+        mesh->NumParts2       = nSides;
+        mesh->NumVertPerPart2 = nRings;
     }
     else
     {
@@ -2197,16 +3016,23 @@ static void fghTorus( GLfloat dInnerRadius, GLfloat dOuterRadius, GLint nSides,
             idx +=2;
         }
 
-        /* draw */
-        fghDrawGeometrySolid(vertices,normals,NULL,nVert,stripIdx,nSides,(nRings+1)*2);
-
-        /* cleanup allocated memory */
-        free(stripIdx);
+        /* draw as one GL_TRIANGLE_STRIP per side */
+        mesh->VertIdxs       = stripIdx;
+        mesh->NumParts       = nSides;
+        mesh->NumVertPerPart = (nRings+1)*2;
     }
+}
+
+static void fghTorus( GLfloat dInnerRadius, GLfloat dOuterRadius, GLint nSides, GLint nRings, GLboolean useWireMode )
+{
+    SFG_GeometryKey key, meshKey;
+    /* The shape only depends on the inner to outer radius ratio */
+    GLfloat scale = fghUnitScale(dOuterRadius != 0.f ? dOuterRadius : dInnerRadius);
 
-    /* cleanup allocated memory */
-    free(vertices);
-    free(normals);
+    fghInitGeometryKey(&key,     FGH_SHAPE_TORUS, useWireMode, nSides, nRings, dInnerRadius,       dOuterRadius,       0.f, 0.f);
+    fghInitGeometryKey(&meshKey, FGH_SHAPE_TORUS, useWireMode, nSides, nRings, dInnerRadius/scale, dOuterRadius/scale, 0.f, 0.f);
+
+    fghDrawRoundShape(&key, &meshKey, scale, scale, scale, fghGenerateTorusMesh);
 }
 
 
@@ -2331,5 +3157,210 @@ void FGAPIENTRY glutSolidSierpinskiSponge ( int num_levels, double offset[3], do
 
 DECLARE_SHAPE_INTERFACE(Tetrahedron)
 
+/*
+ * Draws a shape once per instance, see glutSolidShapeInstanced
+ */
+static void fghShapeInstanced(const char *name, int shape, const double *params,
+                              int format, int count, const GLfloat *data, GLboolean useWireMode)
+{
+    if (format != GLUT_INSTANCE_OFFSET_SCALE && format != GLUT_INSTANCE_MATRIX)
+    {
+        fgWarning("%s: unknown instance format 0x%x", name, format);
+        return;
+    }
+    if (count <= 0 || !data)
+        return;
+    if (!params && shape != GLUT_SHAPE_DODECAHEDRON && shape != GLUT_SHAPE_ICOSAHEDRON &&
+        shape != GLUT_SHAPE_OCTAHEDRON && shape != GLUT_SHAPE_RHOMBICDODECAHEDRON &&
+        shape != GLUT_SHAPE_TETRAHEDRON)
+    {
+        fgWarning("%s: shape 0x%x needs parameters", name, shape);
+        return;
+    }
+
+    instanceFormat = format;
+    instanceData   = data;
+    numInstances   = count;
+
+    switch (shape)
+    {
+    case GLUT_SHAPE_CUBE:
+        fghCube((GLfloat)params[0], useWireMode);
+        break;
+    case GLUT_SHAPE_DODECAHEDRON:
+        fghDodecahedron(useWireMode);
+        break;
+    case GLUT_SHAPE_ICOSAHEDRON:
+        fghIcosahedron(useWireMode);
+        break;
+    case GLUT_SHAPE_OCTAHEDRON:
+        fghOctahedron(useWireMode);
+        break;
+    case GLUT_SHAPE_RHOMBICDODECAHEDRON:
+        fghRhombicDodecahedron(useWireMode);
+        break;
+    case GLUT_SHAPE_TETRAHEDRON:
+        fghTetrahedron(useWireMode);
+        break;
+    case GLUT_SHAPE_SIERPINSKISPONGE:
+    {
+        double offset[3];
+        offset[0] = params[1];
+        offset[1] = params[2];
+        offset[2] = params[3];
+        fghSierpinskiSponge((int)params[0], offset, (GLfloat)params[4], useWireMode);
+        break;
+    }
+    case GLUT_SHAPE_SPHERE:
+        fghSphere((GLfloat)params[0], (GLint)params[1], (GLint)params[2], useWireMode);
+        break;
+    case GLUT_SHAPE_CONE:
+        fghCone((GLfloat)params[0], (GLfloat)params[1], (GLint)params[2], (GLint)params[3], useWireMode);
+        break;
+    case GLUT_SHAPE_CYLINDER:
+        fghCylinder((GLfloat)params[0], (GLfloat)params[1], (GLint)params[2], (GLint)params[3], useWireMode);
+        break;
+    case GLUT_SHAPE_TORUS:
+        fghTorus((GLfloat)params[0], (GLfloat)params[1], (GLint)params[2], (GLint)params[3], useWireMode);
+        break;
+    case GLUT_SHAPE_TEAPOT:
+        if (useWireMode) glutWireTeapot(params[0]); else glutSolidTeapot(params[0]);
+        break;
+    case GLUT_SHAPE_TEACUP:
+        if (useWireMode) glutWireTeacup(params[0]); else glutSolidTeacup(params[0]);
+        break;
+    case GLUT_SHAPE_TEASPOON:
+        if (useWireMode) glutWireTeaspoon(params[0]); else glutSolidTeaspoon(params[0]);
+        break;
+    default:
+        fgWarning("%s: unknown shape 0x%x", name, shape);
+        break;
+    }
+
+    numInstances = 0;
+    instanceData = NULL;
+}
+
+/*
+ * Draws a wire shape once for every transform in instanceData
+ */
+void FGAPIENTRY glutWireShapeInstanced( int shape, const double *params, int format, int count, const GLfloat *data )
+{
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutWireShapeInstanced" );
+    fghShapeInstanced("glutWireShapeInstanced", shape, params, format, count, data, GL_TRUE);
+}
+
+/*
+ * Draws a solid shape once for every transform in instanceData
+ */
+void FGAPIENTRY glutSolidShapeInstanced( int shape, const double *params, int format, int count, const GLfloat *data )
+{
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutSolidShapeInstanced" );
+    fghShapeInstanced("glutSolidShapeInstanced", shape, params, format, count, data, GL_FALSE);
+}
+
+/*
+ * Level of detail: the slices and stacks (or sides and rings) of the round
+ * shapes are picked from a few fixed levels, so that shapes drawn at about
+ * the same size on screen share their meshes and buffer objects in the
+ * caches. Drawn with n segments, a circle of radius r is off by at most
+ * r*(1-cos(pi/n)): the lowest level for which that is within the allowed
+ * error is used, for the largest circle along each direction of the shape.
+ * Cones and cylinders are straight along their axis and get a single stack.
+ */
+static const GLint lodLevels[] = { 6, 8, 12, 16, 24, 32, 48, 64, 96, 128 };
+#define FGH_NUM_LOD_LEVELS ((int)(sizeof(lodLevels)/sizeof(lodLevels[0])))
+
+static GLint fghLODSegments(GLfloat radiusPixels, GLfloat maxError)
+{
+    int i;
+    for (i=0; i<FGH_NUM_LOD_LEVELS-1; i++)
+        if (radiusPixels*(1.f-(GLfloat)cos(M_PI/lodLevels[i])) <= maxError)
+            break;
+    return lodLevels[i];
+}
+
+/*
+ * Draws a round shape at the level of detail for its size on screen, see
+ * glutSolidShapeLOD. Returns the number of triangles (or line segments)
+ * drawn, as counted from the shape's mesh or buffers.
+ */
+static int fghShapeLOD(const char *name, int shape, const double *params,
+                       double pixelsPerUnit, double maxError, GLboolean useWireMode)
+{
+    GLfloat scale = (GLfloat)fabs(pixelsPerUnit);
+    GLfloat error = maxError > 0. ? (GLfloat)maxError : 0.5f;
+    GLint slices, stacks;
+
+    if (!params)
+    {
+        fgWarning("%s: shape 0x%x needs parameters", name, shape);
+        return 0;
+    }
+
+    numPrimitivesDrawn = 0;
+    switch (shape)
+    {
+    case GLUT_SHAPE_SPHERE:
+        /* stacks span half a circle */
+        slices = fghLODSegments((GLfloat)fabs(params[0])*scale, error);
+        stacks = slices/2;
+        fghSphere((GLfloat)params[0], slices, stacks, useWireMode);
+        break;
+    case GLUT_SHAPE_CONE:
+        slices = fghLODSegments((GLfloat)fabs(params[0])*scale, error);
+        stacks = 1;
+        fghCone((GLfloat)params[0], (GLfloat)params[1], slices, stacks, useWireMode);
+        break;
+    case GLUT_SHAPE_CYLINDER:
+        slices = fghLODSegments((GLfloat)fabs(params[0])*scale, error);
+        stacks = 1;
+        fghCylinder((GLfloat)params[0], (GLfloat)params[1], slices, stacks, useWireMode);
+        break;
+    case GLUT_SHAPE_TORUS:
+        /* sides around the tube, rings around the outer edge of the torus */
+        slices = fghLODSegments((GLfloat)fabs(params[0])*scale, error);
+        stacks = fghLODSegments((GLfloat)(fabs(params[0])+fabs(params[1]))*scale, error);
+        fghTorus((GLfloat)params[0], (GLfloat)params[1], slices, stacks, useWireMode);
+        break;
+    default:
+        fgWarning("%s: shape 0x%x has no levels of detail", name, shape);
+        return 0;
+    }
+
+    return numPrimitivesDrawn;
+}
+
+/*
+ * Draws a wire sphere, cone, cylinder or torus tessellated for its size on screen
+ */
+int FGAPIENTRY glutWireShapeLOD( int shape, const double *params, double pixelsPerUnit, double maxError )
+{
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutWireShapeLOD" );
+    return fghShapeLOD("glutWireShapeLOD", shape, params, pixelsPerUnit, maxError, GL_TRUE);
+}
+
+/*
+ * Draws a solid sphere, cone, cylinder or torus tessellated for its size on screen
+ */
+int FGAPIENTRY glutSolidShapeLOD( int shape, const double *params, double pixelsPerUnit, double maxError )
+{
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutSolidShapeLOD" );
+    return fghShapeLOD("glutSolidShapeLOD", shape, params, pixelsPerUnit, maxError, GL_FALSE);
+}
+
+
+/*
+ * Releases the generated meshes, and the buffer objects kept for the
+ * shapes drawn in the current window
+ */
+void FGAPIENTRY glutFlushGeometryCache( void )
+{
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutFlushGeometryCache" );
+    fgFreeGeometryMeshes( );
+    if( fgStructure.CurrentWindow )
+        fgFreeGeometryBuffers( fgStructure.CurrentWindow );
+}
+
 
 /*** END OF FILE ***/
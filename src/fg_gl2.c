@@ -39,7 +39,14 @@ FGH_PFNGLBUFFERDATAPROC fghBufferData;
 FGH_PFNGLENABLEVERTEXATTRIBARRAYPROC fghEnableVertexAttribArray;
 FGH_PFNGLDISABLEVERTEXATTRIBARRAYPROC fghDisableVertexAttribArray;
 FGH_PFNGLVERTEXATTRIBPOINTERPROC fghVertexAttribPointer;
+FGH_PFNGLVERTEXATTRIB4FVPROC fghVertexAttrib4fv;
 #endif
+FGH_PFNGLDRAWARRAYSINSTANCEDPROC fghDrawArraysInstanced;
+FGH_PFNGLDRAWELEMENTSINSTANCEDPROC fghDrawElementsInstanced;
+FGH_PFNGLVERTEXATTRIBDIVISORPROC fghVertexAttribDivisor;
+FGH_PFNGLMULTIDRAWARRAYSPROC fghMultiDrawArrays;
+FGH_PFNGLMULTIDRAWELEMENTSPROC fghMultiDrawElements;
+FGH_PFNGLPRIMITIVERESTARTINDEXPROC fghPrimitiveRestartIndex;
 
 void FGAPIENTRY glutSetVertexAttribCoord3(GLint attrib) {
   if (fgStructure.CurrentWindow != NULL)
@@ -56,12 +63,98 @@ void FGAPIENTRY glutSetVertexAttribTexCoord2(GLint attrib) {
         fgStructure.CurrentWindow->Window.attribute_v_texture = attrib;
 }
 
+void FGAPIENTRY glutSetVertexAttribInstance(GLint attrib) {
+    if (fgStructure.CurrentWindow != NULL)
+        fgStructure.CurrentWindow->Window.attribute_v_instance = attrib;
+}
+
 #define LOADFUNC(ptr, type, name)	\
 	do { if(!(ptr = (type)glutGetProcAddress(name))) return; } while(0)
 
+/*
+ * Is the current context's version at least major.minor, or
+ * esMajor.esMinor for an OpenGL ES context (pass 0 if the feature
+ * isn't part of any OpenGL ES version)?
+ */
+static int fghGLVersionAtLeast(int major, int minor, int esMajor, int esMinor)
+{
+    const char *version = (const char *)glGetString(GL_VERSION);
+    int vMajor, vMinor;
+
+    if (!version)
+        return 0;
+
+    /* "OpenGL ES 3.0 ..." or "OpenGL ES-CM 1.1 ..." */
+    if (strncmp(version, "OpenGL ES", 9) == 0)
+    {
+        if (esMajor == 0)
+            return 0;
+        major = esMajor;
+        minor = esMinor;
+    }
+    while (*version && (*version < '0' || *version > '9'))
+        version++;
+
+    if (sscanf(version, "%d.%d", &vMajor, &vMinor) != 2)
+        return 0;
+    return vMajor > major || (vMajor == major && vMinor >= minor);
+}
+
+static void fghInitInstancedArrays() {
+    if (fghGLVersionAtLeast(3, 3, 3, 0)) {
+        LOADFUNC(fghDrawArraysInstanced, FGH_PFNGLDRAWARRAYSINSTANCEDPROC, "glDrawArraysInstanced");
+        LOADFUNC(fghDrawElementsInstanced, FGH_PFNGLDRAWELEMENTSINSTANCEDPROC, "glDrawElementsInstanced");
+        LOADFUNC(fghVertexAttribDivisor, FGH_PFNGLVERTEXATTRIBDIVISORPROC, "glVertexAttribDivisor");
+    } else if (glutExtensionSupported("GL_ARB_instanced_arrays") &&
+               glutExtensionSupported("GL_ARB_draw_instanced")) {
+        LOADFUNC(fghDrawArraysInstanced, FGH_PFNGLDRAWARRAYSINSTANCEDPROC, "glDrawArraysInstancedARB");
+        LOADFUNC(fghDrawElementsInstanced, FGH_PFNGLDRAWELEMENTSINSTANCEDPROC, "glDrawElementsInstancedARB");
+        LOADFUNC(fghVertexAttribDivisor, FGH_PFNGLVERTEXATTRIBDIVISORPROC, "glVertexAttribDivisorARB");
+    } else if (glutExtensionSupported("GL_EXT_instanced_arrays")) {
+        LOADFUNC(fghDrawArraysInstanced, FGH_PFNGLDRAWARRAYSINSTANCEDPROC, "glDrawArraysInstancedEXT");
+        LOADFUNC(fghDrawElementsInstanced, FGH_PFNGLDRAWELEMENTSINSTANCEDPROC, "glDrawElementsInstancedEXT");
+        LOADFUNC(fghVertexAttribDivisor, FGH_PFNGLVERTEXATTRIBDIVISORPROC, "glVertexAttribDivisorEXT");
+    } else {
+        return;
+    }
+    fgState.HasInstancedArrays = 1;
+}
+
+static void fghInitMultiDraw() {
+    if (fghGLVersionAtLeast(1, 4, 0, 0)) {
+        LOADFUNC(fghMultiDrawArrays, FGH_PFNGLMULTIDRAWARRAYSPROC, "glMultiDrawArrays");
+        LOADFUNC(fghMultiDrawElements, FGH_PFNGLMULTIDRAWELEMENTSPROC, "glMultiDrawElements");
+    } else if (glutExtensionSupported("GL_EXT_multi_draw_arrays")) {
+        LOADFUNC(fghMultiDrawArrays, FGH_PFNGLMULTIDRAWARRAYSPROC, "glMultiDrawArraysEXT");
+        LOADFUNC(fghMultiDrawElements, FGH_PFNGLMULTIDRAWELEMENTSPROC, "glMultiDrawElementsEXT");
+    } else {
+        return;
+    }
+    fgState.HasMultiDraw = 1;
+}
+
+static void fghInitPrimitiveRestart() {
+    if (fghGLVersionAtLeast(4, 3, 3, 0)) {
+        /* Always restarts at the maximum index, no function needed */
+        fgState.PrimitiveRestart = FGH_PRIMITIVE_RESTART_FIXED_INDEX;
+    } else if (fghGLVersionAtLeast(3, 1, 0, 0)) {
+        LOADFUNC(fghPrimitiveRestartIndex, FGH_PFNGLPRIMITIVERESTARTINDEXPROC, "glPrimitiveRestartIndex");
+        fgState.PrimitiveRestart = FGH_PRIMITIVE_RESTART;
+    }
+}
+
 void fgInitGL2() {
+    fgState.HasInstancedArrays = 0;
+    fgState.HasMultiDraw = 0;
+    fgState.PrimitiveRestart = 0;
+
+    /* Also used by the OpenGL 1.x paths */
+    fghInitMultiDraw();
+
 #ifdef GL_ES_VERSION_2_0
     fgState.HasOpenGL20 = (fgState.MajorVersion >= 2);
+    if (!fgState.HasOpenGL20)
+        return;
 #else
     /* TODO: Mesa returns a valid stub function, rather than NULL,
        when we request a non-existent function */
@@ -72,6 +165,10 @@ void fgInitGL2() {
     LOADFUNC(fghVertexAttribPointer, FGH_PFNGLVERTEXATTRIBPOINTERPROC, "glVertexAttribPointer");
     LOADFUNC(fghEnableVertexAttribArray, FGH_PFNGLENABLEVERTEXATTRIBARRAYPROC, "glEnableVertexAttribArray");
     LOADFUNC(fghDisableVertexAttribArray, FGH_PFNGLDISABLEVERTEXATTRIBARRAYPROC, "glDisableVertexAttribArray");
+    LOADFUNC(fghVertexAttrib4fv, FGH_PFNGLVERTEXATTRIB4FVPROC, "glVertexAttrib4fv");
     fgState.HasOpenGL20 = 1;
 #endif
+
+    fghInitInstancedArrays();
+    fghInitPrimitiveRestart();
 }
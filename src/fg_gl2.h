@@ -33,7 +33,9 @@
 /* Use existing functions on GLES 2.0 */
 
 #define FGH_ARRAY_BUFFER GL_ARRAY_BUFFER
+#define FGH_ARRAY_BUFFER_BINDING GL_ARRAY_BUFFER_BINDING
 #define FGH_STATIC_DRAW GL_STATIC_DRAW
+#define FGH_STREAM_DRAW GL_STREAM_DRAW
 #define FGH_ELEMENT_ARRAY_BUFFER GL_ELEMENT_ARRAY_BUFFER
 
 #define fghGenBuffers glGenBuffers
@@ -43,6 +45,7 @@
 #define fghEnableVertexAttribArray glEnableVertexAttribArray
 #define fghDisableVertexAttribArray glDisableVertexAttribArray
 #define fghVertexAttribPointer glVertexAttribPointer
+#define fghVertexAttrib4fv glVertexAttrib4fv
 
 #else
 /* Load functions dynamically, they are not defined in e.g. win32's
@@ -55,7 +58,9 @@
 /* extension #defines, types and entries, avoiding a dependency on additional
    libraries like GLEW or the GL/glext.h header */
 #define FGH_ARRAY_BUFFER 0x8892
+#define FGH_ARRAY_BUFFER_BINDING 0x8894
 #define FGH_STATIC_DRAW 0x88E4
+#define FGH_STREAM_DRAW 0x88E0
 #define FGH_ELEMENT_ARRAY_BUFFER 0x8893
 
 typedef int fghGLsizeiptr;
@@ -66,6 +71,7 @@ typedef void (APIENTRY *FGH_PFNGLDELETEBUFFERSPROC) (GLsizei n, const GLuint* bu
 typedef void (APIENTRY *FGH_PFNGLENABLEVERTEXATTRIBARRAYPROC) (GLuint index);
 typedef void (APIENTRY *FGH_PFNGLDISABLEVERTEXATTRIBARRAYPROC) (GLuint);
 typedef void (APIENTRY *FGH_PFNGLVERTEXATTRIBPOINTERPROC) (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid *pointer);
+typedef void (APIENTRY *FGH_PFNGLVERTEXATTRIB4FVPROC) (GLuint index, const GLfloat *v);
 
 extern FGH_PFNGLGENBUFFERSPROC fghGenBuffers;
 extern FGH_PFNGLDELETEBUFFERSPROC fghDeleteBuffers;
@@ -74,9 +80,40 @@ extern FGH_PFNGLBUFFERDATAPROC fghBufferData;
 extern FGH_PFNGLENABLEVERTEXATTRIBARRAYPROC fghEnableVertexAttribArray;
 extern FGH_PFNGLDISABLEVERTEXATTRIBARRAYPROC fghDisableVertexAttribArray;
 extern FGH_PFNGLVERTEXATTRIBPOINTERPROC fghVertexAttribPointer;
+extern FGH_PFNGLVERTEXATTRIB4FVPROC fghVertexAttrib4fv;
 
 #    endif
 
+/* Instanced drawing is optional (OpenGL 3.3, OpenGL ES 3.0 or extensions),
+   so always load those functions dynamically, see fgState.HasInstancedArrays */
+#ifndef APIENTRY
+#    define APIENTRY
+#endif
+
+typedef void (APIENTRY *FGH_PFNGLDRAWARRAYSINSTANCEDPROC) (GLenum mode, GLint first, GLsizei count, GLsizei instancecount);
+typedef void (APIENTRY *FGH_PFNGLDRAWELEMENTSINSTANCEDPROC) (GLenum mode, GLsizei count, GLenum type, const GLvoid *indices, GLsizei instancecount);
+typedef void (APIENTRY *FGH_PFNGLVERTEXATTRIBDIVISORPROC) (GLuint index, GLuint divisor);
+
+extern FGH_PFNGLDRAWARRAYSINSTANCEDPROC fghDrawArraysInstanced;
+extern FGH_PFNGLDRAWELEMENTSINSTANCEDPROC fghDrawElementsInstanced;
+extern FGH_PFNGLVERTEXATTRIBDIVISORPROC fghVertexAttribDivisor;
+
+/* Likewise for drawing several parts of a shape in one call: multi draw
+   (OpenGL 1.4 or GL_EXT_multi_draw_arrays, see fgState.HasMultiDraw) and
+   primitive restart (OpenGL 3.1 / 4.3 or OpenGL ES 3.0, see
+   fgState.PrimitiveRestart) */
+#define FGH_PRIMITIVE_RESTART 0x8F9D
+#define FGH_PRIMITIVE_RESTART_FIXED_INDEX 0x8D69
+#define FGH_PRIMITIVE_RESTART_INDEX 0xFFFF
+
+typedef void (APIENTRY *FGH_PFNGLMULTIDRAWARRAYSPROC) (GLenum mode, const GLint *first, const GLsizei *count, GLsizei drawcount);
+typedef void (APIENTRY *FGH_PFNGLMULTIDRAWELEMENTSPROC) (GLenum mode, const GLsizei *count, GLenum type, const GLvoid *const *indices, GLsizei drawcount);
+typedef void (APIENTRY *FGH_PFNGLPRIMITIVERESTARTINDEXPROC) (GLuint index);
+
+extern FGH_PFNGLMULTIDRAWARRAYSPROC fghMultiDrawArrays;
+extern FGH_PFNGLMULTIDRAWELEMENTSPROC fghMultiDrawElements;
+extern FGH_PFNGLPRIMITIVERESTARTINDEXPROC fghPrimitiveRestartIndex;
+
 extern void fgInitGL2();
 
 #endif
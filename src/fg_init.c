@@ -67,7 +67,8 @@ SFG_State fgState = { { -1, -1, GL_FALSE },  /* Position */
                       0,                     /* SwapCount */
                       0,                     /* SwapTime */
                       0,                     /* Time */
-                      { NULL, NULL },         /* Timers */
+                      0,                     /* TimeNs */
+                      { NULL, 0, 0, 0 },      /* Timers */
                       { NULL, NULL },         /* FreeTimers */
                       NULL,                   /* IdleCallback */
                       NULL,                   /* IdleCallbackData */
@@ -89,13 +90,31 @@ SFG_State fgState = { { -1, -1, GL_FALSE },  /* Position */
                       1,                      /* AuxiliaryBufferNumber */
                       4,                      /* SampleNumber */
                       GL_FALSE,               /* SkipStaleMotion */
+                      { GL_FALSE },           /* PendingEvents */
+                      GL_FALSE,               /* DeferContextRestore */
                       GL_FALSE,               /* StrokeFontDrawJoinDots */
+                      GL_FALSE,               /* BitmapFontAtlas */
+                      GL_FALSE,               /* SyncWindowGeometry */
                       GL_FALSE,               /* AllowNegativeWindowPosition */
                       1,                      /* OpenGL context MajorVersion */
                       0,                      /* OpenGL context MinorVersion */
                       0,                      /* OpenGL ContextFlags */
                       0,                      /* OpenGL ContextProfile */
                       0,                      /* HasOpenGL20 */
+                      0,                      /* HasInstancedArrays */
+                      0,                      /* HasMultiDraw */
+                      0,                      /* PrimitiveRestart */
+                      32,                     /* GeometryBufferCacheSize */
+                      { NULL, NULL },         /* GeometryMeshes */
+                      0,                      /* NumGeometryMeshes */
+                      16,                     /* GeometryMeshCacheSize */
+                      0,                      /* GeometryMeshCacheHits */
+                      0,                      /* GeometryMeshCacheMisses */
+                      GLUT_VERTEX_FORMAT_FLOAT, /* GeometryVertexFormat */
+                      0,                      /* TeasetSubdivisions */
+                      { NULL, NULL },         /* ModeValues */
+                      { -1, -1 },             /* NumModeValues */
+                      { GL_FALSE },           /* FrameStats */
                       NULL,                   /* ErrorFunc */
                       NULL,                   /* ErrorFuncData */
                       NULL,                   /* WarningFunc */
@@ -229,6 +248,7 @@ void fghCloseInputDevices ( void )
 void fgDeinitialize( void )
 {
     SFG_Timer *timer;
+    int i;
 
     if( !fgState.Initialised )
     {
@@ -250,11 +270,7 @@ void fgDeinitialize( void )
 
     fgDestroyStructure( );
 
-    while( ( timer = fgState.Timers.First) )
-    {
-        fgListRemove( &fgState.Timers, &timer->Node );
-        free( timer );
-    }
+    fgTimerQueueFree( &fgState.Timers );
 
     while( ( timer = fgState.FreeTimers.First) )
     {
@@ -262,6 +278,10 @@ void fgDeinitialize( void )
         free( timer );
     }
 
+    fgFreeGeometryMeshes( );
+    fgFreePreparedStrings( );
+    fgFreeStrokeFontLines( );
+
     fgPlatformDeinitialiseInputDevices ();
 
     fgState.MouseWheelTicks = 0;
@@ -271,6 +291,21 @@ void fgDeinitialize( void )
     fgState.ContextFlags = 0;
     fgState.ContextProfile = 0;
 
+    fgState.GeometryBufferCacheSize = 32;
+    fgState.GeometryMeshCacheSize   = 16;
+    fgState.GeometryMeshCacheHits   = 0;
+    fgState.GeometryMeshCacheMisses = 0;
+    fgState.GeometryVertexFormat    = GLUT_VERTEX_FORMAT_FLOAT;
+    fgState.TeasetSubdivisions      = 0;
+    for( i = 0; i < 2; i++ )
+    {
+        free( fgState.ModeValues[ i ] );
+        fgState.ModeValues[ i ]    = NULL;
+        fgState.NumModeValues[ i ] = -1;
+    }
+    memset( &fgState.FrameStats, 0, sizeof( fgState.FrameStats ) );
+    memset( &fgState.PendingEvents, 0, sizeof( fgState.PendingEvents ) );
+
     fgState.Initialised = GL_FALSE;
 
     fgState.Position.X = -1;
@@ -299,7 +334,6 @@ void fgDeinitialize( void )
     fgState.GameModeDepth   = -1;
     fgState.GameModeRefresh = -1;
 
-    fgListInit( &fgState.Timers );
     fgListInit( &fgState.FreeTimers );
 
     fgState.IdleCallback           = ( FGCBIdleUC )NULL;
@@ -352,6 +352,79 @@ typedef enum
   GLUT_EXEC_STATE_STOP
 } fgExecutionState ;
 
+/*
+ * Per frame timings of the main loop's phases, see glutGetFrameStats. The
+ * phases are exclusive: time spent in a phase nested in another one (like
+ * a swap in a display callback) only counts toward the nested phase.
+ */
+#define FG_FRAME_STATS_FRAMES 256       /* Frames kept in the ring buffer */
+#define FG_FRAME_STATS_PHASES 7         /* GLUT_FRAME_NUM_PHASES         */
+
+typedef struct tagSFG_FrameStats SFG_FrameStats;
+struct tagSFG_FrameStats
+{
+    GLboolean    Enabled;               /* Collect the frame statistics? */
+    fg_time_t    Phases[ FG_FRAME_STATS_PHASES ];  /* ns spent in the current frame */
+    fg_time_t    Recorded;              /* Sum of those, for excluding nested phases */
+    unsigned int Frames[ FG_FRAME_STATS_FRAMES ][ FG_FRAME_STATS_PHASES ]; /* usec */
+    int          NextFrame;             /* Ring buffer write position    */
+    int          NumFrames;             /* Number of frames in there     */
+};
+
+/* Times one phase of the current frame, see fgFrameStatsBegin */
+typedef struct tagSFG_PhaseTimer SFG_PhaseTimer;
+struct tagSFG_PhaseTimer
+{
+    fg_time_t    Start;                 /* Start time, 0 if not timing   */
+    fg_time_t    Recorded;              /* SFG_FrameStats.Recorded then  */
+};
+
+/*
+ * Input events that GLUT_COALESCE_EVENTS can collapse, see fgCoalesceEvent.
+ * Pending events are delivered, in order, before any other callback and
+ * at the end of each glutMainLoopEvent's event processing.
+ */
+#define FG_EVENT_MOTION                 1
+#define FG_EVENT_PASSIVE                2
+#define FG_EVENT_MULTI_MOTION           3
+#define FG_EVENT_MULTI_PASSIVE          4
+#define FG_EVENT_SPACE_MOTION           5
+#define FG_EVENT_SPACE_ROTATION         6
+
+#define FG_COALESCED_EVENTS_MAX         8   /* Distinct events kept pending */
+
+typedef struct tagSFG_CoalescedEvent SFG_CoalescedEvent;
+struct tagSFG_CoalescedEvent
+{
+    int          Type;                  /* One of FG_EVENT_*             */
+    struct tagSFG_Window *Window;       /* The window it is for          */
+    int          Device;                /* Multi-pointer cursor ID       */
+    int          Args[ 3 ];             /* Latest callback arguments     */
+    int          Modifiers;             /* fgState.Modifiers at the time */
+};
+
+typedef struct tagSFG_PendingEvents SFG_PendingEvents;
+struct tagSFG_PendingEvents
+{
+    GLboolean    Enabled;               /* Coalesce the events at all?   */
+    SFG_CoalescedEvent Events[ FG_COALESCED_EVENTS_MAX ];
+    int          Count;                 /* Number of events pending      */
+    int          NumCoalesced;          /* Events dropped for newer ones */
+};
+
+/*
+ * The pending timers, as a binary min-heap ordered by trigger time. Timers
+ * with the same trigger time fire in the order they were created.
+ */
+typedef struct tagSFG_TimerQueue SFG_TimerQueue;
+struct tagSFG_TimerQueue
+{
+    struct tagSFG_Timer **Heap;         /* The heap array, earliest first */
+    int          Count;                 /* Number of timers in the heap  */
+    int          Size;                  /* Allocated size of Heap        */
+    fg_time_t    NextSequence;          /* Creation order of the timers  */
+};
+
 /* This structure holds different freeglut settings */
 typedef struct tagSFG_State SFG_State;
 struct tagSFG_State
@@ -378,7 +451,8 @@ struct tagSFG_State
     GLuint           SwapTime;             /* Time of last SwapBuffers       */
 
     fg_time_t        Time;                 /* Time that glutInit was called  */
-    SFG_List         Timers;               /* The freeglut timer hooks       */
+    fg_time_t        TimeNs;               /* The same, from fgSystemTimeNs  */
+    SFG_TimerQueue   Timers;               /* The freeglut timer hooks       */
     SFG_List         FreeTimers;           /* The unused timer hooks         */
 
     FGCBIdleUC       IdleCallback;         /* The global idle callback       */
@@ -408,8 +482,12 @@ struct tagSFG_State
     int              SampleNumber;         /*  Number of samples per pixel  */
 
     GLboolean        SkipStaleMotion;      /* skip stale motion events */
+    SFG_PendingEvents PendingEvents;       /* Motion events being coalesced */
+    GLboolean        DeferContextRestore;  /* Restore contexts lazily, see fgRestoreWindow */
 
     GLboolean        StrokeFontDrawJoinDots;/* Draw dots between line segments of stroke fonts? */
+    GLboolean        BitmapFontAtlas;      /* Draw bitmap fonts from glyph textures? */
+    GLboolean        SyncWindowGeometry;   /* Query window geometry from the window system in glutGet? */
     GLboolean        AllowNegativeWindowPosition; /* GLUT, by default, doesn't allow negative window positions. Enable it? */
 
     int              MajorVersion;         /* Major OpenGL context version  */
@@ -417,6 +495,20 @@ struct tagSFG_State
     int              ContextFlags;         /* OpenGL context flags          */
     int              ContextProfile;       /* OpenGL context profile        */
     int              HasOpenGL20;          /* fgInitGL2 could find all OpenGL 2.0 functions */
+    int              HasInstancedArrays;   /* fgInitGL2 could find the instanced drawing functions */
+    int              HasMultiDraw;         /* ... and glMultiDrawArrays/Elements */
+    GLenum           PrimitiveRestart;     /* FGH_PRIMITIVE_RESTART(_FIXED_INDEX) if supported, else 0 */
+    int              GeometryBufferCacheSize; /* Max. shapes kept in buffer objects per window */
+    SFG_List         GeometryMeshes;       /* Generated meshes, most recently used first */
+    int              NumGeometryMeshes;    /* Number of those               */
+    int              GeometryMeshCacheSize;/* Max. number of those          */
+    int              GeometryMeshCacheHits;  /* Meshes found in the cache   */
+    int              GeometryMeshCacheMisses;/* Meshes that were generated  */
+    int              GeometryVertexFormat; /* GLUT_VERTEX_FORMAT_FLOAT or _PACKED */
+    int              TeasetSubdivisions;   /* Teapot/teacup/teaspoon patch subdivisions, 0 for default */
+    int             *ModeValues[ 2 ];      /* glutGetModeValues answers for GLUT_AUX, GLUT_MULTISAMPLE */
+    int              NumModeValues[ 2 ];   /* Their sizes, -1 until asked   */
+    SFG_FrameStats   FrameStats;           /* Timings of the last frames    */
     FGErrorUC        ErrorFunc;            /* User defined error handler    */
     FGCBUserData     ErrorFuncData;        /* User defined error handler user data */
     FGWarningUC      WarningFunc;          /* User defined warning handler  */
@@ -444,9 +536,100 @@ struct tagSFG_Timer
     int             ID;                 /* The timer ID integer              */
     FGCBTimerUC     Callback;           /* The timer callback                */
     FGCBUserData    CallbackData;       /* The timer callback user data      */
-    fg_time_t       TriggerTime;        /* The timer trigger time            */
+    fg_time_t       TriggerTime;        /* The timer trigger time, in ns     */
+    fg_time_t       Sequence;           /* Orders timers with equal TriggerTime */
 };
 
+/* The built-in shapes of fg_geometry.c and fg_teapot.c */
+#define FGH_SHAPE_CUBE                  1
+#define FGH_SHAPE_DODECAHEDRON          2
+#define FGH_SHAPE_ICOSAHEDRON           3
+#define FGH_SHAPE_OCTAHEDRON            4
+#define FGH_SHAPE_RHOMBICDODECAHEDRON   5
+#define FGH_SHAPE_TETRAHEDRON           6
+#define FGH_SHAPE_SIERPINSKISPONGE      7
+#define FGH_SHAPE_SPHERE                8
+#define FGH_SHAPE_CONE                  9
+#define FGH_SHAPE_CYLINDER              10
+#define FGH_SHAPE_TORUS                 11
+#define FGH_SHAPE_TEAPOT                12
+#define FGH_SHAPE_TEACUP                13
+#define FGH_SHAPE_TEASPOON              14
+
+/*
+ * Identifies one of the built-in shapes and the parameters it was
+ * generated with, see the geometry buffer cache in fg_geometry.c
+ */
+typedef struct tagSFG_GeometryKey SFG_GeometryKey;
+struct tagSFG_GeometryKey
+{
+    int             Shape;              /* Which shape, FGH_SHAPE_*          */
+    GLboolean       WireMode;           /* Wire frame or solid               */
+    GLint           Slices, Stacks;     /* The subdivisions (or levels)      */
+    GLfloat         Params[ 4 ];        /* Sizes, radii, offsets...          */
+    int             VertexFormat;       /* GLUT_GEOMETRY_VERTEX_FORMAT the   */
+                                        /* buffers were made with, 0 for meshes */
+};
+
+/*
+ * The vertex and index buffer objects holding a shape's geometry,
+ * along with everything needed to draw them again.
+ */
+typedef struct tagSFG_GeometryBuffers SFG_GeometryBuffers;
+struct tagSFG_GeometryBuffers
+{
+    SFG_Node        Node;
+    SFG_GeometryKey Key;                /* The shape stored in the buffers   */
+
+    GLuint          VboCoords;          /* Vertex coordinates, if any        */
+    GLuint          VboNormals;         /* Normals, if any                   */
+    GLuint          VboTexcs;           /* Texture coordinates, if any       */
+    GLenum          VertexFormat;       /* If GLUT_VERTEX_FORMAT_PACKED, the */
+                                        /* three VBOs are the same buffer    */
+    GLuint          IboElements;        /* Index buffer for the first parts  */
+    GLuint          IboElements2;       /* Index buffer for the second parts */
+
+    GLsizei         NumVertices;        /* Number of vertices in the VBOs    */
+    GLenum          VertexMode;         /* Primitive of the first parts      */
+    GLsizei         NumParts;           /* Number and size of the parts      */
+    GLsizei         NumVertPerPart;     /* drawn as VertexMode...            */
+    GLsizei         NumParts2;          /* ...and of those drawn as          */
+    GLsizei         NumVertPerPart2;    /* GL_LINE_LOOPs                     */
+    GLenum          PrimitiveRestart;   /* Parts joined by restart indices?  */
+    GLsizei         NumPrimitives;      /* Triangles, or lines if wire       */
+};
+
+/*
+ * The vertex, normal and index arrays generated for one of the round
+ * shapes, see the mesh cache in fg_geometry.c
+ */
+typedef struct tagSFG_GeometryMesh SFG_GeometryMesh;
+struct tagSFG_GeometryMesh
+{
+    SFG_Node        Node;
+    SFG_GeometryKey Key;                /* The shape the mesh was made for   */
+
+    GLfloat        *Vertices;           /* Vertex coordinates                */
+    GLfloat        *Normals;            /* Normals                           */
+    GLfloat        *Texcs;              /* Texture coordinates, if any       */
+    GLsizei         NumVertices;        /* Number of entries in those        */
+    GLushort       *VertIdxs;           /* Indices of the first parts        */
+    GLushort       *VertIdxs2;          /* Indices of the second parts       */
+
+    GLenum          VertexMode;         /* As in SFG_GeometryBuffers         */
+    GLsizei         NumParts;
+    GLsizei         NumVertPerPart;
+    GLsizei         NumParts2;
+    GLsizei         NumVertPerPart2;
+    GLsizei         NumPrimitives;      /* Triangles, or lines if wire       */
+};
+
+/* Number of bitmap fonts, GLUT_BITMAP_8_BY_13 to GLUT_BITMAP_HELVETICA_18 */
+#define FG_NUM_BITMAP_FONTS 7
+
+/* Number of framebuffer configuration values kept per window, the fields of GLUTwindowConfig */
+#define FG_NUM_WINDOW_CONFIG_VALUES 18
+
 /*
  * A window and its OpenGL context. The contents of this structure
  * are highly dependent on the target operating system we aim at...
@@ -470,6 +653,29 @@ struct tagSFG_Context
     GLint attribute_v_coord;
     GLint attribute_v_normal;
     GLint attribute_v_texture;
+    GLint attribute_v_instance;          /* per instance vec4 or mat4 */
+
+    /* Stream buffer for the data of instanced shapes */
+    GLuint InstanceBuffer;
+
+    /* Buffer objects of the shapes drawn through those attributes,
+     * most recently used first, see fg_geometry.c
+     */
+    SFG_List GeometryBuffers;
+    int      NumGeometryBuffers;
+
+    /* Glyph textures of the bitmap fonts, and the stream buffer text
+     * goes through on the vertex attribute path, see fg_font.c
+     */
+    GLuint FontAtlases[ FG_NUM_BITMAP_FONTS ];
+    int    NumFontAtlases;
+    GLuint FontBuffer;
+
+    /* The framebuffer configuration, which can't change, as far as it has
+     * been asked for: a bit per value, see fghGetWindowConfig in fg_state.c
+     */
+    int          Config[ FG_NUM_WINDOW_CONFIG_VALUES ];
+    unsigned int ConfigKnown;
 };
 
 
@@ -529,6 +735,7 @@ struct tagSFG_WindowState   /* as per notes above, sizes always refer to the cli
     GLboolean       Visible;            /* Is the window visible now? Not using fgVisibilityState as we only care if visible or not */
     int             Cursor;             /* The currently selected cursor style */
     GLboolean       IsFullscreen;       /* is the window fullscreen?         */
+    int             SwapInterval;       /* Last set with glutSwapInterval    */
 
     /* FreeGLUT operations are deferred, that is, window moving, resizing,
      * Z-order changing, making full screen or not do not happen immediately
@@ -677,6 +884,8 @@ do                                                             \
 #define INVOKE_WCB(window,cbname,arg_list)    \
 do                                            \
 {                                             \
+    if( fgState.PendingEvents.Count )         \
+        fgFlushCoalescedEvents( );            \
     if( FETCH_WCB( window, cbname ) )         \
     {                                         \
         FGCB ## cbname ## UC func = (FGCB ## cbname ## UC)(FETCH_WCB( window, cbname )); \
@@ -773,6 +982,10 @@ struct tagSFG_Menu
     SFG_MenuEntry      *ActiveEntry;  /* Currently active entry in the menu  */
     SFG_Window         *Window;       /* Window for menu                     */
     SFG_Window         *ParentWindow; /* Window in which the menu is invoked */
+
+    GLuint              DisplayLists; /* The box, then each entry highlighted */
+    GLsizei             NumDisplayLists;
+    GLboolean           DisplayListsStale; /* Entries changed since compiled */
 };
 
 /* This is a menu entry */
@@ -784,7 +997,17 @@ struct tagSFG_MenuEntry
     char*               Text;                   /* The text to be displayed  */
     SFG_Menu*           SubMenu;                /* Optional sub-menu tree    */
     GLboolean           IsActive;               /* Is the entry highlighted? */
-    int                 Width;                  /* Label's width in pixels   */
+    int                 Width;                  /* Label's width, -1 if unknown */
+};
+
+/* A window's entry in the work queue, see fgPostWork */
+typedef struct tagSFG_WorkNode SFG_WorkNode;
+struct tagSFG_WorkNode
+{
+    SFG_Node            Node;
+    SFG_Window*         Window;                 /* The window it belongs to  */
+    SFG_List*           Queue;                  /* The list it is in, or NULL */
+    unsigned int        Pass;                   /* Last fghProcessWork pass that handled it */
 };
 
 /*
@@ -811,6 +1034,8 @@ struct tagSFG_Window
     SFG_List            Children;               /* The subwindows d.l. list  */
 
     GLboolean           IsMenu;                 /* Set to 1 if we are a menu */
+
+    SFG_WorkNode        WorkNode;               /* Queued if WorkMask is set */
 };
 
 
@@ -822,6 +1047,25 @@ struct tagSFG_WindowList
     SFG_Window *window ;
 };
 
+/*
+ * A hash map from window handles or IDs to windows or menus, with open
+ * addressing and linear probing. See fgWindowByHandle and friends.
+ */
+typedef struct tagSFG_HashEntry SFG_HashEntry;
+struct tagSFG_HashEntry
+{
+    size_t          Key;
+    void*           Value;           /* NULL if the slot is free           */
+};
+
+typedef struct tagSFG_HashMap SFG_HashMap;
+struct tagSFG_HashMap
+{
+    SFG_HashEntry*  Entries;
+    int             Size;            /* A power of two, or 0               */
+    int             Count;           /* Number of slots in use             */
+};
+
 /* This holds information about all the windows, menus etc. */
 typedef struct tagSFG_Structure SFG_Structure;
 struct tagSFG_Structure
@@ -829,6 +1073,15 @@ struct tagSFG_Structure
     SFG_List        Windows;         /* The global windows list            */
     SFG_List        Menus;           /* The global menus list              */
     SFG_List        WindowsToDestroy;
+    SFG_List        WorkQueue;       /* Windows with pending work          */
+    SFG_List        WorkDeferred;    /* Those fghProcessWork put off       */
+    unsigned int    WorkPass;        /* Number of fghProcessWork passes     */
+    int             NumWindows;      /* Top-level windows that aren't menus */
+
+    SFG_HashMap     WindowsByHandle; /* Lookup tables for fgWindowByHandle, */
+    SFG_HashMap     WindowsByID;     /* fgWindowByID and fgMenuByID         */
+    SFG_HashMap     MenusByID;
+    SFG_Window*     LastWindowByHandle; /* Last fgWindowByHandle result      */
 
     SFG_Window*     CurrentWindow;   /* The currently set window          */
     SFG_Menu*       CurrentMenu;     /* Same, but menu...                 */
@@ -1066,6 +1319,7 @@ SFG_Window* fgCreateWindow( SFG_Window* parent, const char* title,
                             GLboolean sizeUse, int w, int h,
                             GLboolean gameMode, GLboolean isMenu );
 void        fgSetWindow ( SFG_Window *window );
+void        fgRestoreWindow ( SFG_Window *window );
 void        fgOpenWindow( SFG_Window* window, const char* title,
                           GLboolean positionUse, int x, int y,
                           GLboolean sizeUse, int w, int h,
@@ -1075,6 +1329,35 @@ void        fgAddToWindowDestroyList ( SFG_Window* window );
 void        fgCloseWindows ();
 void        fgDestroyWindow( SFG_Window* window );
 
+/*
+ * Adds work to a window's WorkMask and queues the window for the main
+ * loop. Defined in fg_main.c
+ */
+void        fgPostWork( SFG_Window* window, unsigned int workMask );
+void        fgRemoveWork( SFG_Window* window );
+
+/*
+ * Releases the buffer objects cached for the shapes drawn in a window,
+ * whose context must be current. Defined in fg_geometry.c
+ */
+void        fgFreeGeometryBuffers( SFG_Window* window );
+
+/* Likewise for the glyph textures and the text stream buffer, in fg_font.c */
+void        fgFreeFontAtlases( SFG_Window* window );
+
+/* Releases the generated meshes of the round shapes, in fg_geometry.c */
+void        fgFreeGeometryMeshes( void );
+
+/* Likewise for the pinned teapot, teacup and teaspoon meshes, in fg_teapot.c */
+void        fgFreeTeasetMeshes( void );
+
+/* Releases the flattened stroke fonts and prepared strings, in fg_font.c */
+void        fgFreeStrokeFontLines( void );
+void        fgFreePreparedStrings( void );
+
+/* Releases a menu's compiled display lists, in fg_menu.c */
+void        fgFreeMenuDisplayLists( SFG_Menu* menu );
+
 /* Menu creation and destruction. Defined in fg_structure.c */
 SFG_Menu*   fgCreateMenu( FGCBMenuUC menuCallback, FGCBUserData userData );
 void        fgDestroyMenu( SFG_Menu* menu );
@@ -1166,6 +1449,20 @@ fg_time_t fgElapsedTime( void );
 /* System time in milliseconds */
 fg_time_t fgSystemTime(void);
 
+/* Monotonic time in nanoseconds */
+fg_time_t fgSystemTimeNs(void);
+
+/* Elapsed time in nanoseconds as per glutGet64(GLUT_ELAPSED_TIME_NS). */
+fg_time_t fgElapsedTimeNs( void );
+
+/* Input event coalescing, see GLUT_COALESCE_EVENTS */
+void fgCoalesceEvent( SFG_Window *window, int type, int device, int x, int y, int z );
+void fgFlushCoalescedEvents( void );
+
+/* Frame statistics, time a phase of the current frame */
+void fgFrameStatsBegin( SFG_PhaseTimer *timer );
+void fgFrameStatsEnd( SFG_PhaseTimer *timer, int phase );
+
 /* List functions */
 void fgListInit(SFG_List *list);
 void fgListAppend(SFG_List *list, SFG_Node *node);
@@ -1173,6 +1470,17 @@ void fgListRemove(SFG_List *list, SFG_Node *node);
 int fgListLength(SFG_List *list);
 void fgListInsert(SFG_List *list, SFG_Node *next, SFG_Node *node);
 
+/* Timer queue functions */
+void fgTimerQueuePush(SFG_TimerQueue *queue, SFG_Timer *timer);
+SFG_Timer *fgTimerQueueRemove(SFG_TimerQueue *queue, int index);
+void fgTimerQueueFree(SFG_TimerQueue *queue);
+
+/* Hash map functions, values must not be NULL */
+void *fgHashFind(const SFG_HashMap *map, size_t key);
+void fgHashInsert(SFG_HashMap *map, size_t key, void *value);
+void fgHashRemove(SFG_HashMap *map, size_t key, void *value);
+void fgHashFree(SFG_HashMap *map);
+
 /* Error Message functions */
 void fgError( const char *fmt, ... );
 void fgWarning( const char *fmt, ... );
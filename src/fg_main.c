@@ -47,7 +47,8 @@
 
 extern void fgProcessWork   ( SFG_Window *window );
 extern fg_time_t fgPlatformSystemTime ( void );
-extern void fgPlatformSleepForEvents( fg_time_t msec );
+extern fg_time_t fgPlatformSystemTimeNs ( void );
+extern void fgPlatformSleepForEvents( fg_time_t nsec );
 extern void fgPlatformProcessSingleEvent ( void );
 extern void fgPlatformMainLoopPreliminaryWork ( void );
 
@@ -85,7 +86,7 @@ void fghOnReshapeNotify(SFG_Window *window, int width, int height, GLboolean for
          * window.
          * DN: Hmm.. the above sounds like a concern only in single buffered mode...
          */
-        window->State.WorkMask |= GLUT_DISPLAY_WORK;
+        fgPostWork( window, GLUT_DISPLAY_WORK );
         if( window->IsMenu )
             fgSetWindow( saved_window );
     }
@@ -132,7 +133,7 @@ void fghRedrawWindow ( SFG_Window *window )
     fgSetWindow( window );
     INVOKE_WCB( *window, Display, ( ) );
 
-    fgSetWindow( current_window );
+    fgRestoreWindow( current_window );
 }
 
 void fghRedrawWindowAndChildren ( SFG_Window *window )
@@ -150,26 +151,86 @@ void fghRedrawWindowAndChildren ( SFG_Window *window )
 }
 
 
-static void fghcbProcessWork( SFG_Window *window,
-                              SFG_Enumerator *enumerator )
+/*
+ * Adds work to a window's work list. Windows with work are kept in
+ * fgStructure.WorkQueue, so the main loop only has to look at those
+ */
+void fgPostWork( SFG_Window *window, unsigned int workMask )
 {
-    if( window->State.WorkMask )
-        fgProcessWork ( window );
+    window->State.WorkMask |= workMask;
 
-    fgEnumSubWindows( window, fghcbProcessWork, enumerator );
+    if( !window->WorkNode.Queue )
+    {
+        fgListAppend( &fgStructure.WorkQueue, &window->WorkNode.Node );
+        window->WorkNode.Queue = &fgStructure.WorkQueue;
+    }
+}
+
+/* Takes a window out of the work queue, when it gets destroyed */
+void fgRemoveWork( SFG_Window *window )
+{
+    if( window->WorkNode.Queue )
+    {
+        fgListRemove( window->WorkNode.Queue, &window->WorkNode.Node );
+        window->WorkNode.Queue = NULL;
+    }
+}
+
+/* Keeps a window's work for the next fghProcessWork */
+static void fghDeferWork( SFG_Window *window )
+{
+    fgListAppend( &fgStructure.WorkDeferred, &window->WorkNode.Node );
+    window->WorkNode.Queue = &fgStructure.WorkDeferred;
 }
 
 /*
- * Make all windows process their work list
+ * Processes a queued window's work, after that of its parent if that is
+ * queued too: parents go before their children, as they did when all the
+ * windows were walked.
  */
-static void fghProcessWork( void )
+static void fghProcessQueuedWork( SFG_Window *window )
 {
-    SFG_Enumerator enumerator;
+    if( window->Parent &&
+        window->Parent->WorkNode.Queue == &fgStructure.WorkQueue )
+        fghProcessQueuedWork( window->Parent );
 
-    enumerator.found = GL_FALSE;
-    enumerator.data  =  NULL;
+    fgRemoveWork( window );
+
+    /* A window gets one turn per pass, work it posts after that waits */
+    if( window->WorkNode.Pass == fgStructure.WorkPass )
+    {
+        fghDeferWork( window );
+        return;
+    }
+    window->WorkNode.Pass = fgStructure.WorkPass;
+
+    fgProcessWork( window );
 
-    fgEnumWindows( fghcbProcessWork, &enumerator );
+    /* E.g. display work for a hidden window stays pending */
+    if( window->State.WorkMask && !window->WorkNode.Queue )
+        fghDeferWork( window );
+}
+
+/*
+ * Make all windows process their work list. Work posted meanwhile for
+ * windows that haven't had their turn yet, such as children getting
+ * reshaped by their parent, is processed in the same pass. Windows
+ * destroyed meanwhile remove themselves from the queue.
+ */
+static void fghProcessWork( void )
+{
+    SFG_WorkNode *node;
+
+    fgStructure.WorkPass++;
+    while( ( node = ( SFG_WorkNode * )fgStructure.WorkQueue.First ) )
+        fghProcessQueuedWork( node->Window );
+
+    /* Hand what was put off back to the queue */
+    fgStructure.WorkQueue = fgStructure.WorkDeferred;
+    fgListInit( &fgStructure.WorkDeferred );
+    for( node = ( SFG_WorkNode * )fgStructure.WorkQueue.First; node;
+         node = ( SFG_WorkNode * )node->Node.Next )
+        node->Queue = &fgStructure.WorkQueue;
 }
 
 /*
@@ -220,19 +281,23 @@ static void fghCheckJoystickPolls( void )
  */
 static void fghCheckTimers( void )
 {
-    fg_time_t checkTime = fgElapsedTime( );
+    fg_time_t checkTime = fgElapsedTimeNs( );
 
-    while( fgState.Timers.First )
+    while( fgState.Timers.Count )
     {
-        SFG_Timer *timer = fgState.Timers.First;
+        SFG_Timer *timer = fgState.Timers.Heap[ 0 ];
 
         if( timer->TriggerTime > checkTime )
-            /* Timers are sorted by triggerTime */
+            /* The heap's top is the earliest timer */
             break;
 
-        fgListRemove( &fgState.Timers, &timer->Node );
+        fgTimerQueueRemove( &fgState.Timers, 0 );
         fgListAppend( &fgState.FreeTimers, &timer->Node );
 
+        /* Timer callbacks draw into the current window, see fgRestoreWindow */
+        if( fgState.DeferContextRestore && fgStructure.CurrentWindow )
+            fgSetWindow( fgStructure.CurrentWindow );
+
         timer->Callback( timer->ID, timer->CallbackData );
     }
 }
@@ -257,6 +322,171 @@ fg_time_t fgElapsedTime( void )
     return fgSystemTime() - fgState.Time;
 }
 
+/* Platform-dependent monotonic time in nanoseconds. This is the timebase
+ * of the timers, so they can be scheduled at sub-millisecond precision.
+ */
+fg_time_t fgSystemTimeNs(void)
+{
+    return fgPlatformSystemTimeNs();
+}
+
+/*
+ * Elapsed Time, in nanoseconds
+ */
+fg_time_t fgElapsedTimeNs( void )
+{
+    return fgSystemTimeNs() - fgState.TimeNs;
+}
+
+/*
+ * Input event coalescing: with GLUT_COALESCE_EVENTS on, the backends hand
+ * motion-like events to fgCoalesceEvent, which keeps only the latest one
+ * per window, type and device until the pending events get flushed.
+ */
+static void fghDispatchCoalescableEvent( SFG_CoalescedEvent *event )
+{
+    SFG_Window *window = event->Window;
+    int modifiers = fgState.Modifiers;
+
+    fgState.Modifiers = event->Modifiers;
+
+    switch( event->Type )
+    {
+    case FG_EVENT_MOTION:
+        INVOKE_WCB( *window, Motion, ( event->Args[ 0 ], event->Args[ 1 ] ) );
+        break;
+    case FG_EVENT_PASSIVE:
+        INVOKE_WCB( *window, Passive, ( event->Args[ 0 ], event->Args[ 1 ] ) );
+        break;
+    case FG_EVENT_MULTI_MOTION:
+        INVOKE_WCB( *window, MultiMotion, ( event->Device, event->Args[ 0 ], event->Args[ 1 ] ) );
+        break;
+    case FG_EVENT_MULTI_PASSIVE:
+        INVOKE_WCB( *window, MultiPassive, ( event->Device, event->Args[ 0 ], event->Args[ 1 ] ) );
+        break;
+    case FG_EVENT_SPACE_MOTION:
+        INVOKE_WCB( *window, SpaceMotion, ( event->Args[ 0 ], event->Args[ 1 ], event->Args[ 2 ] ) );
+        break;
+    case FG_EVENT_SPACE_ROTATION:
+        INVOKE_WCB( *window, SpaceRotation, ( event->Args[ 0 ], event->Args[ 1 ], event->Args[ 2 ] ) );
+        break;
+    }
+
+    fgState.Modifiers = modifiers;
+}
+
+void fgCoalesceEvent( SFG_Window *window, int type, int device, int x, int y, int z )
+{
+    SFG_PendingEvents *pending = &fgState.PendingEvents;
+    SFG_CoalescedEvent immediate, *event = NULL;
+    int i;
+
+    if( !pending->Enabled )
+        event = &immediate;
+    else
+    {
+        /* Replace a pending event of the same kind, else queue a new one */
+        for( i = 0; i < pending->Count && !event; i++ )
+            if( pending->Events[ i ].Window == window &&
+                pending->Events[ i ].Type   == type   &&
+                pending->Events[ i ].Device == device )
+            {
+                event = &pending->Events[ i ];
+                pending->NumCoalesced++;
+            }
+
+        if( !event )
+        {
+            if( pending->Count == FG_COALESCED_EVENTS_MAX )
+                fgFlushCoalescedEvents( );
+            event = &pending->Events[ pending->Count++ ];
+        }
+    }
+
+    event->Type      = type;
+    event->Window    = window;
+    event->Device    = device;
+    event->Args[ 0 ] = x;
+    event->Args[ 1 ] = y;
+    event->Args[ 2 ] = z;
+    event->Modifiers = fgState.Modifiers;
+
+    if( event == &immediate )
+        fghDispatchCoalescableEvent( event );
+}
+
+/* Delivers the pending coalesced events, oldest first */
+void fgFlushCoalescedEvents( void )
+{
+    SFG_CoalescedEvent events[ FG_COALESCED_EVENTS_MAX ];
+    int i, count = fgState.PendingEvents.Count;
+
+    /* Empty the queue first, the callbacks go through INVOKE_WCB again */
+    memcpy( events, fgState.PendingEvents.Events, count * sizeof( events[ 0 ] ) );
+    fgState.PendingEvents.Count = 0;
+
+    for( i = 0; i < count; i++ )
+        fghDispatchCoalescableEvent( &events[ i ] );
+}
+
+/*
+ * Frame statistics: the phases of a frame (one glutMainLoopEvent) are
+ * timed by a fgFrameStatsBegin / fgFrameStatsEnd pair, which does nothing
+ * unless GLUT_FRAME_STATS is enabled. Time recorded for phases that ran in
+ * between (nested ones) is subtracted, so each phase only gets its own.
+ */
+void fgFrameStatsBegin( SFG_PhaseTimer *timer )
+{
+    if( !fgState.FrameStats.Enabled )
+    {
+        timer->Start = 0;
+        return;
+    }
+
+    timer->Recorded = fgState.FrameStats.Recorded;
+    timer->Start    = fgSystemTimeNs( );
+}
+
+void fgFrameStatsEnd( SFG_PhaseTimer *timer, int phase )
+{
+    fg_time_t elapsed;
+
+    /* Also skip if the statistics were switched on or off meanwhile */
+    if( !timer->Start || !fgState.FrameStats.Enabled ||
+        fgState.FrameStats.Recorded < timer->Recorded )
+        return;
+
+    elapsed = fgSystemTimeNs( ) - timer->Start;
+    elapsed -= MIN( elapsed, fgState.FrameStats.Recorded - timer->Recorded );
+
+    fgState.FrameStats.Phases[ phase ] += elapsed;
+    fgState.FrameStats.Recorded        += elapsed;
+}
+
+/* Store the current frame's timings in the ring buffer and start a new frame */
+static void fghFrameStatsEndFrame( SFG_PhaseTimer *frameTimer )
+{
+    SFG_FrameStats *stats = &fgState.FrameStats;
+    unsigned int *frame;
+    int i;
+
+    if( !frameTimer->Start || !stats->Enabled )
+        return;
+
+    stats->Phases[ GLUT_FRAME_PHASE_TOTAL ] = fgSystemTimeNs( ) - frameTimer->Start;
+
+    frame = stats->Frames[ stats->NextFrame ];
+    for( i = 0; i < FG_FRAME_STATS_PHASES; i++ )
+        frame[ i ] = (unsigned int)( stats->Phases[ i ] / 1000 );
+
+    stats->NextFrame = ( stats->NextFrame + 1 ) % FG_FRAME_STATS_FRAMES;
+    if( stats->NumFrames < FG_FRAME_STATS_FRAMES )
+        stats->NumFrames++;
+
+    memset( stats->Phases, 0, sizeof( stats->Phases ) );
+    stats->Recorded = 0;
+}
+
 /*
  * Error Messages.
  */
@@ -324,42 +554,26 @@ void fgWarning( const char *fmt, ... )
 
 /*
  * Indicates whether work is pending for ANY window.
- *
- * The current mechanism is to walk all of the windows and ask if
- * work is pending. We have a short-circuit early return if we find any.
  */
-static void fghHavePendingWorkCallback( SFG_Window* w, SFG_Enumerator* e)
-{
-    if( w->State.WorkMask )
-    {
-        e->found = GL_TRUE;
-        e->data = w;
-        return;
-    }
-    fgEnumSubWindows( w, fghHavePendingWorkCallback, e );
-}
 static int fghHavePendingWork (void)
 {
-    SFG_Enumerator enumerator;
-
-    enumerator.found = GL_FALSE;
-    enumerator.data = NULL;
-    fgEnumWindows( fghHavePendingWorkCallback, &enumerator );
-    return !!enumerator.data;
+    return fgStructure.WorkQueue.First != NULL;
 }
 
 /*
- * Returns the number of GLUT ticks (milliseconds) till the next timer event.
+ * Returns the number of nanoseconds till the next timer event.
  */
 static fg_time_t fghNextTimer( void )
 {
     fg_time_t currentTime;
-    SFG_Timer *timer = fgState.Timers.First;    /* timers are sorted by trigger time, so only have to check the first */
+    SFG_Timer *timer;
 
-    if( !timer )
-        return INT_MAX;
+    if( !fgState.Timers.Count )
+        return (fg_time_t)INT_MAX * 1000000;
 
-    currentTime = fgElapsedTime();
+    timer = fgState.Timers.Heap[ 0 ];   /* the heap's top is the earliest timer, so only have to check it */
+
+    currentTime = fgElapsedTimeNs();
     if( timer->TriggerTime < currentTime )
         return 0;
     else
@@ -368,18 +582,18 @@ static fg_time_t fghNextTimer( void )
 
 static void fghSleepForEvents( void )
 {
-    fg_time_t msec;
+    fg_time_t nsec;
 
     if( fghHavePendingWork( ) )
         return;
 
-    msec = fghNextTimer( );
+    nsec = fghNextTimer( );
     /* XXX Should use GLUT timers for joysticks... */
     /* XXX Dumb; forces granularity to .01sec */
-    if( fgState.NumActiveJoysticks>0 && ( msec > 10 ) )
-        msec = 10;
+    if( fgState.NumActiveJoysticks>0 && ( nsec > 10000000 ) )
+        nsec = 10000000;
 
-    fgPlatformSleepForEvents ( msec );
+    fgPlatformSleepForEvents ( nsec );
 }
 
 
@@ -445,16 +659,33 @@ void fgProcessWork(SFG_Window *window)
  */
 void FGAPIENTRY glutMainLoopEvent( void )
 {
+    SFG_PhaseTimer frameTimer, timer;
+
+    fgFrameStatsBegin( &frameTimer );
+
     /* Process input */
+    fgFrameStatsBegin( &timer );
     fgPlatformProcessSingleEvent ();
+    fgFlushCoalescedEvents( );
+    fgFrameStatsEnd( &timer, GLUT_FRAME_PHASE_EVENTS );
 
-    if( fgState.Timers.First )
+    if( fgState.Timers.Count )
+    {
+        fgFrameStatsBegin( &timer );
         fghCheckTimers( );
+        fgFrameStatsEnd( &timer, GLUT_FRAME_PHASE_TIMERS );
+    }
     if (fgState.NumActiveJoysticks>0)   /* If zero, don't poll joysticks */
+    {
+        fgFrameStatsBegin( &timer );
         fghCheckJoystickPolls( );
+        fgFrameStatsEnd( &timer, GLUT_FRAME_PHASE_JOYSTICK );
+    }
 
     /* Perform work on the window (position, reshape, display, etc) */
+    fgFrameStatsBegin( &timer );
     fghProcessWork( );
+    fgFrameStatsEnd( &timer, GLUT_FRAME_PHASE_DISPLAY );
 
     /* Check OpenGL error state if requested.
      * Don't call if no more open windows (can happen if user closes window from
@@ -464,6 +695,8 @@ void FGAPIENTRY glutMainLoopEvent( void )
         glutReportErrors( );
 
     fgCloseWindows( );
+
+    fghFrameStatsEndFrame( &frameTimer );
 }
 
 /*
@@ -489,17 +722,9 @@ void FGAPIENTRY glutMainLoop( void )
         glutMainLoopEvent( );
         if( fgState.ExecState != GLUT_EXEC_STATE_RUNNING )
             break;
-        /*
-         * Step through the list of windows, seeing if there are any
-         * that are not menus
-         */
-        for( window = ( SFG_Window * )fgStructure.Windows.First;
-             window;
-             window = ( SFG_Window * )window->Node.Next )
-            if ( ! ( window->IsMenu ) )
-                break;
 
-        if( ! window )
+        /* Stop once there are no windows left that are not menus */
+        if( ! fgStructure.NumWindows )
             fgState.ExecState = GLUT_EXEC_STATE_STOP;
         else
         {
@@ -507,8 +732,17 @@ void FGAPIENTRY glutMainLoop( void )
             {
                 if( fgStructure.CurrentWindow &&
                     fgStructure.CurrentWindow->IsMenu )
-                    /* fail safe */
+                {
+                    /* fail safe: switch to the first window that is not a menu */
+                    for( window = ( SFG_Window * )fgStructure.Windows.First;
+                         window && window->IsMenu;
+                         window = ( SFG_Window * )window->Node.Next )
+                        ;
                     fgSetWindow( window );
+                }
+                else if( fgState.DeferContextRestore && fgStructure.CurrentWindow )
+                    /* see fgRestoreWindow */
+                    fgSetWindow( fgStructure.CurrentWindow );
                 fgState.IdleCallback( fgState.IdleCallbackData );
             }
             else
@@ -537,6 +771,30 @@ void FGAPIENTRY glutLeaveMainLoop( void )
     fgState.ExecState = GLUT_EXEC_STATE_STOP ;
 }
 
+/*
+ * Copies the timings of the most recent frames, oldest first, see
+ * GLUT_FRAME_STATS. Returns the number of frames copied.
+ */
+int FGAPIENTRY glutGetFrameStats( unsigned int *usec, int maxFrames )
+{
+    SFG_FrameStats *stats = &fgState.FrameStats;
+    int numFrames, first, i;
+
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutGetFrameStats" );
+
+    if( !usec || maxFrames <= 0 )
+        return 0;
+
+    numFrames = MIN( maxFrames, stats->NumFrames );
+    first = stats->NextFrame - numFrames + FG_FRAME_STATS_FRAMES;
+    for( i = 0; i < numFrames; i++ )
+        memcpy( usec + i * GLUT_FRAME_NUM_PHASES,
+                stats->Frames[ ( first + i ) % FG_FRAME_STATS_FRAMES ],
+                sizeof( stats->Frames[ 0 ] ) );
+
+    return numFrames;
+}
+
 
 
 /*** END OF FILE ***/
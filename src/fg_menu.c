@@ -207,7 +207,7 @@ static GLboolean fghCheckMenuStatus( SFG_Menu* menu )
 
         if( menuEntry != menu->ActiveEntry )
         {
-            menu->Window->State.WorkMask |= GLUT_DISPLAY_WORK;
+            fgPostWork( menu->Window, GLUT_DISPLAY_WORK );
             if( menu->ActiveEntry )
                 menu->ActiveEntry->IsActive = GL_FALSE;
         }
@@ -277,7 +277,7 @@ static GLboolean fghCheckMenuStatus( SFG_Menu* menu )
         ( !menu->ActiveEntry->SubMenu ||
           !menu->ActiveEntry->SubMenu->IsActive ) )
     {
-        menu->Window->State.WorkMask |= GLUT_DISPLAY_WORK;
+        fgPostWork( menu->Window, GLUT_DISPLAY_WORK );
         menu->ActiveEntry->IsActive = GL_FALSE;
         menu->ActiveEntry = NULL;
     }
@@ -286,12 +286,10 @@ static GLboolean fghCheckMenuStatus( SFG_Menu* menu )
 }
 
 /*
- * Displays a menu box and all of its submenus (if they are active)
+ * Draws the menu box's border and background
  */
-static void fghDisplayMenuBox( SFG_Menu* menu )
+static void fghDrawMenuFrame( SFG_Menu* menu )
 {
-    SFG_MenuEntry *menuEntry;
-    int i;
     int border = FREEGLUT_MENU_BORDER;
 
     /*
@@ -327,79 +325,142 @@ static void fghDisplayMenuBox( SFG_Menu* menu )
         glVertex2i( menu->Width - border, menu->Height - border);
         glVertex2i(               border, menu->Height - border);
     glEnd( );
+}
 
-    /* Check if any of the submenus is currently active... */
-    for( menuEntry = (SFG_MenuEntry *)menu->Entries.First;
-         menuEntry;
-         menuEntry = (SFG_MenuEntry *)menuEntry->Node.Next )
+/*
+ * Draws the i-th entry of a menu, highlighted or not
+ */
+static void fghDrawMenuEntry( SFG_Menu* menu, SFG_MenuEntry* menuEntry, int i,
+                              GLboolean highlighted )
+{
+    int border = FREEGLUT_MENU_BORDER;
+
+    if( highlighted )
     {
-        /* Has the menu been marked as active, maybe? */
-        if( menuEntry->IsActive )
-        {
-            /*
-             * That's truly right, and we need to have it highlighted.
-             * There is an assumption that mouse cursor didn't move
-             * since the last check of menu activity state:
-             */
-            int menuID = menuEntry->Ordinal;
-
-            /* So have the highlight drawn... */
-            glColor4fv( menu_pen_hback );
-            glBegin( GL_QUADS );
-                glVertex2i( border,
-                            (menuID + 0)*FREEGLUT_MENUENTRY_HEIGHT(menu->Font) + border );
-                glVertex2i( menu->Width - border,
-                            (menuID + 0)*FREEGLUT_MENUENTRY_HEIGHT(menu->Font) + border );
-                glVertex2i( menu->Width - border,
-                            (menuID + 1)*FREEGLUT_MENUENTRY_HEIGHT(menu->Font) + border );
-                glVertex2i( border,
-                            (menuID + 1)*FREEGLUT_MENUENTRY_HEIGHT(menu->Font) + border );
-            glEnd( );
-        }
+        /* So have the highlight drawn... */
+        glColor4fv( menu_pen_hback );
+        glBegin( GL_QUADS );
+            glVertex2i( border,
+                        (i + 0)*FREEGLUT_MENUENTRY_HEIGHT(menu->Font) + border );
+            glVertex2i( menu->Width - border,
+                        (i + 0)*FREEGLUT_MENUENTRY_HEIGHT(menu->Font) + border );
+            glVertex2i( menu->Width - border,
+                        (i + 1)*FREEGLUT_MENUENTRY_HEIGHT(menu->Font) + border );
+            glVertex2i( border,
+                        (i + 1)*FREEGLUT_MENUENTRY_HEIGHT(menu->Font) + border );
+        glEnd( );
     }
 
-    /* Print the menu entries now... */
+    /* If the menu entry is active, set the color to white */
+    glColor4fv( highlighted ? menu_pen_hfore : menu_pen_fore );
+
+    /* Move the raster into position... */
+    /* Try to center the text - JCJ 31 July 2003*/
+    glRasterPos2i(
+        2 * border,
+        ( i + 1 )*FREEGLUT_MENUENTRY_HEIGHT(menu->Font) -
+        ( int )( FREEGLUT_MENUENTRY_HEIGHT(menu->Font)*0.3 - border )
+    );
 
-    glColor4fv( menu_pen_fore );
+    /* Have the label drawn, character after character: */
+    glutBitmapString( menu->Font,
+                      (unsigned char *)menuEntry->Text);
+
+    /* If it's a submenu, draw a right arrow */
+    if( menuEntry->SubMenu )
+    {
+        int width = glutBitmapWidth( menu->Font, '_' );
+        int x_base = menu->Width - 2 - width;
+        int y_base = i*FREEGLUT_MENUENTRY_HEIGHT(menu->Font) + border;
+        glBegin( GL_TRIANGLES );
+            glVertex2i( x_base, y_base + 2*border);
+            glVertex2i( menu->Width - 2, y_base +
+                        ( FREEGLUT_MENUENTRY_HEIGHT(menu->Font) + border) / 2 );
+            glVertex2i( x_base, y_base + FREEGLUT_MENUENTRY_HEIGHT(menu->Font) - border );
+        glEnd( );
+    }
+}
+
+/*
+ * Compiles the menu box with all entries drawn normally into one display
+ * list, followed by one list per entry drawing it highlighted, so that a
+ * highlight change only replays them instead of rebuilding the whole box.
+ * The lists are recompiled when the entries or the font have changed, see
+ * fghCalculateMenuBoxSize. Returns GL_FALSE if no lists could be created.
+ */
+static GLboolean fghCompileMenuBox( SFG_Menu* menu )
+{
+    SFG_MenuEntry *menuEntry;
+    int i;
+
+    if( menu->DisplayLists && !menu->DisplayListsStale )
+        return GL_TRUE;
+
+    fgFreeMenuDisplayLists( menu );
+
+    menu->NumDisplayLists = 1 + fgListLength( &menu->Entries );
+    menu->DisplayLists = glGenLists( menu->NumDisplayLists );
+    if( !menu->DisplayLists )
+        return GL_FALSE;
+
+    glNewList( menu->DisplayLists, GL_COMPILE );
+    fghDrawMenuFrame( menu );
+    for( menuEntry = (SFG_MenuEntry *)menu->Entries.First, i = 0;
+         menuEntry;
+         menuEntry = (SFG_MenuEntry *)menuEntry->Node.Next, ++i )
+        fghDrawMenuEntry( menu, menuEntry, i, GL_FALSE );
+    glEndList( );
 
     for( menuEntry = (SFG_MenuEntry *)menu->Entries.First, i = 0;
          menuEntry;
          menuEntry = (SFG_MenuEntry *)menuEntry->Node.Next, ++i )
     {
-        /* If the menu entry is active, set the color to white */
-        if( menuEntry->IsActive )
-            glColor4fv( menu_pen_hfore );
-
-        /* Move the raster into position... */
-        /* Try to center the text - JCJ 31 July 2003*/
-        glRasterPos2i(
-            2 * border,
-            ( i + 1 )*FREEGLUT_MENUENTRY_HEIGHT(menu->Font) -
-            ( int )( FREEGLUT_MENUENTRY_HEIGHT(menu->Font)*0.3 - border )
-        );
-
-        /* Have the label drawn, character after character: */
-        glutBitmapString( menu->Font,
-                          (unsigned char *)menuEntry->Text);
-
-        /* If it's a submenu, draw a right arrow */
-        if( menuEntry->SubMenu )
-        {
-            int width = glutBitmapWidth( menu->Font, '_' );
-            int x_base = menu->Width - 2 - width;
-            int y_base = i*FREEGLUT_MENUENTRY_HEIGHT(menu->Font) + border;
-            glBegin( GL_TRIANGLES );
-                glVertex2i( x_base, y_base + 2*border);
-                glVertex2i( menu->Width - 2, y_base +
-                            ( FREEGLUT_MENUENTRY_HEIGHT(menu->Font) + border) / 2 );
-                glVertex2i( x_base, y_base + FREEGLUT_MENUENTRY_HEIGHT(menu->Font) - border );
-            glEnd( );
-        }
+        glNewList( menu->DisplayLists + 1 + i, GL_COMPILE );
+        fghDrawMenuEntry( menu, menuEntry, i, GL_TRUE );
+        glEndList( );
+    }
+
+    menu->DisplayListsStale = GL_FALSE;
+    return GL_TRUE;
+}
+
+void fgFreeMenuDisplayLists( SFG_Menu* menu )
+{
+    if( menu->DisplayLists )
+        glDeleteLists( menu->DisplayLists, menu->NumDisplayLists );
+    menu->DisplayLists = 0;
+    menu->NumDisplayLists = 0;
+}
+
+/*
+ * Displays a menu box and all of its submenus (if they are active)
+ */
+static void fghDisplayMenuBox( SFG_Menu* menu )
+{
+    SFG_MenuEntry *menuEntry;
+    int i;
+
+    if( fghCompileMenuBox( menu ) )
+    {
+        glCallList( menu->DisplayLists );
 
-        /* If the menu entry is active, reset the color */
-        if( menuEntry->IsActive )
-            glColor4fv( menu_pen_fore );
+        /* Draw the active entries over their normal look */
+        for( menuEntry = (SFG_MenuEntry *)menu->Entries.First, i = 0;
+             menuEntry;
+             menuEntry = (SFG_MenuEntry *)menuEntry->Node.Next, ++i )
+            if( menuEntry->IsActive )
+                glCallList( menu->DisplayLists + 1 + i );
+
+        return;
     }
+
+    fghDrawMenuFrame( menu );
+
+    /* Print the menu entries now... */
+    for( menuEntry = (SFG_MenuEntry *)menu->Entries.First, i = 0;
+         menuEntry;
+         menuEntry = (SFG_MenuEntry *)menuEntry->Node.Next, ++i )
+        fghDrawMenuEntry( menu, menuEntry, i, menuEntry->IsActive );
 }
 
 /*
@@ -427,6 +488,7 @@ void fgDisplayMenu( void )
 {
     SFG_Window* window = fgStructure.CurrentWindow;
     SFG_Menu* menu = NULL;
+    SFG_PhaseTimer timer;
 
     FREEGLUT_INTERNAL_ERROR_EXIT ( fgStructure.CurrentWindow, "Displaying menu in nonexistent window",
                                    "fgDisplayMenu" );
@@ -435,6 +497,8 @@ void fgDisplayMenu( void )
     menu = window->ActiveMenu;
     freeglut_return_if_fail( menu );
 
+    fgFrameStatsBegin( &timer );
+
     fgSetWindow( menu->Window );
 
     glPushAttrib( GL_DEPTH_BUFFER_BIT | GL_TEXTURE_BIT | GL_LIGHTING_BIT |
@@ -469,7 +533,9 @@ void fgDisplayMenu( void )
 
     glutSwapBuffers( );
 
-    fgSetWindow ( window );
+    fgRestoreWindow ( window );
+
+    fgFrameStatsEnd( &timer, GLUT_FRAME_PHASE_MENU );
 }
 
 /*
@@ -746,22 +812,28 @@ void fghCalculateMenuBoxSize( void )
          menuEntry;
          menuEntry = ( SFG_MenuEntry * )menuEntry->Node.Next )
     {
-        /* Update the menu entry's width value */
-        menuEntry->Width = glutBitmapLength(
-            fgStructure.CurrentMenu->Font,
-            (unsigned char *)menuEntry->Text
-        );
-
         /*
-         * If the entry is a submenu, then it needs to be wider to
-         * accommodate the arrow.
+         * Measure the entries that are new or changed (Width is -1),
+         * the others keep their width until the font changes.
          */
-        if (menuEntry->SubMenu)
-            menuEntry->Width += glutBitmapLength(
+        if( menuEntry->Width < 0 )
+        {
+            menuEntry->Width = glutBitmapLength(
                 fgStructure.CurrentMenu->Font,
-                (unsigned char *)"_"
+                (unsigned char *)menuEntry->Text
             );
 
+            /*
+             * If the entry is a submenu, then it needs to be wider to
+             * accommodate the arrow.
+             */
+            if (menuEntry->SubMenu)
+                menuEntry->Width += glutBitmapLength(
+                    fgStructure.CurrentMenu->Font,
+                    (unsigned char *)"_"
+                );
+        }
+
         /* Check if it's the biggest we've found */
         if( menuEntry->Width > width )
             width = menuEntry->Width;
@@ -772,6 +844,9 @@ void fghCalculateMenuBoxSize( void )
     /* Store the menu's box size now: */
     fgStructure.CurrentMenu->Height = height + 2 * FREEGLUT_MENU_BORDER;
     fgStructure.CurrentMenu->Width  = width  + 4 * FREEGLUT_MENU_BORDER;
+
+    /* And have the menu recompiled when it is displayed next */
+    fgStructure.CurrentMenu->DisplayListsStale = GL_TRUE;
 }
 
 
@@ -872,6 +947,7 @@ void FGAPIENTRY glutAddMenuEntry( const char* label, int value )
     menuEntry = (SFG_MenuEntry *)calloc( sizeof(SFG_MenuEntry), 1 );
     menuEntry->Text = strdup( label );
     menuEntry->ID   = value;
+    menuEntry->Width = -1;
 
     /* Have the new menu entry attached to the current menu */
     fgListAppend( &fgStructure.CurrentMenu->Entries, &menuEntry->Node );
@@ -900,6 +976,7 @@ void FGAPIENTRY glutAddSubMenu( const char *label, int subMenuID )
     menuEntry->Text    = strdup( label );
     menuEntry->SubMenu = subMenu;
     menuEntry->ID      = -1;
+    menuEntry->Width   = -1;
 
     fgListAppend( &fgStructure.CurrentMenu->Entries, &menuEntry->Node );
     fghCalculateMenuBoxSize( );
@@ -912,6 +989,7 @@ void FGAPIENTRY glutSetMenuFont( int menuID, void* fontID )
 {
     SFG_Font* font;
     SFG_Menu* menu;
+    SFG_MenuEntry* menuEntry;
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutSetMenuFont" );
     menu = fgMenuByID( menuID );
     freeglut_return_if_fail( menu );
@@ -927,6 +1005,10 @@ void FGAPIENTRY glutSetMenuFont( int menuID, void* fontID )
     }
 
     fgStructure.CurrentMenu->Font = fontID;
+    for( menuEntry = ( SFG_MenuEntry * )fgStructure.CurrentMenu->Entries.First;
+         menuEntry;
+         menuEntry = ( SFG_MenuEntry * )menuEntry->Node.Next )
+        menuEntry->Width = -1;
     fghCalculateMenuBoxSize( );
 }
 
@@ -955,6 +1037,7 @@ void FGAPIENTRY glutChangeToMenuEntry( int item, const char* label, int value )
     menuEntry->Text    = strdup( label );
     menuEntry->ID      = value;
     menuEntry->SubMenu = NULL;
+    menuEntry->Width   = -1;
     fghCalculateMenuBoxSize( );
 }
 
@@ -990,6 +1073,7 @@ void FGAPIENTRY glutChangeToSubMenu( int item, const char* label,
     menuEntry->Text    = strdup( label );
     menuEntry->SubMenu = subMenu;
     menuEntry->ID      = -1;
+    menuEntry->Width   = -1;
     fghCalculateMenuBoxSize( );
 }
 
@@ -26,6 +26,7 @@
  */
 
 #include <GL/freeglut.h>
+#include <stddef.h>
 #include "fg_internal.h"
 
 /*
@@ -42,6 +43,8 @@
  */
 
 extern int fgPlatformGlutGet ( GLenum eWhat );
+extern int fgPlatformGetSwapInterval( SFG_Window *window );
+extern int fgPlatformGetBufferAge( SFG_Window *window );
 extern int fgPlatformGlutDeviceGet ( GLenum eWhat );
 extern int *fgPlatformGlutGetModeValues(GLenum eWhat, int *size);
 extern SFG_Font* fghFontByID( void* font );
@@ -113,6 +116,17 @@ void FGAPIENTRY glutSetOption( GLenum eWhat, int value )
       fgState.SkipStaleMotion = !!value;
       break;
 
+    case GLUT_COALESCE_EVENTS:
+      fgFlushCoalescedEvents( );
+      fgState.PendingEvents.Enabled = !!value;
+      break;
+
+    case GLUT_DEFER_CONTEXT_RESTORE:
+      fgState.DeferContextRestore = !!value;
+      if( !fgState.DeferContextRestore && fgStructure.CurrentWindow )
+          fgSetWindow( fgStructure.CurrentWindow );
+      break;
+
     case GLUT_GEOMETRY_VISUALIZE_NORMALS:
       if( fgStructure.CurrentWindow != NULL )
         fgStructure.CurrentWindow->State.VisualizeNormals = !!value;
@@ -122,16 +136,108 @@ void FGAPIENTRY glutSetOption( GLenum eWhat, int value )
       fgState.StrokeFontDrawJoinDots = !!value;
       break;
 
+    case GLUT_BITMAP_FONT_ATLAS:
+      fgState.BitmapFontAtlas = !!value;
+      break;
+
+    case GLUT_WINDOW_GEOMETRY_SYNC:
+      fgState.SyncWindowGeometry = !!value;
+      break;
+
     case GLUT_ALLOW_NEGATIVE_WINDOW_POSITION:
       fgState.AllowNegativeWindowPosition = !!value;
       break;
 
+    case GLUT_GEOMETRY_BUFFER_CACHE_SIZE:
+      fgState.GeometryBufferCacheSize = value > 0 ? value : 0;
+      break;
+
+    case GLUT_GEOMETRY_MESH_CACHE_SIZE:
+      fgState.GeometryMeshCacheSize = value > 0 ? value : 0;
+      break;
+
+    case GLUT_FRAME_STATS:
+      if( !!value != fgState.FrameStats.Enabled )
+      {
+          /* Start over, also dropping a partially timed frame */
+          memset( &fgState.FrameStats, 0, sizeof( fgState.FrameStats ) );
+          fgState.FrameStats.Enabled = !!value;
+      }
+      break;
+
+    case GLUT_GEOMETRY_VERTEX_FORMAT:
+      if( value == GLUT_VERTEX_FORMAT_FLOAT || value == GLUT_VERTEX_FORMAT_PACKED )
+          fgState.GeometryVertexFormat = value;
+      else
+          fgWarning( "glutSetOption(): invalid GLUT_GEOMETRY_VERTEX_FORMAT %d", value );
+      break;
+
+    case GLUT_TEASET_SUBDIVISIONS:
+      fgState.TeasetSubdivisions = value > 0 ? value : 0;
+      break;
+
     default:
         fgWarning( "glutSetOption(): missing enum handle %d", eWhat );
         break;
     }
 }
 
+/*
+ * A window's framebuffer configuration doesn't change during its lifetime,
+ * yet asking the window system about it can be slow (e.g., GLX or EGL
+ * calls, or GL state queries). So each value is only asked for once per
+ * window, and kept in the window's Config. The values, in that order, with
+ * the glutGet query for them and their field in GLUTwindowConfig:
+ */
+static const struct
+{
+    GLenum Query;
+    size_t Offset;
+} fghWindowConfigFields[ FG_NUM_WINDOW_CONFIG_VALUES ] =
+{
+    { GLUT_WINDOW_RGBA,             offsetof( GLUTwindowConfig, rgba )           },
+    { GLUT_WINDOW_DOUBLEBUFFER,     offsetof( GLUTwindowConfig, doubleBuffer )   },
+    { GLUT_WINDOW_STEREO,           offsetof( GLUTwindowConfig, stereo )         },
+    { GLUT_WINDOW_SRGB,             offsetof( GLUTwindowConfig, srgb )           },
+    { GLUT_WINDOW_BUFFER_SIZE,      offsetof( GLUTwindowConfig, bufferSize )     },
+    { GLUT_WINDOW_RED_SIZE,         offsetof( GLUTwindowConfig, redSize )        },
+    { GLUT_WINDOW_GREEN_SIZE,       offsetof( GLUTwindowConfig, greenSize )      },
+    { GLUT_WINDOW_BLUE_SIZE,        offsetof( GLUTwindowConfig, blueSize )       },
+    { GLUT_WINDOW_ALPHA_SIZE,       offsetof( GLUTwindowConfig, alphaSize )      },
+    { GLUT_WINDOW_DEPTH_SIZE,       offsetof( GLUTwindowConfig, depthSize )      },
+    { GLUT_WINDOW_STENCIL_SIZE,     offsetof( GLUTwindowConfig, stencilSize )    },
+    { GLUT_WINDOW_ACCUM_RED_SIZE,   offsetof( GLUTwindowConfig, accumRedSize )   },
+    { GLUT_WINDOW_ACCUM_GREEN_SIZE, offsetof( GLUTwindowConfig, accumGreenSize ) },
+    { GLUT_WINDOW_ACCUM_BLUE_SIZE,  offsetof( GLUTwindowConfig, accumBlueSize )  },
+    { GLUT_WINDOW_ACCUM_ALPHA_SIZE, offsetof( GLUTwindowConfig, accumAlphaSize ) },
+    { GLUT_WINDOW_NUM_SAMPLES,      offsetof( GLUTwindowConfig, numSamples )     },
+    { GLUT_WINDOW_COLORMAP_SIZE,    offsetof( GLUTwindowConfig, colormapSize )   },
+    { GLUT_WINDOW_FORMAT_ID,        offsetof( GLUTwindowConfig, formatID )       }
+};
+
+/* Get value i of the window's framebuffer configuration, which has to be the current window */
+static int fghGetWindowConfigValue( SFG_Window *window, int i )
+{
+    if( !( window->Window.ConfigKnown & ( 1u << i ) ) )
+    {
+        window->Window.Config[ i ] = fgPlatformGlutGet( fghWindowConfigFields[ i ].Query );
+        window->Window.ConfigKnown |= 1u << i;
+    }
+
+    return window->Window.Config[ i ];
+}
+
+static int fghGetWindowConfig( SFG_Window *window, GLenum eWhat )
+{
+    int i;
+
+    for( i = 0; i < FG_NUM_WINDOW_CONFIG_VALUES; i++ )
+        if( fghWindowConfigFields[ i ].Query == eWhat )
+            return fghGetWindowConfigValue( window, i );
+
+    return fgPlatformGlutGet( eWhat );
+}
+
 /*
  * General settings query method
  */
@@ -145,8 +251,8 @@ int FGAPIENTRY glutGet( GLenum eWhat )
     /* Although internally the time store is 64bits wide, the return value
      * here still wraps every 49.7 days. Integer overflows cancel however
      * when subtracting an initial start time, unless the total time exceeds
-     * 32-bit, so you can still work with this.
-     * XXX: a glutGet64 to return the time might be an idea...
+     * 32-bit, so you can still work with this. Use glutGet64 for the
+     * full 64bit time.
      */
     case GLUT_ELAPSED_TIME:
         return (int) fgElapsedTime();
@@ -191,6 +297,17 @@ int FGAPIENTRY glutGet( GLenum eWhat )
             return 0;
         return fgStructure.CurrentWindow->State.Cursor;
 
+    case GLUT_WINDOW_SWAP_INTERVAL:
+        if( fgStructure.CurrentWindow == NULL )
+            return 0;
+        return fgPlatformGetSwapInterval( fgStructure.CurrentWindow );
+
+    case GLUT_WINDOW_BUFFER_AGE:
+        if( fgStructure.CurrentWindow == NULL ||
+            ! fgStructure.CurrentWindow->Window.DoubleBuffered )
+            return 0;
+        return fgPlatformGetBufferAge( fgStructure.CurrentWindow );
+
     case GLUT_MENU_NUM_ITEMS:
         if( fgStructure.CurrentMenu == NULL )
             return 0;
@@ -221,6 +338,15 @@ int FGAPIENTRY glutGet( GLenum eWhat )
     case GLUT_SKIP_STALE_MOTION_EVENTS:
       return fgState.SkipStaleMotion;
 
+    case GLUT_COALESCE_EVENTS:
+      return fgState.PendingEvents.Enabled;
+
+    case GLUT_COALESCED_EVENTS:
+      return fgState.PendingEvents.NumCoalesced;
+
+    case GLUT_DEFER_CONTEXT_RESTORE:
+      return fgState.DeferContextRestore;
+
     case GLUT_GEOMETRY_VISUALIZE_NORMALS:
       if( fgStructure.CurrentWindow == NULL )
         return GL_FALSE;
@@ -229,15 +355,83 @@ int FGAPIENTRY glutGet( GLenum eWhat )
     case GLUT_STROKE_FONT_DRAW_JOIN_DOTS:
         return fgState.StrokeFontDrawJoinDots;
 
+    case GLUT_BITMAP_FONT_ATLAS:
+        return fgState.BitmapFontAtlas;
+
+    case GLUT_WINDOW_GEOMETRY_SYNC:
+        return fgState.SyncWindowGeometry;
+
     case GLUT_ALLOW_NEGATIVE_WINDOW_POSITION:
         return fgState.AllowNegativeWindowPosition;
 
+    case GLUT_GEOMETRY_BUFFER_CACHE_SIZE:
+        return fgState.GeometryBufferCacheSize;
+
+    case GLUT_GEOMETRY_MESH_CACHE_SIZE:
+        return fgState.GeometryMeshCacheSize;
+
+    case GLUT_GEOMETRY_MESH_CACHE_HITS:
+        return fgState.GeometryMeshCacheHits;
+
+    case GLUT_GEOMETRY_MESH_CACHE_MISSES:
+        return fgState.GeometryMeshCacheMisses;
+
+    case GLUT_GEOMETRY_VERTEX_FORMAT:
+        return fgState.GeometryVertexFormat;
+
+    case GLUT_TEASET_SUBDIVISIONS:
+        return fgState.TeasetSubdivisions;
+
+    case GLUT_FRAME_STATS:
+        return fgState.FrameStats.Enabled;
+
+    /* The framebuffer configuration queries */
+    case GLUT_WINDOW_RGBA:
+    case GLUT_WINDOW_DOUBLEBUFFER:
+    case GLUT_WINDOW_STEREO:
+    case GLUT_WINDOW_SRGB:
+    case GLUT_WINDOW_BUFFER_SIZE:
+    case GLUT_WINDOW_RED_SIZE:
+    case GLUT_WINDOW_GREEN_SIZE:
+    case GLUT_WINDOW_BLUE_SIZE:
+    case GLUT_WINDOW_ALPHA_SIZE:
+    case GLUT_WINDOW_DEPTH_SIZE:
+    case GLUT_WINDOW_STENCIL_SIZE:
+    case GLUT_WINDOW_ACCUM_RED_SIZE:
+    case GLUT_WINDOW_ACCUM_GREEN_SIZE:
+    case GLUT_WINDOW_ACCUM_BLUE_SIZE:
+    case GLUT_WINDOW_ACCUM_ALPHA_SIZE:
+    case GLUT_WINDOW_NUM_SAMPLES:
+    case GLUT_WINDOW_COLORMAP_SIZE:
+    case GLUT_WINDOW_FORMAT_ID:
+        if( fgStructure.CurrentWindow == NULL )
+            return fgPlatformGlutGet ( eWhat );
+        return fghGetWindowConfig( fgStructure.CurrentWindow, eWhat );
+
     default:
         return fgPlatformGlutGet ( eWhat );
         break;
     }
 }
 
+/*
+ * General settings query method, for values that need more than 32 bits
+ */
+GLUTtime FGAPIENTRY glutGet64( GLenum eWhat )
+{
+    switch( eWhat )
+    {
+    case GLUT_ELAPSED_TIME:
+        return fgElapsedTime();
+
+    case GLUT_ELAPSED_TIME_NS:
+        return fgElapsedTimeNs();
+
+    default:
+        return (GLUTtime) glutGet( eWhat );
+    }
+}
+
 /*
  * Returns various device information.
  */
@@ -361,16 +555,63 @@ int FGAPIENTRY glutLayerGet( GLenum eWhat )
     return -1;
 }
 
+/*
+ * Returns the values a display mode setting can take. Finding them out means
+ * going through every framebuffer configuration the display has, and they
+ * cannot change while it is open, so the answers are kept in fgState.
+ */
 int * FGAPIENTRY glutGetModeValues(GLenum eWhat, int *size)
 {
   int *array;
+  int i;
 
   FREEGLUT_EXIT_IF_NOT_INITIALISED("glutGetModeValues");
 
   *size = 0;
-  array = fgPlatformGlutGetModeValues ( eWhat, size );
+  switch( eWhat )
+  {
+  case GLUT_AUX:         i = 0; break;
+  case GLUT_MULTISAMPLE: i = 1; break;
+  default:
+    return fgPlatformGlutGetModeValues ( eWhat, size );
+  }
+
+  if( fgState.NumModeValues[ i ] < 0 )
+  {
+    fgState.ModeValues[ i ] = fgPlatformGlutGetModeValues ( eWhat, &fgState.NumModeValues[ i ] );
+    if( fgState.ModeValues[ i ] == NULL )
+      fgState.NumModeValues[ i ] = 0;
+  }
+  if( fgState.NumModeValues[ i ] == 0 )
+    return NULL;
+
+  /* The caller frees what it gets, so it gets its own copy */
+  array = malloc( fgState.NumModeValues[ i ] * sizeof( int ) );
+  if( array == NULL )
+    return NULL;
+  memcpy( array, fgState.ModeValues[ i ], fgState.NumModeValues[ i ] * sizeof( int ) );
+  *size = fgState.NumModeValues[ i ];
 
   return array;
 }
 
+/*
+ * Returns the current window's whole framebuffer configuration at once
+ */
+int FGAPIENTRY glutGetWindowConfig( GLUTwindowConfig *config )
+{
+    int i;
+
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutGetWindowConfig" );
+
+    if( fgStructure.CurrentWindow == NULL || config == NULL )
+        return 0;
+
+    for( i = 0; i < FG_NUM_WINDOW_CONFIG_VALUES; i++ )
+        *( int * )( ( char * )config + fghWindowConfigFields[ i ].Offset ) =
+            fghGetWindowConfigValue( fgStructure.CurrentWindow, i );
+
+    return 1;
+}
+
 /*** END OF FILE ***/
@@ -38,6 +38,14 @@
 SFG_Structure fgStructure = { { NULL, NULL },  /* The list of windows       */
                               { NULL, NULL },  /* The list of menus         */
                               { NULL, NULL },  /* Windows to Destroy list   */
+                              { NULL, NULL },  /* Windows with pending work */
+                              { NULL, NULL },  /* Work put off to next pass */
+                              0,               /* Work passes so far        */
+                              0,               /* Number of user windows    */
+                              { NULL, 0, 0 },  /* Windows by handle         */
+                              { NULL, 0, 0 },  /* Windows by ID             */
+                              { NULL, 0, 0 },  /* Menus by ID               */
+                              NULL,            /* Last window by handle     */
                               NULL,            /* The current window        */
                               NULL,            /* The current menu          */
                               NULL,            /* The menu OpenGL context   */
@@ -48,6 +56,126 @@ SFG_Structure fgStructure = { { NULL, NULL },  /* The list of windows       */
 
 /* -- PRIVATE FUNCTIONS ---------------------------------------------------- */
 
+/*
+ * Hash map functions, for looking up windows and menus without walking
+ * the window hierarchy (also used for the prepared strings in fg_font.c)
+ */
+static int fghHashSlot( const SFG_HashMap *map, size_t key )
+{
+    size_t hash = key;
+
+    hash ^= hash >> 13;
+    hash *= 0x5bd1e995;
+    hash ^= hash >> 15;
+
+    return ( int )( hash & ( map->Size - 1 ) );
+}
+
+void *fgHashFind( const SFG_HashMap *map, size_t key )
+{
+    int i;
+
+    if( !map->Count )
+        return NULL;
+
+    for( i = fghHashSlot( map, key ); map->Entries[ i ].Value;
+         i = ( i + 1 ) & ( map->Size - 1 ) )
+        if( map->Entries[ i ].Key == key )
+            return map->Entries[ i ].Value;
+
+    return NULL;
+}
+
+void fgHashInsert( SFG_HashMap *map, size_t key, void *value )
+{
+    int i;
+
+    /* Keep the load factor at most 1/2, so probe sequences stay short */
+    if( ( map->Count + 1 ) * 2 > map->Size )
+    {
+        SFG_HashMap grown;
+        grown.Size    = map->Size ? map->Size * 2 : 16;
+        grown.Count   = 0;
+        grown.Entries = calloc( grown.Size, sizeof( SFG_HashEntry ) );
+        if( !grown.Entries )
+            fgError( "Out of memory. Could not grow the window lookup table." );
+
+        for( i = 0; i < map->Size; i++ )
+            if( map->Entries[ i ].Value )
+                fgHashInsert( &grown, map->Entries[ i ].Key, map->Entries[ i ].Value );
+
+        free( map->Entries );
+        *map = grown;
+    }
+
+    for( i = fghHashSlot( map, key ); map->Entries[ i ].Value;
+         i = ( i + 1 ) & ( map->Size - 1 ) )
+        if( map->Entries[ i ].Key == key )
+            break;
+
+    if( !map->Entries[ i ].Value )
+        map->Count++;
+    map->Entries[ i ].Key   = key;
+    map->Entries[ i ].Value = value;
+}
+
+static void fghHashRemoveSlot( SFG_HashMap *map, int hole )
+{
+    int i = hole;
+
+    map->Entries[ hole ].Value = NULL;
+    map->Count--;
+
+    /* Shift back entries that probed past the hole, no tombstones needed */
+    for( ;; )
+    {
+        int home;
+
+        i = ( i + 1 ) & ( map->Size - 1 );
+        if( !map->Entries[ i ].Value )
+            break;
+
+        home = fghHashSlot( map, map->Entries[ i ].Key );
+        if( ( ( i - home ) & ( map->Size - 1 ) ) >= ( ( i - hole ) & ( map->Size - 1 ) ) )
+        {
+            map->Entries[ hole ] = map->Entries[ i ];
+            map->Entries[ i ].Value = NULL;
+            hole = i;
+        }
+    }
+}
+
+/* Removes the entry mapping to value, under key or (if that changed) any other */
+void fgHashRemove( SFG_HashMap *map, size_t key, void *value )
+{
+    int i;
+
+    if( !map->Count )
+        return;
+
+    for( i = fghHashSlot( map, key ); map->Entries[ i ].Value;
+         i = ( i + 1 ) & ( map->Size - 1 ) )
+        if( map->Entries[ i ].Key == key && map->Entries[ i ].Value == value )
+        {
+            fghHashRemoveSlot( map, i );
+            return;
+        }
+
+    for( i = 0; i < map->Size; i++ )
+        if( map->Entries[ i ].Value == value )
+        {
+            fghHashRemoveSlot( map, i );
+            return;
+        }
+}
+
+void fgHashFree( SFG_HashMap *map )
+{
+    free( map->Entries );
+    map->Entries = NULL;
+    map->Size = map->Count = 0;
+}
+
 extern void fgPlatformCreateWindow ( SFG_Window *window );
 extern void fghDefaultReshape(int width, int height, FGCBUserData userData);
 
@@ -92,17 +220,27 @@ SFG_Window* fgCreateWindow( SFG_Window* parent, const char* title,
     window->ID = ++fgStructure.WindowID;
 
     fgListInit( &window->Children );
+    fgListInit( &window->Window.GeometryBuffers );
+    window->WorkNode.Window = window;
     if( parent )
     {
         fgListAppend( &parent->Children, &window->Node );
         window->Parent = parent;
     }
     else
+    {
         fgListAppend( &fgStructure.Windows, &window->Node );
+        if( !isMenu )
+            fgStructure.NumWindows++;
+    }
+    fgHashInsert( &fgStructure.WindowsByID, ( size_t )window->ID, window );
 
     /* Set the default mouse cursor */
     window->State.Cursor    = GLUT_CURSOR_INHERIT;
 
+    /* Swaps wait for one retrace unless told otherwise */
+    window->State.SwapInterval = 1;
+
     /* Mark window as menu if a menu is to be created */
     window->IsMenu          = isMenu;
 
@@ -113,6 +251,11 @@ SFG_Window* fgCreateWindow( SFG_Window* parent, const char* title,
     fgOpenWindow( window, title, positionUse, x, y, sizeUse, w, h, gameMode,
                   (GLboolean)(parent ? GL_TRUE : GL_FALSE) );
 
+    /* Backends that get their handle later are added by fgWindowByHandle */
+    if( window->Window.Handle )
+        fgHashInsert( &fgStructure.WindowsByHandle,
+                       ( size_t )window->Window.Handle, window );
+
     return window;
 }
 
@@ -145,6 +288,7 @@ SFG_Menu* fgCreateMenu( FGCBMenuUC menuCallback, FGCBUserData userData )
 
     fgListInit( &menu->Entries );
     fgListAppend( &fgStructure.Menus, &menu->Node );
+    fgHashInsert( &fgStructure.MenusByID, ( size_t )menu->ID, menu );
 
     /* Newly created menus implicitly become current ones */
     fgStructure.CurrentMenu = menu;
@@ -187,6 +331,7 @@ void fgAddToWindowDestroyList( SFG_Window* window )
      * Similarly, clear all work set for the window, none of this has to be executed anymore
      */
     window->State.WorkMask = 0;
+    fgRemoveWork( window );
 }
 
 /*
@@ -216,16 +361,40 @@ void fgDestroyWindow( SFG_Window* window )
     while( window->Children.First )
         fgDestroyWindow( ( SFG_Window * )window->Children.First );
 
+    /* INVOKE_WCB also delivers any coalesced events still pending for the window */
     {
         SFG_Window *activeWindow = fgStructure.CurrentWindow;
         INVOKE_WCB( *window, Destroy, ( ) );
         fgSetWindow( activeWindow );
     }
 
+    /* The cached geometry buffers and glyph textures live in the window's context */
+    if( window->Window.GeometryBuffers.First || window->Window.NumFontAtlases ||
+        window->Window.FontBuffer )
+    {
+        SFG_Window *activeWindow = fgStructure.CurrentWindow;
+        fgSetWindow( window );
+        fgFreeGeometryBuffers( window );
+        fgFreeFontAtlases( window );
+        fgSetWindow( activeWindow );
+    }
+
     if( window->Parent )
         fgListRemove( &window->Parent->Children, &window->Node );
     else
+    {
         fgListRemove( &fgStructure.Windows, &window->Node );
+        if( !window->IsMenu )
+            fgStructure.NumWindows--;
+    }
+
+    fgHashRemove( &fgStructure.WindowsByID, ( size_t )window->ID, window );
+    fgHashRemove( &fgStructure.WindowsByHandle,
+                   ( size_t )window->Window.Handle, window );
+    if( fgStructure.LastWindowByHandle == window )
+        fgStructure.LastWindowByHandle = NULL;
+
+    fgRemoveWork( window );
 
     if( window->ActiveMenu )
       fgDeactivateMenu( window );
@@ -333,10 +502,20 @@ void fgDestroyMenu( SFG_Menu* menu )
         free( entry );
     }
 
+    /* The compiled menu lives in the menu window's context */
+    if( menu->DisplayLists )
+    {
+        SFG_Window *activeWindow = fgStructure.CurrentWindow;
+        fgSetWindow( menu->Window );
+        fgFreeMenuDisplayLists( menu );
+        fgSetWindow( activeWindow );
+    }
+
     if( fgStructure.CurrentWindow == menu->Window )
         fgSetWindow( NULL );
     fgDestroyWindow( menu->Window );
     fgListRemove( &fgStructure.Menus, &menu->Node );
+    fgHashRemove( &fgStructure.MenusByID, ( size_t )menu->ID, menu );
     if( fgStructure.CurrentMenu == menu )
         fgStructure.CurrentMenu = NULL;
 
@@ -385,6 +564,10 @@ void fgDestroyStructure( void )
 
     while( fgStructure.Windows.First )
         fgDestroyWindow( ( SFG_Window * )fgStructure.Windows.First );
+
+    fgHashFree( &fgStructure.WindowsByHandle );
+    fgHashFree( &fgStructure.WindowsByID );
+    fgHashFree( &fgStructure.MenusByID );
 }
 
 /*
@@ -485,93 +668,50 @@ static void fghcbWindowByHandle( SFG_Window *window,
 SFG_Window* fgWindowByHandle ( SFG_WindowHandleType hWindow )
 {
     SFG_Enumerator enumerator;
+    SFG_Window *window;
+
+    /* Event bursts usually target one window */
+    window = fgStructure.LastWindowByHandle;
+    if( window && window->Window.Handle == hWindow )
+        return window;
 
-    /* This is easy and makes use of the windows enumeration defined above */
+    /* Backends may change a window's handle, so check what we found */
+    window = fgHashFind( &fgStructure.WindowsByHandle, ( size_t )hWindow );
+    if( window && window->Window.Handle == hWindow )
+        return fgStructure.LastWindowByHandle = window;
+    if( window )
+        fgHashRemove( &fgStructure.WindowsByHandle, ( size_t )hWindow, window );
+
+    /* Not in the table (yet): use the windows enumeration defined above */
     enumerator.found = GL_FALSE;
     enumerator.data = (void *)hWindow;
     fgEnumWindows( fghcbWindowByHandle, &enumerator );
 
-    if( enumerator.found )
-        return( SFG_Window *) enumerator.data;
-    return NULL;
-}
+    if( !enumerator.found )
+        return NULL;
 
-/*
- * A static helper function to look for a window given its ID
- */
-static void fghcbWindowByID( SFG_Window *window, SFG_Enumerator *enumerator )
-{
-    /* Make sure we do not overwrite our precious results... */
-    if( enumerator->found )
-        return;
-
-    /* Check the window's handle. Hope this works. Looks ugly. That's for sure. */
-    if( window->ID == *( int *)(enumerator->data) )
-    {
-        enumerator->found = GL_TRUE;
-        enumerator->data = window;
-
-        return;
-    }
-
-    /* Otherwise, check this window's children */
-    fgEnumSubWindows( window, fghcbWindowByID, enumerator );
+    window = ( SFG_Window * )enumerator.data;
+    fgHashInsert( &fgStructure.WindowsByHandle, ( size_t )hWindow, window );
+    return fgStructure.LastWindowByHandle = window;
 }
 
 /*
  * This function is similar to the previous one, except it is
- * looking for a specified (sub)window identifier. The function
- * is defined in fg_structure.c file.
+ * looking for a specified (sub)window identifier. IDs never change,
+ * so the table kept by fgCreateWindow/fgDestroyWindow is all we need.
  */
 SFG_Window* fgWindowByID( int windowID )
 {
-    SFG_Enumerator enumerator;
-
-    /* Uses a method very similar for fgWindowByHandle... */
-    enumerator.found = GL_FALSE;
-    enumerator.data = ( void * )&windowID;
-    fgEnumWindows( fghcbWindowByID, &enumerator );
-    if( enumerator.found )
-        return ( SFG_Window * )enumerator.data;
-    return NULL;
-}
-
-/*
- * A static helper function to look for a menu given its ID
- */
-static void fghcbMenuByID( SFG_Menu *menu,
-    SFG_Enumerator *enumerator )
-{
-    if ( enumerator->found )
-        return;
-
-    /* Check the menu's ID. */
-    if( menu->ID == *( int *)(enumerator->data) )
-    {
-        enumerator->found = GL_TRUE;
-        enumerator->data = menu;
-
-        return;
-    }
+    return ( SFG_Window * )fgHashFind( &fgStructure.WindowsByID, ( size_t )windowID );
 }
 
 /*
- * Looks up a menu given its ID. This is easier than fgWindowByXXX
- * as all menus are placed in one doubly linked list...
+ * Looks up a menu given its ID, in the table kept by fgCreateMenu
+ * and fgDestroyMenu.
  */
 SFG_Menu* fgMenuByID( int menuID )
 {
-    SFG_Enumerator enumerator;
-
-    /* This is easy and makes use of the menus enumeration defined above */
-    enumerator.found = GL_FALSE;
-    enumerator.data = (void *)&menuID;
-    fgEnumMenus( fghcbMenuByID, &enumerator );
-
-    if( enumerator.found )
-        return( SFG_Menu *) enumerator.data;
-
-    return NULL;
+    return ( SFG_Menu * )fgHashFind( &fgStructure.MenusByID, ( size_t )menuID );
 }
 
 /*
@@ -686,4 +826,107 @@ void fgListInsert(SFG_List *list, SFG_Node *next, SFG_Node *node)
         list->First = node;
 }
 
+/*
+ * Timer queue functions, a binary heap with the earliest timer at index 0
+ */
+static int fghTimerBefore(const SFG_Timer *a, const SFG_Timer *b)
+{
+    if( a->TriggerTime != b->TriggerTime )
+        return a->TriggerTime < b->TriggerTime;
+    return a->Sequence < b->Sequence;
+}
+
+static void fghTimerQueueSiftUp(SFG_TimerQueue *queue, int index)
+{
+    SFG_Timer *timer = queue->Heap[ index ];
+
+    while( index > 0 )
+    {
+        int parent = ( index - 1 ) / 2;
+
+        if( !fghTimerBefore( timer, queue->Heap[ parent ] ) )
+            break;
+
+        queue->Heap[ index ] = queue->Heap[ parent ];
+        index = parent;
+    }
+
+    queue->Heap[ index ] = timer;
+}
+
+static void fghTimerQueueSiftDown(SFG_TimerQueue *queue, int index)
+{
+    SFG_Timer *timer = queue->Heap[ index ];
+
+    for( ;; )
+    {
+        int child = 2 * index + 1;
+
+        if( child >= queue->Count )
+            break;
+        if( child + 1 < queue->Count &&
+            fghTimerBefore( queue->Heap[ child + 1 ], queue->Heap[ child ] ) )
+            child++;
+        if( !fghTimerBefore( queue->Heap[ child ], timer ) )
+            break;
+
+        queue->Heap[ index ] = queue->Heap[ child ];
+        index = child;
+    }
+
+    queue->Heap[ index ] = timer;
+}
+
+void fgTimerQueuePush(SFG_TimerQueue *queue, SFG_Timer *timer)
+{
+    if( queue->Count == queue->Size )
+    {
+        int size = queue->Size ? queue->Size * 2 : 16;
+        SFG_Timer **heap = realloc( queue->Heap, size * sizeof( SFG_Timer* ) );
+
+        if( !heap )
+            fgError( "Fatal error: "
+                     "Memory allocation failure in glutTimerFunc()" );
+
+        queue->Heap = heap;
+        queue->Size = size;
+    }
+
+    timer->Sequence = queue->NextSequence++;
+    queue->Heap[ queue->Count++ ] = timer;
+    fghTimerQueueSiftUp( queue, queue->Count - 1 );
+}
+
+/* Removes the timer at the given heap index, 0 being the earliest one */
+SFG_Timer *fgTimerQueueRemove(SFG_TimerQueue *queue, int index)
+{
+    SFG_Timer *timer = queue->Heap[ index ];
+
+    queue->Count--;
+    if( index < queue->Count )
+    {
+        /* Move the last timer into the hole, and restore the heap order */
+        queue->Heap[ index ] = queue->Heap[ queue->Count ];
+        if( index > 0 && fghTimerBefore( queue->Heap[ index ],
+                                         queue->Heap[ ( index - 1 ) / 2 ] ) )
+            fghTimerQueueSiftUp( queue, index );
+        else
+            fghTimerQueueSiftDown( queue, index );
+    }
+
+    return timer;
+}
+
+/* Frees the queued timers and the heap itself */
+void fgTimerQueueFree(SFG_TimerQueue *queue)
+{
+    while( queue->Count )
+        free( queue->Heap[ --queue->Count ] );
+
+    free( queue->Heap );
+    queue->Heap = NULL;
+    queue->Size = 0;
+    queue->NextSequence = 0;
+}
+
 /*** END OF FILE ***/
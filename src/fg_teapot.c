@@ -39,103 +39,57 @@
 /* General defs */
 #define GLUT_SOLID_N_SUBDIV  8
 #define GLUT_WIRE_N_SUBDIV   10
-
-/* Bernstein coefficients only have to be precomputed once (number of patch subdivisions is fixed)
- * Can thus define arrays for them here, they will be filled upon first use.
- * 3rd order Bezier surfaces have 4 Bernstein coeffs.
- * Have separate caches for solid and wire as they use a different number of subdivisions
- * _0 is for Bernstein polynomials, _1 for their first derivative (which we need for normals)
- */
-static GLfloat bernWire_0 [GLUT_WIRE_N_SUBDIV] [4];
-static GLfloat bernWire_1 [GLUT_WIRE_N_SUBDIV] [4];
-static GLfloat bernSolid_0[GLUT_SOLID_N_SUBDIV][4];
-static GLfloat bernSolid_1[GLUT_SOLID_N_SUBDIV][4];
+/* Upper limit for GLUT_TEASET_SUBDIVISIONS: N_SUBDIV^2 vertices for each of
+ * the teapot's 32 patches still have to be addressable with GLushort indices */
+#define GLUT_TEASET_MAX_N_SUBDIV 45
 
 /* Teapot defs */
 #define GLUT_TEAPOT_N_PATCHES       (6*4 + 4*2)                                                                     /* 6 patches are reproduced (rotated) 4 times, 4 patches (flipped) 2 times */
-#define GLUT_SOLID_TEAPOT_N_VERT    GLUT_SOLID_N_SUBDIV*GLUT_SOLID_N_SUBDIV * GLUT_TEAPOT_N_PATCHES                 /* N_SUBDIV^2 vertices per patch */
-#define GLUT_SOLID_TEAPOT_N_TRI     (GLUT_SOLID_N_SUBDIV-1)*(GLUT_SOLID_N_SUBDIV-1) * GLUT_TEAPOT_N_PATCHES * 2     /* if e.g. 7x7 vertices for each patch, there are 6*6 squares for each patch. Each square is decomposed into 2 triangles */
-
-#define GLUT_WIRE_TEAPOT_N_VERT     GLUT_WIRE_N_SUBDIV*GLUT_WIRE_N_SUBDIV * GLUT_TEAPOT_N_PATCHES                   /* N_SUBDIV^2 vertices per patch */
-
-/* Bit of caching:
- * vertex indices and normals only need to be generated once for
- * a given number of subdivisions as they don't change with scale.
- * Vertices can be cached and reused if scale didn't change.
- */
-static GLushort vertIdxsTeapotS[GLUT_SOLID_TEAPOT_N_TRI*3];
-static GLfloat  normsTeapotS   [GLUT_SOLID_TEAPOT_N_VERT*3];
-static GLfloat  vertsTeapotS   [GLUT_SOLID_TEAPOT_N_VERT*3];
-static GLfloat  texcsTeapotS   [GLUT_SOLID_TEAPOT_N_VERT*2];
-static GLfloat  lastScaleTeapotS = 0.f;
-static GLboolean initedTeapotS   = GL_FALSE;
-
-static GLushort vertIdxsTeapotW[GLUT_WIRE_TEAPOT_N_VERT*2];
-static GLfloat  normsTeapotW   [GLUT_WIRE_TEAPOT_N_VERT*3];
-static GLfloat  vertsTeapotW   [GLUT_WIRE_TEAPOT_N_VERT*3];
-static GLfloat  lastScaleTeapotW = 0.f;
-static GLboolean initedTeapotW   = GL_FALSE;
-
 
 /* Teacup defs */
 #define GLUT_TEACUP_N_PATCHES       (6*4 + 1*2)                                                                     /* 6 patches are reproduced (rotated) 4 times, 1 patch (flipped) 2 times */
-#define GLUT_SOLID_TEACUP_N_VERT    GLUT_SOLID_N_SUBDIV*GLUT_SOLID_N_SUBDIV * GLUT_TEACUP_N_PATCHES                 /* N_SUBDIV^2 vertices per patch */
-#define GLUT_SOLID_TEACUP_N_TRI     (GLUT_SOLID_N_SUBDIV-1)*(GLUT_SOLID_N_SUBDIV-1) * GLUT_TEACUP_N_PATCHES * 2     /* if e.g. 7x7 vertices for each patch, there are 6*6 squares for each patch. Each square is decomposed into 2 triangles */
-
-#define GLUT_WIRE_TEACUP_N_VERT     GLUT_WIRE_N_SUBDIV*GLUT_WIRE_N_SUBDIV * GLUT_TEACUP_N_PATCHES                   /* N_SUBDIV^2 vertices per patch */
-
-/* Bit of caching:
- * vertex indices and normals only need to be generated once for
- * a given number of subdivisions as they don't change with scale.
- * Vertices can be cached and reused if scale didn't change.
- */
-static GLushort vertIdxsTeacupS[GLUT_SOLID_TEACUP_N_TRI*3];
-static GLfloat  normsTeacupS   [GLUT_SOLID_TEACUP_N_VERT*3];
-static GLfloat  vertsTeacupS   [GLUT_SOLID_TEACUP_N_VERT*3];
-static GLfloat  texcsTeacupS   [GLUT_SOLID_TEACUP_N_VERT*2];
-static GLfloat  lastScaleTeacupS = 0.f;
-static GLboolean initedTeacupS   = GL_FALSE;
-
-static GLushort vertIdxsTeacupW[GLUT_WIRE_TEACUP_N_VERT*2];
-static GLfloat  normsTeacupW   [GLUT_WIRE_TEACUP_N_VERT*3];
-static GLfloat  vertsTeacupW   [GLUT_WIRE_TEACUP_N_VERT*3];
-static GLfloat  lastScaleTeacupW = 0.f;
-static GLboolean initedTeacupW   = GL_FALSE;
-
 
 /* Teaspoon defs */
 #define GLUT_TEASPOON_N_PATCHES     GLUT_TEASPOON_N_INPUT_PATCHES
-#define GLUT_SOLID_TEASPOON_N_VERT  GLUT_SOLID_N_SUBDIV*GLUT_SOLID_N_SUBDIV * GLUT_TEASPOON_N_PATCHES               /* N_SUBDIV^2 vertices per patch */
-#define GLUT_SOLID_TEASPOON_N_TRI   (GLUT_SOLID_N_SUBDIV-1)*(GLUT_SOLID_N_SUBDIV-1) * GLUT_TEASPOON_N_PATCHES * 2   /* if e.g. 7x7 vertices for each patch, there are 6*6 squares for each patch. Each square is decomposed into 2 triangles */
-
-#define GLUT_WIRE_TEASPOON_N_VERT   GLUT_WIRE_N_SUBDIV*GLUT_WIRE_N_SUBDIV * GLUT_TEASPOON_N_PATCHES                 /* N_SUBDIV^2 vertices per patch */
 
 /* Bit of caching:
- * vertex indices and normals only need to be generated once for
- * a given number of subdivisions as they don't change with scale.
- * Vertices can be cached and reused if scale didn't change.
+ * the vertices, normals, texture coordinates and vertex indices of the
+ * teapot, teacup and teaspoon are generated at unit scale, once for each
+ * number of subdivisions, and kept in the mesh cache of fg_geometry.c.
+ * Drawing them at another size only scales the cached vertices.
+ * The shapes' data, indexed by FGH_SHAPE_* - FGH_SHAPE_TEAPOT:
  */
-static GLushort vertIdxsTeaspoonS[GLUT_SOLID_TEASPOON_N_TRI*3];
-static GLfloat  normsTeaspoonS   [GLUT_SOLID_TEASPOON_N_VERT*3];
-static GLfloat  vertsTeaspoonS   [GLUT_SOLID_TEASPOON_N_VERT*3];
-static GLfloat  texcsTeaspoonS   [GLUT_SOLID_TEASPOON_N_VERT*2];
-static GLfloat  lastScaleTeaspoonS = 0.f;
-static GLboolean initedTeaspoonS   = GL_FALSE;
-
-static GLushort vertIdxsTeaspoonW[GLUT_WIRE_TEASPOON_N_VERT*2];
-static GLfloat  normsTeaspoonW   [GLUT_WIRE_TEASPOON_N_VERT*3];
-static GLfloat  vertsTeaspoonW   [GLUT_WIRE_TEASPOON_N_VERT*3];
-static GLfloat  lastScaleTeaspoonW = 0.f;
-static GLboolean initedTeaspoonW   = GL_FALSE;
+static const struct
+{
+    GLfloat (*cpdata)[3];
+    int (*patchdata)[16];
+    int nInputPatches, nPatches;
+    GLboolean needNormalFix, rotFlip;
+    GLfloat zOffset;
+} teasetShapes[] =
+{
+    { cpdata_teapot,   patchdata_teapot,   GLUT_TEAPOT_N_INPUT_PATCHES,   GLUT_TEAPOT_N_PATCHES,   GL_TRUE,  GL_TRUE,   1.575f  },
+    { cpdata_teacup,   patchdata_teacup,   GLUT_TEACUP_N_INPUT_PATCHES,   GLUT_TEACUP_N_PATCHES,   GL_FALSE, GL_TRUE,   1.5121f },
+    { cpdata_teaspoon, patchdata_teaspoon, GLUT_TEASPOON_N_INPUT_PATCHES, GLUT_TEASPOON_N_PATCHES, GL_FALSE, GL_FALSE, -0.0315f }
+};
 
 
 
 /* -- PRIVATE FUNCTIONS ---------------------------------------------------- */
-extern void fghDrawGeometrySolid(GLfloat *vertices, GLfloat *normals, GLfloat *textcs, GLsizei numVertices,
-                                 GLushort *vertIdxs, GLsizei numParts, GLsizei numVertIdxsPerPart);
-extern void fghDrawGeometryWire(GLfloat *vertices, GLfloat *normals, GLsizei numVertices,
-                                GLushort *vertIdxs, GLsizei numParts, GLsizei numVertPerPart, GLenum vertexMode,
-                                GLushort *vertIdxs2, GLsizei numParts2, GLsizei numVertPerPart2);
+extern void fghInitGeometryKey(SFG_GeometryKey *key, int shape, GLboolean useWireMode,
+                               GLint slices, GLint stacks,
+                               GLfloat param0, GLfloat param1, GLfloat param2, GLfloat param3);
+extern void fghDrawPinnedShape(const SFG_GeometryKey *key, const SFG_GeometryKey *meshKey, SFG_GeometryMesh *mesh,
+                               GLfloat sx, GLfloat sy, GLfloat sz, void (*generate)(SFG_GeometryMesh *mesh));
+extern void fghFreeGeometryMeshArrays(SFG_GeometryMesh *mesh);
+
+/* The meshes drawn so far, by shape, solid [0] or wire [1], positive [0],
+ * negative [1] or zero [2] scale and number of subdivisions, allocated
+ * when first drawn. Kept here instead of in the mesh cache so that drawing
+ * other shapes can't evict them, nor GLUT_GEOMETRY_MESH_CACHE_SIZE 0
+ * disable them, and switching between levels doesn't regenerate them.
+ */
+static SFG_GeometryMesh *teasetMeshes[3][2][3][GLUT_TEASET_MAX_N_SUBDIV+1];
 
 /* evaluate 3rd order Bernstein polynomial and its 1st deriv */
 static void bernstein3(int i, GLfloat x, GLfloat *r0, GLfloat *r1)
@@ -223,44 +177,41 @@ static void rotOrReflect(int flag, int nVals, int nSubDivs, GLfloat *vals)
     }
 }
 
-/* verts array should be initialized to 0! */
+/* generate vertices and normals for a patch, returns number of values written to each array */
 static int evalBezierWithNorm(GLfloat cp[4][4][3], int nSubDivs, float (*bern_0)[4], float (*bern_1)[4], int flag, int normalFix, GLfloat *verts, GLfloat *norms)
 {
     int nVerts    = nSubDivs*nSubDivs;
     int nVertVals = nVerts*3;               /* number of values output for one patch, flag (2 or 4) indicates how many times we will write this to output */
-    int u,v,i,j,o;
+    int u,v,i,k,o;
+
+    /* The patch is evaluated one direction at a time: the four curves along v
+     * through the rows of control points (and their derivatives) don't depend
+     * on u, so get them once for each v rather than again for each vertex.
+     * That leaves a short sum of products per coordinate in the inner loop,
+     * without dependencies between the coordinates.
+     */
+    GLfloat curv_0[GLUT_TEASET_MAX_N_SUBDIV][4][3], curv_1[GLUT_TEASET_MAX_N_SUBDIV][4][3];
+    for (v=0; v<nSubDivs; v++)
+        for (i=0; i<=3; i++)
+            for (k=0; k<3; k++)
+            {
+                curv_0[v][i][k] = bern_0[v][0]*cp[i][0][k] + bern_0[v][1]*cp[i][1][k] + bern_0[v][2]*cp[i][2][k] + bern_0[v][3]*cp[i][3][k];
+                curv_1[v][i][k] = bern_1[v][0]*cp[i][0][k] + bern_1[v][1]*cp[i][1][k] + bern_1[v][2]*cp[i][2][k] + bern_1[v][3]*cp[i][3][k];
+            }
 
     /* generate vertices and coordinates for the patch */
     for (u=0,o=0; u<nSubDivs; u++)
     {
+        const GLfloat *b0 = bern_0[u], *b1 = bern_1[u];
         for (v=0; v<nSubDivs; v++, o+=3)
         {
             /* for normals, get two tangents at the vertex using partial derivatives of 2D Bezier grid */
-            float tan1[3]={0}, tan2[3]={0}, len;
-            for (i=0; i<=3; i++)
+            float tan1[3], tan2[3], len;
+            for (k=0; k<3; k++)
             {
-                float vert_0[3]={0}, vert_1[3]={0};
-                for (j=0; j<=3; j++)
-                {
-                    vert_0[0] += bern_0[v][j] * cp[i][j][0];
-                    vert_0[1] += bern_0[v][j] * cp[i][j][1];
-                    vert_0[2] += bern_0[v][j] * cp[i][j][2];
-
-                    vert_1[0] += bern_1[v][j] * cp[i][j][0];
-                    vert_1[1] += bern_1[v][j] * cp[i][j][1];
-                    vert_1[2] += bern_1[v][j] * cp[i][j][2];
-                }
-
-                verts[o+0] += bern_0[u][i]*vert_0[0];
-                verts[o+1] += bern_0[u][i]*vert_0[1];
-                verts[o+2] += bern_0[u][i]*vert_0[2];
-
-                tan1[0] += bern_0[u][i]*vert_1[0];
-                tan1[1] += bern_0[u][i]*vert_1[1];
-                tan1[2] += bern_0[u][i]*vert_1[2];
-                tan2[0] += bern_1[u][i]*vert_0[0];
-                tan2[1] += bern_1[u][i]*vert_0[1];
-                tan2[2] += bern_1[u][i]*vert_0[2];
+                verts[o+k] = b0[0]*curv_0[v][0][k] + b0[1]*curv_0[v][1][k] + b0[2]*curv_0[v][2][k] + b0[3]*curv_0[v][3][k];
+                tan1[k]    = b0[0]*curv_1[v][0][k] + b0[1]*curv_1[v][1][k] + b0[2]*curv_1[v][2][k] + b0[3]*curv_1[v][3][k];
+                tan2[k]    = b1[0]*curv_0[v][0][k] + b1[1]*curv_0[v][1][k] + b1[2]*curv_0[v][2][k] + b1[3]*curv_0[v][3][k];
             }
             /* get normal through cross product of the two tangents of the vertex */
             norms[o+0] = tan1[1] * tan2[2] - tan1[2] * tan2[1];
@@ -291,185 +242,215 @@ static int evalBezierWithNorm(GLfloat cp[4][4][3], int nSubDivs, float (*bern_0)
     return nVertVals*flag;
 }
 
-/* verts array should be initialized to 0! */
-static int evalBezier(GLfloat cp[4][4][3], int nSubDivs, float (*bern_0)[4], int flag, GLfloat *verts)
+/*
+ * Generate the teapot, teacup or teaspoon given by the mesh's key: Slices
+ * is the number of subdivisions, Params[0] the scale (only ever 1 or -1,
+ * the magnitude is applied when drawing).
+ */
+static void fghGenerateTeasetMesh( SFG_GeometryMesh *mesh )
 {
-    int nVerts    = nSubDivs*nSubDivs;
-    int nVertVals = nVerts*3;               /* number of values output for one patch, flag (2 or 4) indicates how many times we will write this to output */
-    int u,v,i,j,o;
+    int shape           = mesh->Key.Shape - FGH_SHAPE_TEAPOT;
+    GLboolean useWireMode = mesh->Key.WireMode;
+    int nSubDivs        = mesh->Key.Slices;
+    GLfloat scale       = mesh->Key.Params[0];
+
+    GLfloat (*cpdata)[3]  = teasetShapes[shape].cpdata;
+    int (*patchdata)[16]  = teasetShapes[shape].patchdata;
+    int nInputPatches     = teasetShapes[shape].nInputPatches;
+    int nPatches          = teasetShapes[shape].nPatches;
+    GLboolean needNormalFix = teasetShapes[shape].needNormalFix;
+    GLboolean rotFlip     = teasetShapes[shape].rotFlip;
+    GLfloat zOffset       = teasetShapes[shape].zOffset;
+
+    int nVerts     = nSubDivs*nSubDivs * nPatches;                  /* N_SUBDIV^2 vertices per patch */
+    int nTriangles = (nSubDivs-1)*(nSubDivs-1) * nPatches * 2;      /* if e.g. 7x7 vertices for each patch, there are 6*6 squares for each patch. Each square is decomposed into 2 triangles */
+    int nVertIdxs  = useWireMode ? nVerts*2 : nTriangles*3;
 
-    /* generate vertices and coordinates for the patch */
-    for (u=0,o=0; u<nSubDivs; u++)
+    /* for internal use */
+    int p,o,r,c;
+    GLfloat cp[4][4][3];
+    /* 3rd order Bezier surfaces have 4 Bernstein coeffs.
+     * _0 is for Bernstein polynomials, _1 for their first derivative (which we need for normals)
+     */
+    GLfloat bern_0[GLUT_TEASET_MAX_N_SUBDIV][4], bern_1[GLUT_TEASET_MAX_N_SUBDIV][4];
+    GLfloat *verts, *norms, *texcs = NULL;
+    GLushort *vertIdxs;
+
+    verts    = malloc(nVerts*3*sizeof(GLfloat));
+    norms    = malloc(nVerts*3*sizeof(GLfloat));
+    vertIdxs = malloc(nVertIdxs*sizeof(GLushort));
+    if (!useWireMode)
+        texcs = malloc(nVerts*2*sizeof(GLfloat));
+    if (!verts || !norms || !vertIdxs || (!useWireMode && !texcs))
     {
-        for (v=0; v<nSubDivs; v++, o+=3)
-        {
-            for (i=0; i<=3; i++)
-            {
-                float vert_0[3]={0};
-                for (j=0; j<=3; j++)
-                {
-                    vert_0[0] += bern_0[v][j] * cp[i][j][0];
-                    vert_0[1] += bern_0[v][j] * cp[i][j][1];
-                    vert_0[2] += bern_0[v][j] * cp[i][j][2];
-                }
-
-                verts[o+0] += bern_0[u][i]*vert_0[0];
-                verts[o+1] += bern_0[u][i]*vert_0[1];
-                verts[o+2] += bern_0[u][i]*vert_0[2];
-            }
-        }
+        free(verts);
+        free(norms);
+        free(vertIdxs);
+        free(texcs);
+        fgError("Failed to allocate memory in fghGenerateTeasetMesh");
     }
 
-    /* now based on flag either rotate patches around y axis to other 3 quadrants (flag=4) or reflect patch across x-y plane (flag=2) */
-    rotOrReflect(flag, nVertVals, nSubDivs, verts);
+    /* pregen Berstein polynomials and their first derivatives (for normals) */
+    pregenBernstein(nSubDivs,bern_0,bern_1);
 
-    return nVertVals*flag;
-}
+    /* generate vertices and normals */
+    for (p=0, o=0; p<nInputPatches; p++)
+    {
+        /* set flags for evalBezier function */
+        int flag      = rotFlip?p<6?4:2:1;                  /* For teapot and teacup, first six patches get 3 copies (rotations), others get 2 copies (flips). No rotating or flipping at all for teaspoon */
+        int normalFix = needNormalFix?p==3?1:p==5?2:0:0;    /* For teapot, fix normal vectors for vertices on top of lid (patch 4) and on middle of bottom (patch 6). Different flag value as different normal needed */
 
-static void fghTeaset( GLfloat scale, GLboolean useWireMode,
-                       GLfloat (*cpdata)[3], int (*patchdata)[16],
-                       GLushort *vertIdxs,
-                       GLfloat *verts, GLfloat *norms, GLfloat *texcs,
-                       GLfloat *lastScale, GLboolean *inited,
-                       GLboolean needNormalFix, GLboolean rotFlip, GLfloat zOffset,
-                       int nVerts, int nInputPatches, int nPatches, int nTriangles )
-{
-    /* for internal use */
-    int p,o;
-    GLfloat cp[4][4][3];
-    /* to hold pointers to static vars/arrays */
-    GLfloat (*bern_0)[4], (*bern_1)[4];
-    int nSubDivs;
+        /* collect control points */
+        int i;
+        for (i=0; i<16; i++)
+        {
+            /* Original code draws with a 270 rot around X axis, a scaling and a translation along the Z-axis.
+             * Incorporating these in the control points is much cheaper than transforming all the vertices.
+             * Original:
+             * glRotated( 270.0, 1.0, 0.0, 0.0 );
+             * glScaled( 0.5 * scale, 0.5 * scale, 0.5 * scale );
+             * glTranslated( 0.0, 0.0, -zOffset );  -> was 1.5 for teapot, but should be 1.575 to center it on the Z axis. Teacup and teaspoon have different offsets
+             */
+            cp[i/4][i%4][0] =  cpdata[patchdata[p][i]][0]         *scale/2.f;
+            cp[i/4][i%4][1] = (cpdata[patchdata[p][i]][2]-zOffset)*scale/2.f;
+            cp[i/4][i%4][2] = -cpdata[patchdata[p][i]][1]         *scale/2.f;
+        }
 
-    /* Get relevant static arrays and variables */
-    bern_0      = useWireMode ? bernWire_0                : bernSolid_0;
-    bern_1      = useWireMode ? bernWire_1                : bernSolid_1;
-    nSubDivs    = useWireMode ? GLUT_WIRE_N_SUBDIV        : GLUT_SOLID_N_SUBDIV;
+        /* eval bezier patch */
+        o += evalBezierWithNorm(cp,nSubDivs,bern_0,bern_1, flag, normalFix, verts+o,norms+o);
+    }
 
-    /* check if need to generate vertices */
-    if (!*inited || scale != *lastScale)
+    /* generate texture coordinates if solid teapot/teacup/teaspoon */
+    if (!useWireMode)
     {
-        /* set vertex array to all 0 (not necessary for normals and vertex indices) */
-        memset(verts,0,nVerts*3*sizeof(GLfloat));
-
-        /* pregen Berstein polynomials and their first derivatives (for normals) */
-        if (!*inited)
-            pregenBernstein(nSubDivs,bern_0,bern_1);
-
-        /* generate vertices and normals */
-        for (p=0, o=0; p<nInputPatches; p++)
+        /* generate for first patch */
+        for (r=0,o=0; r<nSubDivs; r++)
         {
-            /* set flags for evalBezier function */
-            int flag      = rotFlip?p<6?4:2:1;                  /* For teapot and teacup, first six patches get 3 copies (rotations), others get 2 copies (flips). No rotating or flipping at all for teaspoon */
-            int normalFix = needNormalFix?p==3?1:p==5?2:0:0;    /* For teapot, fix normal vectors for vertices on top of lid (patch 4) and on middle of bottom (patch 6). Different flag value as different normal needed */
-
-            /* collect control points */
-            int i;
-            for (i=0; i<16; i++)
+            GLfloat u = r/(nSubDivs-1.f);
+            for (c=0; c<nSubDivs; c++, o+=2)
             {
-                /* Original code draws with a 270 rot around X axis, a scaling and a translation along the Z-axis.
-                 * Incorporating these in the control points is much cheaper than transforming all the vertices.
-                 * Original:
-                 * glRotated( 270.0, 1.0, 0.0, 0.0 );
-                 * glScaled( 0.5 * scale, 0.5 * scale, 0.5 * scale );
-                 * glTranslated( 0.0, 0.0, -zOffset );  -> was 1.5 for teapot, but should be 1.575 to center it on the Z axis. Teacup and teaspoon have different offsets
-                 */
-                cp[i/4][i%4][0] =  cpdata[patchdata[p][i]][0]         *scale/2.f;
-                cp[i/4][i%4][1] = (cpdata[patchdata[p][i]][2]-zOffset)*scale/2.f;
-                cp[i/4][i%4][2] = -cpdata[patchdata[p][i]][1]         *scale/2.f;
+                GLfloat v = c/(nSubDivs-1.f);
+                texcs[o+0] = u;
+                texcs[o+1] = v;
             }
+        }
+        /* copy it over for all the other patches */
+        for (p=1; p<nPatches; p++)
+            memcpy(texcs+p*nSubDivs*nSubDivs*2,texcs,nSubDivs*nSubDivs*2*sizeof(GLfloat));
+    }
 
-            /* eval bezier patch */
-            if (!*inited)   /* first time, generate normals as well */
-                o += evalBezierWithNorm(cp,nSubDivs,bern_0,bern_1, flag, normalFix, verts+o,norms+o);
-            else            /* only need to regen vertices */
-                o += evalBezier(cp,nSubDivs,bern_0, flag, verts+o);
+    /* build vertex index array */
+    if (useWireMode)
+    {
+        /* build vertex indices to draw teapot/teacup/teaspoon as line strips */
+        /* first strips along increasing u, constant v */
+        for (p=0, o=0; p<nPatches; p++)
+        {
+            int idx = nSubDivs*nSubDivs*p;
+            for (c=0; c<nSubDivs; c++)
+                for (r=0; r<nSubDivs; r++, o++)
+                    vertIdxs[o] = idx+r*nSubDivs+c;
         }
-        *lastScale = scale;
 
-        if (!*inited)
+        /* then strips along increasing v, constant u */
+        for (p=0; p<nPatches; p++) /* don't reset o, we continue appending! */
         {
-            int r,c;
-            /* generate texture coordinates if solid teapot/teacup/teaspoon */
-            if (!useWireMode)
+            int idx = nSubDivs*nSubDivs*p;
+            for (r=0; r<nSubDivs; r++)
             {
-                /* generate for first patch */
-                for (r=0,o=0; r<nSubDivs; r++)
-                {
-                    GLfloat u = r/(nSubDivs-1.f);
-                    for (c=0; c<nSubDivs; c++, o+=2)
-                    {
-                        GLfloat v = c/(nSubDivs-1.f);
-                        texcs[o+0] = u;
-                        texcs[o+1] = v;
-                    }
-                }
-                /* copy it over for all the other patches */
-                for (p=1; p<nPatches; p++)
-                    memcpy(texcs+p*nSubDivs*nSubDivs*2,texcs,nSubDivs*nSubDivs*2*sizeof(GLfloat));
+                int loc = r*nSubDivs;
+                for (c=0; c<nSubDivs; c++, o++)
+                    vertIdxs[o] = idx+loc+c;
             }
+        }
 
-            /* build vertex index array */
-            if (useWireMode)
+        mesh->VertexMode     = GL_LINE_STRIP;
+        mesh->NumParts       = nPatches*nSubDivs*2;
+        mesh->NumVertPerPart = nSubDivs;
+    }
+    else
+    {
+        /* build vertex indices to draw teapot/teacup/teaspoon as triangles */
+        for (p=0,o=0; p<nPatches; p++)
+        {
+            int idx = nSubDivs*nSubDivs*p;
+            for (r=0; r<nSubDivs-1; r++)
             {
-                /* build vertex indices to draw teapot/teacup/teaspoon as line strips */
-                /* first strips along increasing u, constant v */
-                for (p=0, o=0; p<nPatches; p++)
+                int loc = r*nSubDivs;
+                for (c=0; c<nSubDivs-1; c++, o+=6)
                 {
-                    int idx = nSubDivs*nSubDivs*p;
-                    for (c=0; c<nSubDivs; c++)
-                        for (r=0; r<nSubDivs; r++, o++)
-                            vertIdxs[o] = idx+r*nSubDivs+c;
-                }
+                    /* ABC ACD, where B and C are one row lower */
+                    int row1 = idx+loc+c;
+                    int row2 = row1+nSubDivs;
 
-                /* then strips along increasing v, constant u */
-                for (p=0; p<nPatches; p++) /* don't reset o, we continue appending! */
-                {
-                    int idx = nSubDivs*nSubDivs*p;
-                    for (r=0; r<nSubDivs; r++)
-                    {
-                        int loc = r*nSubDivs;
-                        for (c=0; c<nSubDivs; c++, o++)
-                            vertIdxs[o] = idx+loc+c;
-                    }
-                }
-            }
-            else
-            {
-                /* build vertex indices to draw teapot/teacup/teaspoon as triangles */
-                for (p=0,o=0; p<nPatches; p++)
-                {
-                    int idx = nSubDivs*nSubDivs*p;
-                    for (r=0; r<nSubDivs-1; r++)
-                    {
-                        int loc = r*nSubDivs;
-                        for (c=0; c<nSubDivs-1; c++, o+=6)
-                        {
-                            /* ABC ACD, where B and C are one row lower */
-                            int row1 = idx+loc+c;
-                            int row2 = row1+nSubDivs;
-
-                            vertIdxs[o+0] = row1+0;
-                            vertIdxs[o+1] = row2+0;
-                            vertIdxs[o+2] = row2+1;
-
-                            vertIdxs[o+3] = row1+0;
-                            vertIdxs[o+4] = row2+1;
-                            vertIdxs[o+5] = row1+1;
-                        }
-                    }
+                    vertIdxs[o+0] = row1+0;
+                    vertIdxs[o+1] = row2+0;
+                    vertIdxs[o+2] = row2+1;
+
+                    vertIdxs[o+3] = row1+0;
+                    vertIdxs[o+4] = row2+1;
+                    vertIdxs[o+5] = row1+1;
                 }
             }
-
-            *inited = GL_TRUE;
         }
+
+        mesh->NumParts       = 1;
+        mesh->NumVertPerPart = nTriangles*3;
     }
 
-    /* draw */
-    if (useWireMode)
-        fghDrawGeometryWire (verts, norms,        nVerts, vertIdxs, nPatches*nSubDivs*2, nSubDivs, GL_LINE_STRIP, NULL,0,0);
-    else
-        fghDrawGeometrySolid(verts, norms, texcs, nVerts, vertIdxs,1,nTriangles*3);
+    mesh->Vertices    = verts;
+    mesh->Normals     = norms;
+    mesh->Texcs       = texcs;
+    mesh->NumVertices = nVerts;
+    mesh->VertIdxs    = vertIdxs;
+}
+
+static void fghTeaset( int shape, GLfloat scale, GLboolean useWireMode )
+{
+    SFG_GeometryKey key, meshKey;
+    SFG_GeometryMesh **mesh;
+    GLfloat unitScale = (GLfloat)fabs(scale);
+    int nSubDivs = fgState.TeasetSubdivisions;
+
+    /* the number of subdivisions can be chosen with GLUT_TEASET_SUBDIVISIONS */
+    if (nSubDivs == 0)
+        nSubDivs = useWireMode ? GLUT_WIRE_N_SUBDIV : GLUT_SOLID_N_SUBDIV;
+    else if (nSubDivs < 2)
+        nSubDivs = 2;
+    else if (nSubDivs > GLUT_TEASET_MAX_N_SUBDIV)
+        nSubDivs = GLUT_TEASET_MAX_N_SUBDIV;
+
+    /* Only the magnitude of the scale is factored out, see fghUnitScale */
+    if (unitScale == 0.f)
+        unitScale = 1.f;
+
+    fghInitGeometryKey(&key,     shape, useWireMode, nSubDivs, 0, scale,           0.f, 0.f, 0.f);
+    fghInitGeometryKey(&meshKey, shape, useWireMode, nSubDivs, 0, scale/unitScale, 0.f, 0.f, 0.f);
+
+    mesh = &teasetMeshes[shape - FGH_SHAPE_TEAPOT][useWireMode ? 1 : 0][scale < 0.f ? 1 : scale > 0.f ? 0 : 2][nSubDivs];
+    if (!*mesh)
+    {
+        /* zeroed, so fghDrawPinnedShape generates it */
+        *mesh = calloc(1, sizeof(SFG_GeometryMesh));
+        if (!*mesh)
+            fgError("Failed to allocate memory in fghTeaset");
+    }
+
+    fghDrawPinnedShape(&key, &meshKey, *mesh, unitScale, unitScale, unitScale, fghGenerateTeasetMesh);
+}
+
+void fgFreeTeasetMeshes( void )
+{
+    SFG_GeometryMesh **mesh = &teasetMeshes[0][0][0][0];
+    int i;
+
+    for (i=0; i<(int)(sizeof(teasetMeshes)/sizeof(teasetMeshes[0][0][0][0])); i++)
+        if (mesh[i])
+        {
+            fghFreeGeometryMeshArrays(mesh[i]);
+            free(mesh[i]);
+            mesh[i] = NULL;
+        }
 }
 
 
@@ -481,13 +462,7 @@ static void fghTeaset( GLfloat scale, GLboolean useWireMode,
 void FGAPIENTRY glutWireTeapot( double size )
 {
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutWireTeapot" );
-    fghTeaset( (GLfloat)size, GL_TRUE,
-               cpdata_teapot, patchdata_teapot,
-               vertIdxsTeapotW,
-               vertsTeapotW, normsTeapotW, NULL,
-               &lastScaleTeapotW, &initedTeapotW,
-               GL_TRUE, GL_TRUE, 1.575f,
-               GLUT_WIRE_TEAPOT_N_VERT, GLUT_TEAPOT_N_INPUT_PATCHES, GLUT_TEAPOT_N_PATCHES, 0);
+    fghTeaset( FGH_SHAPE_TEAPOT, (GLfloat)size, GL_TRUE );
 }
 
 /*
@@ -496,13 +471,7 @@ void FGAPIENTRY glutWireTeapot( double size )
 void FGAPIENTRY glutSolidTeapot( double size )
 {
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutSolidTeapot" );
-    fghTeaset( (GLfloat)size, GL_FALSE,
-               cpdata_teapot, patchdata_teapot,
-               vertIdxsTeapotS,
-               vertsTeapotS, normsTeapotS, texcsTeapotS,
-               &lastScaleTeapotS, &initedTeapotS,
-               GL_TRUE, GL_TRUE, 1.575f,
-               GLUT_SOLID_TEAPOT_N_VERT, GLUT_TEAPOT_N_INPUT_PATCHES, GLUT_TEAPOT_N_PATCHES, GLUT_SOLID_TEAPOT_N_TRI);
+    fghTeaset( FGH_SHAPE_TEAPOT, (GLfloat)size, GL_FALSE );
 }
 
 
@@ -512,13 +481,7 @@ void FGAPIENTRY glutSolidTeapot( double size )
 void FGAPIENTRY glutWireTeacup( double size )
 {
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutWireTeacup" );
-    fghTeaset( (GLfloat)size/2.5f, GL_TRUE,
-               cpdata_teacup, patchdata_teacup,
-               vertIdxsTeacupW,
-               vertsTeacupW, normsTeacupW, NULL,
-               &lastScaleTeacupW, &initedTeacupW,
-               GL_FALSE, GL_TRUE, 1.5121f,
-               GLUT_WIRE_TEACUP_N_VERT, GLUT_TEACUP_N_INPUT_PATCHES, GLUT_TEACUP_N_PATCHES, 0);
+    fghTeaset( FGH_SHAPE_TEACUP, (GLfloat)size/2.5f, GL_TRUE );
 }
 
 /*
@@ -527,13 +490,7 @@ void FGAPIENTRY glutWireTeacup( double size )
 void FGAPIENTRY glutSolidTeacup( double size )
 {
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutSolidTeacup" );
-    fghTeaset( (GLfloat)size/2.5f, GL_FALSE,
-               cpdata_teacup, patchdata_teacup,
-               vertIdxsTeacupS,
-               vertsTeacupS, normsTeacupS, texcsTeacupS,
-               &lastScaleTeacupS, &initedTeacupS,
-               GL_FALSE, GL_TRUE, 1.5121f,
-               GLUT_SOLID_TEACUP_N_VERT, GLUT_TEACUP_N_INPUT_PATCHES, GLUT_TEACUP_N_PATCHES, GLUT_SOLID_TEACUP_N_TRI);
+    fghTeaset( FGH_SHAPE_TEACUP, (GLfloat)size/2.5f, GL_FALSE );
 }
 
 
@@ -543,13 +500,7 @@ void FGAPIENTRY glutSolidTeacup( double size )
 void FGAPIENTRY glutWireTeaspoon( double size )
 {
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutWireTeaspoon" );
-    fghTeaset( (GLfloat)size/2.5f, GL_TRUE,
-               cpdata_teaspoon, patchdata_teaspoon,
-               vertIdxsTeaspoonW,
-               vertsTeaspoonW, normsTeaspoonW, NULL,
-               &lastScaleTeaspoonW, &initedTeaspoonW,
-               GL_FALSE, GL_FALSE, -0.0315f,
-               GLUT_WIRE_TEASPOON_N_VERT, GLUT_TEASPOON_N_INPUT_PATCHES, GLUT_TEASPOON_N_PATCHES, 0);
+    fghTeaset( FGH_SHAPE_TEASPOON, (GLfloat)size/2.5f, GL_TRUE );
 }
 
 /*
@@ -558,13 +509,7 @@ void FGAPIENTRY glutWireTeaspoon( double size )
 void FGAPIENTRY glutSolidTeaspoon( double size )
 {
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutSolidTeaspoon" );
-    fghTeaset( (GLfloat)size/2.5f, GL_FALSE,
-               cpdata_teaspoon, patchdata_teaspoon,
-               vertIdxsTeaspoonS,
-               vertsTeaspoonS, normsTeaspoonS, texcsTeaspoonS,
-               &lastScaleTeaspoonS, &initedTeaspoonS,
-               GL_FALSE, GL_FALSE, -0.0315f,
-               GLUT_SOLID_TEASPOON_N_VERT, GLUT_TEASPOON_N_INPUT_PATCHES, GLUT_TEASPOON_N_PATCHES, GLUT_SOLID_TEASPOON_N_TRI);
+    fghTeaset( FGH_SHAPE_TEASPOON, (GLfloat)size/2.5f, GL_FALSE );
 }
 
 /*** END OF FILE ***/
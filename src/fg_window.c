@@ -117,6 +117,20 @@ void fgSetWindow ( SFG_Window *window )
     fgStructure.CurrentWindow = window;
 }
 
+/*
+ * Switches back to a window after freeglut temporarily made another one
+ * current. With GLUT_DEFER_CONTEXT_RESTORE, only the "Current Window"
+ * pointer is restored: its context is made current again by the next
+ * fgSetWindow, which happens before any user code gets to run.
+ */
+void fgRestoreWindow ( SFG_Window *window )
+{
+    if( fgState.DeferContextRestore )
+        fgStructure.CurrentWindow = window;
+    else
+        fgSetWindow( window );
+}
+
 /*
  * Opens a window. Requires a SFG_Window object created and attached
  * to the freeglut structure. OpenGL context is created here.
@@ -150,10 +164,11 @@ void fgOpenWindow( SFG_Window* window, const char* title,
     window->Window.attribute_v_coord = -1;
     window->Window.attribute_v_normal = -1;
     window->Window.attribute_v_texture = -1;
+    window->Window.attribute_v_instance = -1;
 
     fgInitGL2();
 
-    window->State.WorkMask |= GLUT_INIT_WORK;
+    fgPostWork( window, GLUT_INIT_WORK );
 }
 
 /*
@@ -281,7 +296,12 @@ void FGAPIENTRY glutSetWindow( int ID )
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutSetWindow" );
     if( fgStructure.CurrentWindow != NULL )
         if( fgStructure.CurrentWindow->ID == ID )
+        {
+            /* Its context may not be current, see fgRestoreWindow */
+            if( fgState.DeferContextRestore )
+                fgSetWindow( fgStructure.CurrentWindow );
             return;
+        }
 
     window = fgWindowByID( ID );
     if( window == NULL )
@@ -307,6 +327,10 @@ int FGAPIENTRY glutGetWindow( void )
     if ( ! fgState.Initialised )
         return 0;
 
+    /* Make its context current, see fgRestoreWindow */
+    if( fgState.DeferContextRestore && win )
+        fgSetWindow( win );
+
     while ( win && win->IsMenu )
         win = win->Parent;
     return win ? win->ID : 0;
@@ -320,10 +344,10 @@ void FGAPIENTRY glutShowWindow( void )
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutShowWindow" );
     FREEGLUT_EXIT_IF_NO_WINDOW ( "glutShowWindow" );
 
-    fgStructure.CurrentWindow->State.WorkMask |= GLUT_VISIBILITY_WORK;
+    fgPostWork( fgStructure.CurrentWindow, GLUT_VISIBILITY_WORK );
     fgStructure.CurrentWindow->State.DesiredVisibility = DesireNormalState;
 
-    fgStructure.CurrentWindow->State.WorkMask |= GLUT_DISPLAY_WORK;
+    fgPostWork( fgStructure.CurrentWindow, GLUT_DISPLAY_WORK );
 }
 
 /*
@@ -334,7 +358,7 @@ void FGAPIENTRY glutHideWindow( void )
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutHideWindow" );
     FREEGLUT_EXIT_IF_NO_WINDOW ( "glutHideWindow" );
 
-    fgStructure.CurrentWindow->State.WorkMask |= GLUT_VISIBILITY_WORK;
+    fgPostWork( fgStructure.CurrentWindow, GLUT_VISIBILITY_WORK );
     fgStructure.CurrentWindow->State.DesiredVisibility = DesireHiddenState;
 
     fgStructure.CurrentWindow->State.WorkMask &= ~GLUT_DISPLAY_WORK;
@@ -348,7 +372,7 @@ void FGAPIENTRY glutIconifyWindow( void )
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutIconifyWindow" );
     FREEGLUT_EXIT_IF_NO_WINDOW ( "glutIconifyWindow" );
 
-    fgStructure.CurrentWindow->State.WorkMask |= GLUT_VISIBILITY_WORK;
+    fgPostWork( fgStructure.CurrentWindow, GLUT_VISIBILITY_WORK );
     fgStructure.CurrentWindow->State.DesiredVisibility = DesireIconicState;
 
     fgStructure.CurrentWindow->State.WorkMask &= ~GLUT_DISPLAY_WORK;
@@ -395,7 +419,7 @@ void FGAPIENTRY glutReshapeWindow( int width, int height )
       glutLeaveFullScreen();
     }
 
-    fgStructure.CurrentWindow->State.WorkMask |= GLUT_SIZE_WORK;
+    fgPostWork( fgStructure.CurrentWindow, GLUT_SIZE_WORK );
     fgStructure.CurrentWindow->State.DesiredWidth  = width ;
     fgStructure.CurrentWindow->State.DesiredHeight = height;
 }
@@ -414,7 +438,7 @@ void FGAPIENTRY glutPositionWindow( int x, int y )
       glutLeaveFullScreen();
     }
 
-    fgStructure.CurrentWindow->State.WorkMask |= GLUT_POSITION_WORK;
+    fgPostWork( fgStructure.CurrentWindow, GLUT_POSITION_WORK );
     fgStructure.CurrentWindow->State.DesiredXpos = x;
     fgStructure.CurrentWindow->State.DesiredYpos = y;
 }
@@ -427,7 +451,7 @@ void FGAPIENTRY glutPushWindow( void )
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutPushWindow" );
     FREEGLUT_EXIT_IF_NO_WINDOW ( "glutPushWindow" );
 
-    fgStructure.CurrentWindow->State.WorkMask |= GLUT_ZORDER_WORK;
+    fgPostWork( fgStructure.CurrentWindow, GLUT_ZORDER_WORK );
     fgStructure.CurrentWindow->State.DesiredZOrder = -1;
 }
 
@@ -439,7 +463,7 @@ void FGAPIENTRY glutPopWindow( void )
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutPopWindow" );
     FREEGLUT_EXIT_IF_NO_WINDOW ( "glutPopWindow" );
 
-    fgStructure.CurrentWindow->State.WorkMask |= GLUT_ZORDER_WORK;
+    fgPostWork( fgStructure.CurrentWindow, GLUT_ZORDER_WORK );
     fgStructure.CurrentWindow->State.DesiredZOrder = 1;
 }
 
@@ -473,7 +497,7 @@ void FGAPIENTRY glutFullScreen( void )
     }
 
     if (!win->State.IsFullscreen)
-        win->State.WorkMask |= GLUT_FULL_SCREEN_WORK;
+        fgPostWork( win, GLUT_FULL_SCREEN_WORK );
 }
 
 /*
@@ -485,7 +509,7 @@ void FGAPIENTRY glutLeaveFullScreen( void )
     FREEGLUT_EXIT_IF_NO_WINDOW ( "glutFullScreen" );
 
     if (fgStructure.CurrentWindow->State.IsFullscreen)
-        fgStructure.CurrentWindow->State.WorkMask |= GLUT_FULL_SCREEN_WORK;
+        fgPostWork( fgStructure.CurrentWindow, GLUT_FULL_SCREEN_WORK );
 }
 
 /*
@@ -496,7 +520,7 @@ void FGAPIENTRY glutFullScreenToggle( void )
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutFullScreenToggle" );
     FREEGLUT_EXIT_IF_NO_WINDOW ( "glutFullScreenToggle" );
 
-    fgStructure.CurrentWindow->State.WorkMask |= GLUT_FULL_SCREEN_WORK;
+    fgPostWork( fgStructure.CurrentWindow, GLUT_FULL_SCREEN_WORK );
 }
 
 /*
@@ -10,6 +10,7 @@ void fgDeactivateMenu( SFG_Window *window ) {
 void fgDisplayMenu( void ) {
   fprintf(stderr, "fgDisplayMenu: STUB\n");
 }
+void fgFreeMenuDisplayLists( SFG_Menu *menu ) {}
 void fgUpdateMenuHighlight ( SFG_Menu *menu ) {
   fprintf(stderr, "fgUpdateMenuHighlight: STUB\n");
 }
@@ -50,3 +51,13 @@ int     glutBitmapHeight( void* font ) { return 0; }
 GLfloat glutStrokeHeight( void* font ) { return 0; }
 void    glutBitmapString( void* font, const unsigned char *string ) {}
 void    glutStrokeString( void* font, const unsigned char *string ) {}
+
+int     glutPrepareString( void* font, const unsigned char *string ) { return 0; }
+void    glutDestroyPreparedString( int string ) {}
+void    glutDrawPreparedString( int string ) {}
+GLfloat glutPreparedStringWidth( int string ) { return 0.0f; }
+int     glutPreparedStringLines( int string ) { return 0; }
+
+void fgFreeFontAtlases( SFG_Window* window ) {}
+void fgFreeStrokeFontLines( void ) {}
+void fgFreePreparedStrings( void ) {}
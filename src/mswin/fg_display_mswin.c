@@ -31,7 +31,65 @@
 
 
 
+/* From WGL_EXT_swap_control, see the note about wglext.h in fg_window_mswin.c */
+typedef const char * (WINAPI * PFNWGLGETEXTENSIONSSTRINGARBPROC) (HDC hdc);
+typedef BOOL (WINAPI * PFNWGLSWAPINTERVALEXTPROC) (int interval);
+typedef int (WINAPI * PFNWGLGETSWAPINTERVALEXTPROC) (void);
+
+
 void fgPlatformGlutSwapBuffers( SFG_PlatformDisplay *pDisplayPtr, SFG_Window* CurrentWindow )
 {
     SwapBuffers( CurrentWindow->Window.pContext.Device );
 }
+
+/* WGL has no way to pass the damage on, so the whole window gets swapped */
+void fgPlatformGlutSwapBuffersWithDamage( SFG_PlatformDisplay *pDisplayPtr, SFG_Window* CurrentWindow, const int *rects, int n )
+{
+    fgPlatformGlutSwapBuffers( pDisplayPtr, CurrentWindow );
+}
+
+/* The back buffer's contents are undefined after SwapBuffers */
+int fgPlatformGetBufferAge( SFG_Window *window )
+{
+    return 0;
+}
+
+/*
+ * Sets the swap interval of a window, whose context is current. Negative
+ * intervals, for late swaps to tear, need WGL_EXT_swap_control_tear and
+ * become positive ones without it.
+ */
+GLboolean fgPlatformSwapInterval( SFG_Window *window, int *interval )
+{
+    PFNWGLSWAPINTERVALEXTPROC wglSwapIntervalEXT =
+      (PFNWGLSWAPINTERVALEXTPROC) wglGetProcAddress("wglSwapIntervalEXT");
+
+    if ( wglSwapIntervalEXT == NULL )
+        return GL_FALSE;
+
+    if ( *interval < 0 )
+    {
+        PFNWGLGETEXTENSIONSSTRINGARBPROC wglGetExtensionsStringARB =
+          (PFNWGLGETEXTENSIONSSTRINGARBPROC) wglGetProcAddress("wglGetExtensionsStringARB");
+        const char *pWglExtString = wglGetExtensionsStringARB ?
+            wglGetExtensionsStringARB( window->Window.pContext.Device ) : NULL;
+
+        if ( pWglExtString == NULL || strstr( pWglExtString, "WGL_EXT_swap_control_tear" ) == NULL )
+            *interval = -*interval;
+    }
+
+    return wglSwapIntervalEXT( *interval ) ? GL_TRUE : GL_FALSE;
+}
+
+/*
+ * Returns the swap interval the window's context really has
+ */
+int fgPlatformGetSwapInterval( SFG_Window *window )
+{
+    PFNWGLGETSWAPINTERVALEXTPROC wglGetSwapIntervalEXT =
+      (PFNWGLGETSWAPINTERVALEXTPROC) wglGetProcAddress("wglGetSwapIntervalEXT");
+
+    if ( wglGetSwapIntervalEXT == NULL )
+        return window->State.SwapInterval;
+    return wglGetSwapIntervalEXT( );
+}
@@ -120,6 +120,7 @@ void fgPlatformInitialize( const char* displayName )
     fgPlatformInitSystemTime();
     /* Get start time */
     fgState.Time = fgSystemTime();
+    fgState.TimeNs = fgSystemTimeNs();
 
 
     fgState.Initialised = GL_TRUE;
@@ -480,10 +480,30 @@ fg_time_t fgPlatformSystemTime ( void )
     return currTime32 | timeEpoch << 32;
 }
 
+/* Time in nanoseconds from the performance counter. This is the timebase
+ * of the timers and of GLUT_ELAPSED_TIME_NS, as well as the frame statistics */
+fg_time_t fgPlatformSystemTimeNs ( void )
+{
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+
+    if (!frequency.QuadPart)
+        QueryPerformanceFrequency( &frequency );
+    QueryPerformanceCounter( &counter );
+
+    /* Split to avoid overflowing the multiplication */
+    return (fg_time_t)(counter.QuadPart / frequency.QuadPart) * 1000000000 +
+           (fg_time_t)(counter.QuadPart % frequency.QuadPart) * 1000000000 / frequency.QuadPart;
+}
+
 
-void fgPlatformSleepForEvents( fg_time_t msec )
+void fgPlatformSleepForEvents( fg_time_t nsec )
 {
-    MsgWaitForMultipleObjects( 0, NULL, FALSE, (DWORD) msec, QS_ALLINPUT );
+    /* Round up to whole milliseconds, so we don't wake before the next
+     * timer is due */
+    DWORD msec = (DWORD)( ( nsec + 999999 ) / 1000000 );
+
+    MsgWaitForMultipleObjects( 0, NULL, FALSE, msec, QS_ALLINPUT );
 }
 
 
@@ -1080,7 +1100,7 @@ LRESULT CALLBACK fgPlatformWindowProc( HWND hWnd, UINT uMsg, WPARAM wParam, LPAR
         if (wParam)
         {
             fghPlatformOnWindowStatusNotify(window, GL_TRUE, GL_FALSE);
-            window->State.WorkMask |= GLUT_DISPLAY_WORK;
+            fgPostWork( window, GLUT_DISPLAY_WORK );
         }
         else
         {
@@ -1106,7 +1126,7 @@ LRESULT CALLBACK fgPlatformWindowProc( HWND hWnd, UINT uMsg, WPARAM wParam, LPAR
             BeginPaint( hWnd, &ps );
             EndPaint( hWnd, &ps );
 
-            window->State.WorkMask |= GLUT_DISPLAY_WORK;
+            fgPostWork( window, GLUT_DISPLAY_WORK );
         }
         lRet = 0;   /* As per docs, should return 0 */
     }
@@ -1150,11 +1170,11 @@ LRESULT CALLBACK fgPlatformWindowProc( HWND hWnd, UINT uMsg, WPARAM wParam, LPAR
         if( ( wParam & MK_LBUTTON ) ||
             ( wParam & MK_MBUTTON ) ||
             ( wParam & MK_RBUTTON ) )
-            INVOKE_WCB( *window, Motion, ( window->State.MouseX,
-                                           window->State.MouseY ) );
+            fgCoalesceEvent( window, FG_EVENT_MOTION, 0, window->State.MouseX,
+                             window->State.MouseY, 0 );
         else
-            INVOKE_WCB( *window, Passive, ( window->State.MouseX,
-                                            window->State.MouseY ) );
+            fgCoalesceEvent( window, FG_EVENT_PASSIVE, 0, window->State.MouseX,
+                             window->State.MouseY, 0 );
 
         fgState.Modifiers = INVALID_MODIFIERS;
     }
@@ -1398,7 +1418,7 @@ LRESULT CALLBACK fgPlatformWindowProc( HWND hWnd, UINT uMsg, WPARAM wParam, LPAR
 #if !defined(_WIN32_WCE)
     case WM_SYNCPAINT:  /* 0x0088 */
         /* Another window has moved, need to update this one */
-        window->State.WorkMask |= GLUT_DISPLAY_WORK;
+        fgPostWork( window, GLUT_DISPLAY_WORK );
         lRet = DefWindowProc( hWnd, uMsg, wParam, lParam );
         /* Help screen says this message must be passed to "DefWindowProc" */
         break;
@@ -1532,7 +1552,7 @@ LRESULT CALLBACK fgPlatformWindowProc( HWND hWnd, UINT uMsg, WPARAM wParam, LPAR
                     INVOKE_WCB( *window, MultiEntry,  ( ti[i].dwID, GLUT_ENTERED ) );
                     INVOKE_WCB( *window, MultiButton, ( ti[i].dwID, tp.x, tp.y, 0, GLUT_DOWN ) );
                 } else if (ti[i].dwFlags & TOUCHEVENTF_MOVE) {
-                    INVOKE_WCB( *window, MultiMotion, ( ti[i].dwID, tp.x, tp.y ) );
+                    fgCoalesceEvent( window, FG_EVENT_MULTI_MOTION, ti[i].dwID, tp.x, tp.y, 0 );
                 } else if (ti[i].dwFlags & TOUCHEVENTF_UP)   {
                     INVOKE_WCB( *window, MultiButton, ( ti[i].dwID, tp.x, tp.y, 0, GLUT_UP ) );
                     INVOKE_WCB( *window, MultiEntry,  ( ti[i].dwID, GLUT_LEFT ) );
@@ -1665,7 +1685,7 @@ void fgPlatformPosResZordWork(SFG_Window* window, unsigned int workMask)
             rect = mi.rcMonitor;
 
             /* then setup window resize, overwriting other work queued on the window */
-            window->State.WorkMask |= GLUT_POSITION_WORK | GLUT_SIZE_WORK;
+            fgPostWork( window, GLUT_POSITION_WORK | GLUT_SIZE_WORK );
             window->State.WorkMask &= ~GLUT_ZORDER_WORK;
             window->State.DesiredXpos   = rect.left;
             window->State.DesiredYpos   = rect.top;
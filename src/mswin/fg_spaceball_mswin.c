@@ -194,7 +194,7 @@ void fgSpaceballHandleWinEvent(HWND hwnd, WPARAM wParam, LPARAM lParam)
             x = dataptr[0];
             y = -dataptr[2];
             z = dataptr[1];
-            INVOKE_WCB(*window, SpaceMotion, (x, y, z));
+            fgCoalesceEvent(window, FG_EVENT_SPACE_MOTION, 0, x, y, z);
             break;
 
         case SPNAV_EVENT_MOTION_ROTATION:
@@ -203,7 +203,7 @@ void fgSpaceballHandleWinEvent(HWND hwnd, WPARAM wParam, LPARAM lParam)
             x = dataptr[0];
             y = -dataptr[2];
             z = dataptr[1];
-            INVOKE_WCB(*window, SpaceRotation, (x, y, z));
+            fgCoalesceEvent(window, FG_EVENT_SPACE_ROTATION, 0, x, y, z);
 
         case SPNAV_EVENT_BUTTON:
             /* State of the keys */
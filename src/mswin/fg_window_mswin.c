@@ -349,20 +349,27 @@ end:
 
 void fgPlatformSetWindow ( SFG_Window *window )
 {
-    if ( window != fgStructure.CurrentWindow )
-    {
-        if( fgStructure.CurrentWindow )
-            ReleaseDC( fgStructure.CurrentWindow->Window.Handle,
-                       fgStructure.CurrentWindow->Window.pContext.Device );
+    /*
+     * Nothing to do if the window's context is current already. This is
+     * checked on the thread's actual context rather than on
+     * fgStructure.CurrentWindow, see GLUT_DEFER_CONTEXT_RESTORE.
+     */
+    if ( window && window->Window.pContext.Device &&
+         wglGetCurrentContext( ) == window->Window.Context &&
+         wglGetCurrentDC( ) == window->Window.pContext.Device )
+        return;
 
-        if ( window )
-        {
-            window->Window.pContext.Device = GetDC( window->Window.Handle );
-            wglMakeCurrent(
-                window->Window.pContext.Device,
-                window->Window.Context
-            );
-        }
+    if ( window != fgStructure.CurrentWindow && fgStructure.CurrentWindow )
+        ReleaseDC( fgStructure.CurrentWindow->Window.Handle,
+                   fgStructure.CurrentWindow->Window.pContext.Device );
+
+    if ( window )
+    {
+        window->Window.pContext.Device = GetDC( window->Window.Handle );
+        wglMakeCurrent(
+            window->Window.pContext.Device,
+            window->Window.Context
+        );
     }
 }
 
@@ -111,5 +111,33 @@ void fgOgcDisplayShowEFB()
 void fgPlatformGlutSwapBuffers(SFG_PlatformDisplay *pDisplayPtr,
                                SFG_Window *CurrentWindow)
 {
+    /* Copying the EFB out doesn't flush the GL commands for us */
+    glFlush();
     fgOgcDisplayShowEFB();
 }
+
+void fgPlatformGlutSwapBuffersWithDamage(SFG_PlatformDisplay *pDisplayPtr,
+                                         SFG_Window *CurrentWindow,
+                                         const int *rects, int n)
+{
+    /* The whole EFB is always copied out */
+    fgPlatformGlutSwapBuffers(pDisplayPtr, CurrentWindow);
+}
+
+int fgPlatformGetBufferAge(SFG_Window *window)
+{
+    /* The EFB is cleared as it's copied to a double buffered display */
+    return 0;
+}
+
+GLboolean fgPlatformSwapInterval(SFG_Window *window, int *interval)
+{
+    /* Swaps always wait for the vertical retrace, see fgOgcDisplayShowEFB */
+    *interval = 1;
+    return GL_FALSE;
+}
+
+int fgPlatformGetSwapInterval(SFG_Window *window)
+{
+    return 1;
+}
@@ -43,6 +43,7 @@ void fgPlatformInitialize(const char *displayName)
     fatInitDefault();
 
     fgState.Time = fgSystemTime();
+    fgState.TimeNs = fgSystemTimeNs();
     fgState.FPSInterval = 2000;
     fgState.Initialised = GL_TRUE;
 }
@@ -189,11 +189,11 @@ static void updateMouse()
 
     if (oldX != window->State.MouseX || oldY != window->State.MouseY) {
         if (buttonPressed) {
-            INVOKE_WCB(*window, Motion, (window->State.MouseX,
-                                         window->State.MouseY));
+            fgCoalesceEvent(window, FG_EVENT_MOTION, 0, window->State.MouseX,
+                            window->State.MouseY, 0);
         } else {
-            INVOKE_WCB(*window, Passive, (window->State.MouseX,
-                                          window->State.MouseY));
+            fgCoalesceEvent(window, FG_EVENT_PASSIVE, 0, window->State.MouseX,
+                            window->State.MouseY, 0);
         }
     }
 }
@@ -204,7 +204,12 @@ fg_time_t fgPlatformSystemTime(void)
     return gettime() / TB_TIMER_CLOCK;
 }
 
-void fgPlatformSleepForEvents(fg_time_t ms)
+fg_time_t fgPlatformSystemTimeNs(void)
+{
+    return ticks_to_nanosecs(gettime());
+}
+
+void fgPlatformSleepForEvents(fg_time_t ns)
 {
     /* FreeGlut does not offer a hook for redrawing the window in single-buffer
      * mode, so let's to it here. */
@@ -215,15 +220,15 @@ void fgPlatformSleepForEvents(fg_time_t ms)
     /* If the mouse is active, reduce the sleep time to a few milliseconds
      * only, since our mouse is emulated via the Wiimote, which must be
      * regularly polled */
-    if (ms > 10 && fgStructure.CurrentWindow &&
+    if (ns > 10000000 && fgStructure.CurrentWindow &&
         (FETCH_WCB(*fgStructure.CurrentWindow, Motion) ||
          FETCH_WCB(*fgStructure.CurrentWindow, Mouse))) {
-        ms = 10;
+        ns = 10000000;
     }
 
     struct timespec tv;
-    tv.tv_sec = ms / 1000;
-    tv.tv_nsec = (ms % 1000) * 1000000;
+    tv.tv_sec = ns / 1000000000;
+    tv.tv_nsec = ns % 1000000000;
     nanosleep(&tv, NULL);
 }
 
@@ -101,6 +101,7 @@ void fgPlatformInitialize( const char* displayName )
 
     /* Get start time */
     fgState.Time = fgSystemTime();
+    fgState.TimeNs = fgSystemTimeNs();
 
     fgState.Initialised = GL_TRUE;
 
@@ -179,8 +179,8 @@ static void fghTouchMotion( void* data, struct wl_touch* touch,
     SFG_Window* win = fgStructure.CurrentWindow;
     win->State.MouseX = wl_fixed_to_int( x_w );
     win->State.MouseY = wl_fixed_to_int( y_w );
-    INVOKE_WCB( *win, Motion, ( win->State.MouseX,
-                                win->State.MouseY ) );
+    fgCoalesceEvent( win, FG_EVENT_MOTION, 0, win->State.MouseX,
+                     win->State.MouseY, 0 );
 }
 static void fghTouchFrame( void* data, struct wl_touch* touch )
 {
@@ -228,11 +228,11 @@ static void fghPointerMotion( void* data, struct wl_pointer* pointer,
     win->State.MouseY = wl_fixed_to_int( y_w );
 
     if ( win->Window.pContext.pointer_button_pressed )
-      INVOKE_WCB( *win, Motion, ( win->State.MouseX,
-                                  win->State.MouseY ) );
+      fgCoalesceEvent( win, FG_EVENT_MOTION, 0, win->State.MouseX,
+                       win->State.MouseY, 0 );
     else
-      INVOKE_WCB( *win, Passive, ( win->State.MouseX,
-                                   win->State.MouseY ) );
+      fgCoalesceEvent( win, FG_EVENT_PASSIVE, 0, win->State.MouseX,
+                       win->State.MouseY, 0 );
 }
 static void fghPointerButton( void* data, struct wl_pointer* pointer,
                               uint32_t serial, uint32_t time,
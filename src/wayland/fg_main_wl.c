@@ -53,7 +53,22 @@ fg_time_t fgPlatformSystemTime( void )
 #endif
 }
 
-void fgPlatformSleepForEvents( fg_time_t msec )
+/* Same clock in nanoseconds: the timebase of the timers and of
+ * GLUT_ELAPSED_TIME_NS, and of the frame statistics */
+fg_time_t fgPlatformSystemTimeNs( void )
+{
+#ifdef CLOCK_MONOTONIC
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_nsec + now.tv_sec*(fg_time_t)1000000000;
+#elif defined(HAVE_GETTIMEOFDAY)
+    struct timeval now;
+    gettimeofday( &now, NULL );
+    return now.tv_usec*(fg_time_t)1000 + now.tv_sec*(fg_time_t)1000000000;
+#endif
+}
+
+void fgPlatformSleepForEvents( fg_time_t nsec )
 {
     struct pollfd pfd;
     int err;
@@ -64,7 +79,9 @@ void fgPlatformSleepForEvents( fg_time_t msec )
     wl_display_dispatch_pending( fgDisplay.pDisplay.display );
     if ( ! wl_display_flush( fgDisplay.pDisplay.display ) )
     {
-        err = poll( &pfd, 1, msec );
+        /* poll() only takes milliseconds, round up so we don't wake
+         * before the next timer is due */
+        err = poll( &pfd, 1, (int)( ( nsec + 999999 ) / 1000000 ) );
 
         if( ( -1 == err ) && ( errno != EINTR ) )
           fgWarning ( "freeglut poll() error: %d", errno );
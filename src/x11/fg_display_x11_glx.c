@@ -34,3 +34,145 @@ void fgPlatformGlutSwapBuffers( SFG_PlatformDisplay *pDisplayPtr, SFG_Window* Cu
     glXSwapBuffers( pDisplayPtr->Display, CurrentWindow->Window.Handle );
 }
 
+/* GLX has no way to pass the damage on, so the whole window gets swapped */
+void fgPlatformGlutSwapBuffersWithDamage( SFG_PlatformDisplay *pDisplayPtr, SFG_Window* CurrentWindow, const int *rects, int n )
+{
+    fgPlatformGlutSwapBuffers( pDisplayPtr, CurrentWindow );
+}
+
+typedef void (*fghSwapIntervalEXTProc)( Display *dpy, GLXDrawable drawable, int interval );
+typedef int  (*fghSwapIntervalMESAProc)( unsigned int interval );
+typedef int  (*fghGetSwapIntervalMESAProc)( void );
+typedef int  (*fghSwapIntervalSGIProc)( int interval );
+
+/*
+ * The swap control functions of the display they were looked up for, and
+ * whether it can tell back buffer ages.
+ * glXGetProcAddress hands out pointers for functions the display doesn't
+ * support, so they are only looked up for the extensions it lists.
+ */
+static struct
+{
+    Display                    *Display;
+    GLboolean                   Tear;   /* GLX_EXT_swap_control_tear */
+    GLboolean                   BufferAge; /* GLX_EXT_buffer_age     */
+    fghSwapIntervalEXTProc      SwapIntervalEXT;
+    fghSwapIntervalMESAProc     SwapIntervalMESA;
+    fghGetSwapIntervalMESAProc  GetSwapIntervalMESA;
+    fghSwapIntervalSGIProc      SwapIntervalSGI;
+} fghSwapControl;
+
+static GLboolean fghHasGLXExtension( const char *extensions, const char *name )
+{
+    size_t len = strlen( name );
+    const char *p = extensions;
+
+    while( p && ( p = strstr( p, name ) ) != NULL )
+    {
+        if( ( p == extensions || p[ -1 ] == ' ' ) &&
+            ( p[ len ] == ' ' || p[ len ] == '\0' ) )
+            return GL_TRUE;
+        p += len;
+    }
+    return GL_FALSE;
+}
+
+static void fghInitSwapControl( SFG_PlatformDisplay *pDisplayPtr )
+{
+    const char *extensions;
+
+    if( fghSwapControl.Display == pDisplayPtr->Display )
+        return;
+
+    memset( &fghSwapControl, 0, sizeof( fghSwapControl ) );
+    fghSwapControl.Display = pDisplayPtr->Display;
+
+    extensions = glXQueryExtensionsString( pDisplayPtr->Display, pDisplayPtr->Screen );
+    if( fghHasGLXExtension( extensions, "GLX_EXT_swap_control" ) )
+    {
+        fghSwapControl.SwapIntervalEXT = (fghSwapIntervalEXTProc)fgPlatformGetProcAddress( "glXSwapIntervalEXT" );
+        fghSwapControl.Tear = fghHasGLXExtension( extensions, "GLX_EXT_swap_control_tear" );
+    }
+    if( fghHasGLXExtension( extensions, "GLX_MESA_swap_control" ) )
+    {
+        fghSwapControl.SwapIntervalMESA = (fghSwapIntervalMESAProc)fgPlatformGetProcAddress( "glXSwapIntervalMESA" );
+        fghSwapControl.GetSwapIntervalMESA = (fghGetSwapIntervalMESAProc)fgPlatformGetProcAddress( "glXGetSwapIntervalMESA" );
+    }
+    if( fghHasGLXExtension( extensions, "GLX_SGI_swap_control" ) )
+        fghSwapControl.SwapIntervalSGI = (fghSwapIntervalSGIProc)fgPlatformGetProcAddress( "glXSwapIntervalSGI" );
+    fghSwapControl.BufferAge = fghHasGLXExtension( extensions, "GLX_EXT_buffer_age" );
+}
+
+/*
+ * Sets the swap interval of a window, whose context is current, and leaves
+ * the one it really got in *interval. A negative interval asks for late
+ * swaps to tear, which only GLX_EXT_swap_control_tear knows about: elsewhere
+ * it becomes the matching positive interval.
+ */
+GLboolean fgPlatformSwapInterval( SFG_Window *window, int *interval )
+{
+    fghInitSwapControl( &fgDisplay.pDisplay );
+
+    if( *interval < 0 && !fghSwapControl.Tear )
+        *interval = -*interval;
+
+    if( fghSwapControl.SwapIntervalEXT )
+    {
+        fghSwapControl.SwapIntervalEXT( fgDisplay.pDisplay.Display, window->Window.Handle, *interval );
+        return GL_TRUE;
+    }
+    if( fghSwapControl.SwapIntervalMESA )
+        return fghSwapControl.SwapIntervalMESA( *interval ) == 0;
+
+    /* GLX_SGI_swap_control can't turn vsync off */
+    if( fghSwapControl.SwapIntervalSGI && *interval > 0 )
+        return fghSwapControl.SwapIntervalSGI( *interval ) == 0;
+
+    return GL_FALSE;
+}
+
+/*
+ * Returns the swap interval a window really has, negative if late swaps tear
+ */
+int fgPlatformGetSwapInterval( SFG_Window *window )
+{
+    unsigned int value = 0;
+
+    fghInitSwapControl( &fgDisplay.pDisplay );
+
+    if( fghSwapControl.SwapIntervalEXT )
+    {
+        glXQueryDrawable( fgDisplay.pDisplay.Display, window->Window.Handle,
+                          GLX_SWAP_INTERVAL_EXT, &value );
+        if( fghSwapControl.Tear )
+        {
+            unsigned int tear = 0;
+            glXQueryDrawable( fgDisplay.pDisplay.Display, window->Window.Handle,
+                              GLX_LATE_SWAPS_TEAR_EXT, &tear );
+            if( tear )
+                return -( int )value;
+        }
+        return ( int )value;
+    }
+    if( fghSwapControl.GetSwapIntervalMESA )
+        return fghSwapControl.GetSwapIntervalMESA( );
+
+    /* Nothing to ask, so go by what was set */
+    return window->State.SwapInterval;
+}
+
+/*
+ * Returns how many swaps ago the window's back buffer was drawn into, or 0
+ * if its contents can't be relied upon
+ */
+int fgPlatformGetBufferAge( SFG_Window *window )
+{
+    unsigned int age = 0;
+
+    fghInitSwapControl( &fgDisplay.pDisplay );
+
+    if( fghSwapControl.BufferAge )
+        glXQueryDrawable( fgDisplay.pDisplay.Display, window->Window.Handle,
+                          GLX_BACK_BUFFER_AGE_EXT, &age );
+    return ( int )age;
+}
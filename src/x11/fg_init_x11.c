@@ -224,6 +224,9 @@ void fgPlatformInitialize( const char* displayName )
     /* Create the window deletion atom */
     fgDisplay.pDisplay.DeleteWindow = fghGetAtom("WM_DELETE_WINDOW");
 
+    /* And the one for the window decoration sizes, which we follow through PropertyNotify */
+    fgDisplay.pDisplay.NetFrameExtents = fghGetAtom("_NET_FRAME_EXTENTS");
+
     /* Create the state and full screen atoms */
     fgDisplay.pDisplay.State           = None;
     fgDisplay.pDisplay.StateFullScreen = None;
@@ -260,6 +263,7 @@ void fgPlatformInitialize( const char* displayName )
 
     /* Get start time */
     fgState.Time = fgSystemTime();
+    fgState.TimeNs = fgSystemTimeNs();
     
 
     fgState.Initialised = GL_TRUE;
@@ -292,6 +296,12 @@ void fgPlatformCloseDisplay ( void )
      * created so far
      */
     XCloseDisplay( fgDisplay.pDisplay.Display );
+
+#ifdef USE_FBCONFIG
+    /* The FBConfigs picked so far went with the display */
+    fgDisplay.pDisplay.NumConfigChoices = 0;
+    fgDisplay.pDisplay.NextConfigChoice = 0;
+#endif
 }
 
 
@@ -51,6 +51,25 @@
 
 
 /* -- GLOBAL TYPE DEFINITIONS ---------------------------------------------- */
+#ifdef USE_FBCONFIG
+/*
+ * An FBConfig fghChooseConfig picked, and the display mode settings it was
+ * picked for. Windows tend to be opened with the same ones, so the last few
+ * are kept rather than asking glXChooseFBConfig again. Keyed like the EGL
+ * ones, and likewise only kept if a config matched.
+ */
+#define FG_NUM_CONFIG_CHOICES 4
+typedef struct tagSFG_ConfigChoice SFG_ConfigChoice;
+struct tagSFG_ConfigChoice
+{
+    unsigned int    DisplayMode;
+    int             SampleNumber;
+    int             AuxiliaryBufferNumber;
+    int             MajorVersion;
+    GLXFBConfig     FBConfig;
+};
+#endif
+
 /* The structure used by display initialization in fg_init.c */
 typedef struct tagSFG_PlatformDisplay SFG_PlatformDisplay;
 struct tagSFG_PlatformDisplay
@@ -67,6 +86,7 @@ struct tagSFG_PlatformDisplay
     Atom            ClientMachine;      /* The client machine name atom      */
     Atom            NetWMName;          /* _NET_WM_NAME atom                 */
     Atom            NetWMIconName;      /* _NET_WM_ICON_NAME atom            */
+    Atom            NetFrameExtents;    /* _NET_FRAME_EXTENTS atom           */
 
 #ifdef HAVE_X11_EXTENSIONS_XRANDR_H
     int prev_xsz, prev_ysz;
@@ -90,6 +110,12 @@ struct tagSFG_PlatformDisplay
     struct tagSFG_PlatformDisplayEGL egl;
 #endif
 
+#ifdef USE_FBCONFIG
+    SFG_ConfigChoice ConfigChoices[ FG_NUM_CONFIG_CHOICES ]; /* see fghChooseConfig */
+    int             NumConfigChoices;   /* Number of those filled in         */
+    int             NextConfigChoice;   /* The one to replace next           */
+#endif
+
     int             DisplayPointerX;    /* saved X location of the pointer   */
     int             DisplayPointerY;    /* saved Y location of the pointer   */
 };
@@ -127,6 +153,18 @@ struct tagSFG_PlatformWindowState
     int             OldWidth;           /* Window width from before a resize */
     int             OldHeight;          /*   "    height  "    "    "   "    */
     GLboolean       KeyRepeating;       /* Currently in repeat mode?         */    
+
+    /* The window's geometry as last reported by the server, so that glutGet
+     * doesn't need a round trip for it. Kept up to date from ConfigureNotify,
+     * ReparentNotify and PropertyNotify events, see fgPlatformGlutGet.
+     */
+    GLboolean       Reparented;         /* Top-level window in a window manager frame? */
+    GLboolean       SizeKnown;          /* Width and Height below are valid  */
+    int             Width, Height;
+    GLboolean       PositionKnown;      /* X and Y below are valid           */
+    int             X, Y;               /* Relative to the parent or root window */
+    GLboolean       ExtentsKnown;       /* BorderWidth and HeaderHeight below are valid */
+    int             BorderWidth, HeaderHeight;
 };
 
 /* -- JOYSTICK-SPECIFIC STRUCTURES AND TYPES ------------------------------- */
@@ -79,6 +79,18 @@
 #define GLX_RGBA_FLOAT_TYPE 0x20B9
 #endif
 
+#ifndef GLX_SWAP_INTERVAL_EXT
+#define GLX_SWAP_INTERVAL_EXT 0x20F1
+#endif
+
+#ifndef GLX_LATE_SWAPS_TEAR_EXT
+#define GLX_LATE_SWAPS_TEAR_EXT 0x20F3
+#endif
+
+#ifndef GLX_BACK_BUFFER_AGE_EXT
+#define GLX_BACK_BUFFER_AGE_EXT 0x20F4
+#endif
+
 #ifndef GLX_RGBA_FLOAT_BIT
 #define GLX_RGBA_FLOAT_BIT 0x00000004
 #endif
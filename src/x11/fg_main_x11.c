@@ -86,12 +86,27 @@ fg_time_t fgPlatformSystemTime ( void )
 #endif
 }
 
+/* Same clock in nanoseconds: the timebase of the timers and of
+ * GLUT_ELAPSED_TIME_NS, and of the frame statistics */
+fg_time_t fgPlatformSystemTimeNs ( void )
+{
+#ifdef CLOCK_MONOTONIC
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_nsec + now.tv_sec*(fg_time_t)1000000000;
+#elif defined(HAVE_GETTIMEOFDAY)
+    struct timeval now;
+    gettimeofday( &now, NULL );
+    return now.tv_usec*(fg_time_t)1000 + now.tv_sec*(fg_time_t)1000000000;
+#endif
+}
+
 /*
  * Does the magic required to relinquish the CPU until something interesting
  * happens.
  */
 
-void fgPlatformSleepForEvents( fg_time_t msec )
+void fgPlatformSleepForEvents( fg_time_t nsec )
 {
     /*
      * Possibly due to aggressive use of XFlush() and friends,
@@ -112,8 +127,10 @@ void fgPlatformSleepForEvents( fg_time_t msec )
         socket = ConnectionNumber( fgDisplay.pDisplay.Display );
         FD_ZERO( &fdset );
         FD_SET( socket, &fdset );
-        wait.tv_sec = msec / 1000;
-        wait.tv_usec = (msec % 1000) * 1000;
+        /* Round up, so we don't wake before the next timer is due */
+        nsec += 999;
+        wait.tv_sec = nsec / 1000000000;
+        wait.tv_usec = (nsec % 1000000000) / 1000;
         err = select( socket+1, &fdset, NULL, NULL, &wait );
 
         if( ( -1 == err ) && ( errno != EINTR ) )
@@ -580,6 +597,33 @@ static void fghPrintEvent( XEvent *event )
 #endif
 
 
+/*
+ * Remember the geometry a ConfigureNotify (or CreateNotify) reported, for
+ * glutGet. The size can always be used. The position is relative to the
+ * window's parent, which is only what glutGet wants for subwindows and
+ * for top-level windows that are not in a window manager frame. Inside a
+ * frame only synthetic events, which window managers send when they move
+ * the frame, carry the position on the root window.
+ */
+static void fghUpdateGeometryCache(SFG_Window *window, int x, int y, int width, int height, Bool synthetic)
+{
+    SFG_PlatformWindowState *pWState = &window->State.pWState;
+
+    pWState->Width     = width;
+    pWState->Height    = height;
+    pWState->SizeKnown = GL_TRUE;
+
+    if (window->Parent || synthetic || !pWState->Reparented)
+    {
+        pWState->X = x;
+        pWState->Y = y;
+        pWState->PositionKnown = GL_TRUE;
+    }
+    else
+        /* relative to the frame, ask the server when needed */
+        pWState->PositionKnown = GL_FALSE;
+}
+
 void fgPlatformProcessSingleEvent ( void )
 {
     SFG_Window* window;
@@ -644,6 +688,7 @@ void fgPlatformProcessSingleEvent ( void )
         case ConfigureNotify:
             {
                 int width, height, x, y;
+                Bool synthetic = False;
                 if( event.type == CreateNotify ) {
                     GETWINDOW( xcreatewindow );
                     width = event.xcreatewindow.width;
@@ -656,8 +701,11 @@ void fgPlatformProcessSingleEvent ( void )
                     height = event.xconfigure.height;
                     x = event.xconfigure.x;
                     y = event.xconfigure.y;
+                    synthetic = event.xconfigure.send_event;
                 }
 
+                fghUpdateGeometryCache(window, x, y, width, height, synthetic);
+
                 /* Update state and call callback, if there was a change */
                 fghOnPositionNotify(window, x, y, GL_FALSE);
                 /* Update state and call callback, if there was a change */
@@ -687,7 +735,7 @@ void fgPlatformProcessSingleEvent ( void )
             if( event.xexpose.count == 0 )
             {
                 GETWINDOW( xexpose );
-                window->State.WorkMask |= GLUT_DISPLAY_WORK;
+                fgPostWork( window, GLUT_DISPLAY_WORK );
             }
             break;
 
@@ -794,11 +842,11 @@ void fgPlatformProcessSingleEvent ( void )
              */
             fgState.Modifiers = fgPlatformGetModifiers( event.xmotion.state );
             if ( event.xmotion.state & ( Button1Mask | Button2Mask | Button3Mask | Button4Mask | Button5Mask ) ) {
-                INVOKE_WCB( *window, Motion, ( event.xmotion.x,
-                                               event.xmotion.y ) );
+                fgCoalesceEvent( window, FG_EVENT_MOTION, 0, event.xmotion.x,
+                                 event.xmotion.y, 0 );
             } else {
-                INVOKE_WCB( *window, Passive, ( event.xmotion.x,
-                                                event.xmotion.y ) );
+                fgCoalesceEvent( window, FG_EVENT_PASSIVE, 0, event.xmotion.x,
+                                 event.xmotion.y, 0 );
             }
             fgState.Modifiers = INVALID_MODIFIERS;
         }
@@ -1039,7 +1087,19 @@ void fgPlatformProcessSingleEvent ( void )
         break;
 
         case ReparentNotify:
-            break; /* XXX Should disable this event */
+            /* A window manager put the window in a frame (or took it out
+             * again): the position we had and the decorations are stale */
+            GETWINDOW( xreparent );
+            window->State.pWState.Reparented    = event.xreparent.parent != fgDisplay.pDisplay.RootWindow;
+            window->State.pWState.PositionKnown = GL_FALSE;
+            window->State.pWState.ExtentsKnown  = GL_FALSE;
+            break;
+
+        case PropertyNotify:
+            GETWINDOW( xproperty );
+            if( event.xproperty.atom == fgDisplay.pDisplay.NetFrameExtents )
+                window->State.pWState.ExtentsKnown = GL_FALSE;
+            break;
 
         /* Not handled */
         case GravityNotify:
@@ -1079,6 +1139,13 @@ void fgPlatformInitWork(SFG_Window* window)
 
 void fgPlatformPosResZordWork(SFG_Window* window, unsigned int workMask)
 {
+    /* The geometry we have is stale until the server's ConfigureNotify
+     * arrives, so glutGet has to ask for it in the meantime */
+    if (workMask & (GLUT_FULL_SCREEN_WORK | GLUT_POSITION_WORK))
+        window->State.pWState.PositionKnown = GL_FALSE;
+    if (workMask & (GLUT_FULL_SCREEN_WORK | GLUT_SIZE_WORK))
+        window->State.pWState.SizeKnown = GL_FALSE;
+
     if (workMask & GLUT_FULL_SCREEN_WORK)
         fgPlatformFullScreenToggle( window );
     if (workMask & GLUT_POSITION_WORK)
@@ -128,10 +128,10 @@ void fgSpaceballHandleXEvent(const XEvent *xev)
 		switch(sev.type) {
 		case SPNAV_EVENT_MOTION:
 			if(sev.motion.x | sev.motion.y | sev.motion.z) {
-				INVOKE_WCB(*spnav_win, SpaceMotion, (sev.motion.x, sev.motion.y, sev.motion.z));
+				fgCoalesceEvent(spnav_win, FG_EVENT_SPACE_MOTION, 0, sev.motion.x, sev.motion.y, sev.motion.z);
 			}
 			if(sev.motion.rx | sev.motion.ry | sev.motion.rz) {
-				INVOKE_WCB(*spnav_win, SpaceRotation, (sev.motion.rx, sev.motion.ry, sev.motion.rz));
+				fgCoalesceEvent(spnav_win, FG_EVENT_SPACE_ROTATION, 0, sev.motion.rx, sev.motion.ry, sev.motion.rz);
 			}
 			spnav_remove_events(SPNAV_EVENT_MOTION);
 			break;
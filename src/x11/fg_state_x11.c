@@ -79,121 +79,158 @@ int fgPlatformGlutGet ( GLenum eWhat )
     {
 
     /*
-     * Those calls are somewhat similar, as they use XGetWindowAttributes()
-     * function
+     * The window geometry queries are answered from what the last
+     * ConfigureNotify, ReparentNotify and PropertyNotify events told us
+     * (see fghUpdateGeometryCache in fg_main_x11.c), and only go to the
+     * server for whatever those didn't cover, or always with
+     * GLUT_WINDOW_GEOMETRY_SYNC.
      */
     case GLUT_WINDOW_X:
     case GLUT_WINDOW_Y:
     {
-        int x, y;
-        Window p,w;
+        SFG_PlatformWindowState *pWState;
 
         if( fgStructure.CurrentWindow == NULL )
             return 0;
+        pWState = &fgStructure.CurrentWindow->State.pWState;
 
-        if (fgStructure.CurrentWindow->Parent)
-            /* For child window, we should return relative to upper-left
-             * of parent's client area.
-             */
-            p = fgStructure.CurrentWindow->Parent->Window.Handle;
-        else
-            p = fgDisplay.pDisplay.RootWindow;
-            
-        XTranslateCoordinates(
-            fgDisplay.pDisplay.Display,
-            fgStructure.CurrentWindow->Window.Handle,
-            p,
-            0, 0, &x, &y, &w);
+        if( !pWState->PositionKnown || fgState.SyncWindowGeometry )
+        {
+            int x, y;
+            Window p,w;
+
+            if (fgStructure.CurrentWindow->Parent)
+                /* For child window, we should return relative to upper-left
+                 * of parent's client area.
+                 */
+                p = fgStructure.CurrentWindow->Parent->Window.Handle;
+            else
+                p = fgDisplay.pDisplay.RootWindow;
+
+            XTranslateCoordinates(
+                fgDisplay.pDisplay.Display,
+                fgStructure.CurrentWindow->Window.Handle,
+                p,
+                0, 0, &x, &y, &w);
+
+            pWState->X = x;
+            pWState->Y = y;
+            pWState->PositionKnown = GL_TRUE;
+        }
 
         switch ( eWhat )
         {
-        case GLUT_WINDOW_X: return x;
-        case GLUT_WINDOW_Y: return y;
+        case GLUT_WINDOW_X: return pWState->X;
+        case GLUT_WINDOW_Y: return pWState->Y;
         }
     }
     
     case GLUT_WINDOW_BORDER_WIDTH:
     case GLUT_WINDOW_HEADER_HEIGHT:
     {
-        Atom actual_type, net_extents;
-        int actual_format;
-        unsigned long nitems, bytes_after;
-        unsigned char *data = NULL;
-        int result, top, left;
-        
+        SFG_PlatformWindowState *pWState;
+
         if (fgStructure.CurrentWindow == NULL || fgStructure.CurrentWindow->Parent)
             /* can't get widths/heights if no current window
              * and child windows don't have borders */
             return 0;
-        
-        /* try to get through _NET_FRAME_EXTENTS */
-        net_extents = XInternAtom(fgDisplay.pDisplay.Display, "_NET_FRAME_EXTENTS", False);
-        
-        result = XGetWindowProperty(
-            fgDisplay.pDisplay.Display, fgStructure.CurrentWindow->Window.Handle, net_extents,
-            0, 4, False, AnyPropertyType, 
-            &actual_type, &actual_format, 
-            &nitems, &bytes_after, &data);
-
-        if (result == Success && nitems == 4 && bytes_after == 0)
-            /* got the data we expected, here's to hoping that
-             * _NET_FRAME_EXTENTS is supported and the data
-             * contain sensible values */
-        {
-            long *extents = (long *)data;
-            left = (int) extents[0]; /* we take left as border width, consistent with old logic. bottom and right better be the same... */
-            top  = (int) extents[2];
-        }
-        else
+        pWState = &fgStructure.CurrentWindow->State.pWState;
+
+        if( !pWState->ExtentsKnown || fgState.SyncWindowGeometry )
         {
-            /* try in the previous way as fall-back */
-            Window w;
-            int x,y;
-            
-            XTranslateCoordinates(
-                fgDisplay.pDisplay.Display,
-                fgStructure.CurrentWindow->Window.Handle,
-                fgDisplay.pDisplay.RootWindow,
-                0, 0, &x, &y, &w);
-            
-            if (w == 0)
-                /* logic below needs w */
-                return 0;
-            
-            XTranslateCoordinates(
-                fgDisplay.pDisplay.Display,
-                fgStructure.CurrentWindow->Window.Handle,
-                w, 0, 0, &x, &y, &w);  
-            
-            left = x;
-            top  = y;
+            Atom actual_type;
+            int actual_format;
+            unsigned long nitems, bytes_after;
+            unsigned char *data = NULL;
+            int result, top, left;
+
+            /* try to get through _NET_FRAME_EXTENTS */
+            result = XGetWindowProperty(
+                fgDisplay.pDisplay.Display, fgStructure.CurrentWindow->Window.Handle,
+                fgDisplay.pDisplay.NetFrameExtents,
+                0, 4, False, AnyPropertyType, 
+                &actual_type, &actual_format, 
+                &nitems, &bytes_after, &data);
+
+            if (result == Success && nitems == 4 && bytes_after == 0)
+                /* got the data we expected, here's to hoping that
+                 * _NET_FRAME_EXTENTS is supported and the data
+                 * contain sensible values */
+            {
+                long *extents = (long *)data;
+                left = (int) extents[0]; /* we take left as border width, consistent with old logic. bottom and right better be the same... */
+                top  = (int) extents[2];
+            }
+            else
+            {
+                /* try in the previous way as fall-back */
+                Window w;
+                int x,y;
+
+                XTranslateCoordinates(
+                    fgDisplay.pDisplay.Display,
+                    fgStructure.CurrentWindow->Window.Handle,
+                    fgDisplay.pDisplay.RootWindow,
+                    0, 0, &x, &y, &w);
+
+                if (w == 0)
+                {
+                    /* logic below needs w */
+                    if (result == Success)
+                        XFree(data);
+                    return 0;
+                }
+
+                XTranslateCoordinates(
+                    fgDisplay.pDisplay.Display,
+                    fgStructure.CurrentWindow->Window.Handle,
+                    w, 0, 0, &x, &y, &w);  
+
+                left = x;
+                top  = y;
+            }
+            if (result == Success)
+                XFree(data);
+
+            pWState->BorderWidth  = left;
+            pWState->HeaderHeight = top;
+            pWState->ExtentsKnown = GL_TRUE;
         }
-        if (result == Success)
-            XFree(data);
 
         switch ( eWhat )
         {
-        case GLUT_WINDOW_BORDER_WIDTH:  return left;
-        case GLUT_WINDOW_HEADER_HEIGHT: return top;
+        case GLUT_WINDOW_BORDER_WIDTH:  return pWState->BorderWidth;
+        case GLUT_WINDOW_HEADER_HEIGHT: return pWState->HeaderHeight;
         }
     }
 
     case GLUT_WINDOW_WIDTH:
     case GLUT_WINDOW_HEIGHT:
     {
-        XWindowAttributes winAttributes;
+        SFG_PlatformWindowState *pWState;
 
         if( fgStructure.CurrentWindow == NULL )
             return 0;
-        XGetWindowAttributes(
-            fgDisplay.pDisplay.Display,
-            fgStructure.CurrentWindow->Window.Handle,
-            &winAttributes
-        );
+        pWState = &fgStructure.CurrentWindow->State.pWState;
+
+        if( !pWState->SizeKnown || fgState.SyncWindowGeometry )
+        {
+            XWindowAttributes winAttributes;
+
+            XGetWindowAttributes(
+                fgDisplay.pDisplay.Display,
+                fgStructure.CurrentWindow->Window.Handle,
+                &winAttributes
+            );
+            pWState->Width     = winAttributes.width;
+            pWState->Height    = winAttributes.height;
+            pWState->SizeKnown = GL_TRUE;
+        }
+
         switch ( eWhat )
         {
-        case GLUT_WINDOW_WIDTH:            return winAttributes.width ;
-        case GLUT_WINDOW_HEIGHT:           return winAttributes.height ;
+        case GLUT_WINDOW_WIDTH:            return pWState->Width ;
+        case GLUT_WINDOW_HEIGHT:           return pWState->Height ;
         }
     }
     
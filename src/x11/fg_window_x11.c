@@ -67,7 +67,8 @@ static int fghResizeFullscrToggle(void)
     SFG_Window *win = fgStructure.CurrentWindow;
 
     if(glutGet(GLUT_FULL_SCREEN)) {
-        /* restore original window size */
+        /* restore original window size, dropping any other pending work */
+        fgPostWork( fgStructure.CurrentWindow, GLUT_SIZE_WORK );
         fgStructure.CurrentWindow->State.WorkMask = GLUT_SIZE_WORK;
         fgStructure.CurrentWindow->State.DesiredWidth  = win->State.pWState.OldWidth;
         fgStructure.CurrentWindow->State.DesiredHeight = win->State.pWState.OldHeight;
@@ -280,7 +281,7 @@ done_retry:
 		StructureNotifyMask | SubstructureNotifyMask | ExposureMask |
 		ButtonPressMask | ButtonReleaseMask | KeyPressMask | KeyReleaseMask |
 		VisibilityChangeMask | EnterWindowMask | LeaveWindowMask |
-		PointerMotionMask | ButtonMotionMask;
+		PointerMotionMask | ButtonMotionMask | PropertyChangeMask;
 	wattr.background_pixmap = None;
 	wattr.background_pixel  = 0;
 	wattr.border_pixel      = 0;
@@ -39,7 +39,7 @@
  */
 
 #ifdef USE_FBCONFIG
-int fghChooseConfig(GLXFBConfig* fbconfig)
+static int fghChooseNewConfig(GLXFBConfig* fbconfig)
 {
   GLboolean wantIndexedMode = GL_FALSE;
   int attributes[ 100 ];
@@ -174,6 +174,46 @@ int fghChooseConfig(GLXFBConfig* fbconfig)
     return 1;
 }
 
+/*
+ * Picks the FBConfig for the current display mode settings, or takes the
+ * one picked earlier for the same settings (see SFG_ConfigChoice)
+ */
+int fghChooseConfig(GLXFBConfig* fbconfig)
+{
+  SFG_ConfigChoice *choice;
+  int i;
+
+  for( i = 0; i < fgDisplay.pDisplay.NumConfigChoices; i++ )
+  {
+    choice = &fgDisplay.pDisplay.ConfigChoices[ i ];
+    if( choice->DisplayMode           == fgState.DisplayMode  &&
+        choice->SampleNumber          == fgState.SampleNumber &&
+        choice->AuxiliaryBufferNumber == fgState.AuxiliaryBufferNumber &&
+        choice->MajorVersion          == fgState.MajorVersion )
+    {
+      *fbconfig = choice->FBConfig;
+      return 1;
+    }
+  }
+
+  /* Only keep actual matches, so a failed choice is retried next time */
+  if( !fghChooseNewConfig( fbconfig ) )
+    return 0;
+
+  choice = &fgDisplay.pDisplay.ConfigChoices[ fgDisplay.pDisplay.NextConfigChoice ];
+  choice->DisplayMode           = fgState.DisplayMode;
+  choice->SampleNumber          = fgState.SampleNumber;
+  choice->AuxiliaryBufferNumber = fgState.AuxiliaryBufferNumber;
+  choice->MajorVersion          = fgState.MajorVersion;
+  choice->FBConfig              = *fbconfig;
+
+  fgDisplay.pDisplay.NextConfigChoice = ( fgDisplay.pDisplay.NextConfigChoice + 1 ) % FG_NUM_CONFIG_CHOICES;
+  if( fgDisplay.pDisplay.NumConfigChoices < FG_NUM_CONFIG_CHOICES )
+    fgDisplay.pDisplay.NumConfigChoices++;
+
+  return 1;
+}
+
 static void fghFillContextAttributes( int *attributes ) {
   int where = 0, contextFlags, contextProfile;
 
@@ -350,6 +390,13 @@ void fgPlatformSetWindow ( SFG_Window *window )
 {
     if ( window )
     {
+        /* Skip the MakeCurrent round trip if the context is current already.
+         * These queries are answered client side, per thread.
+         */
+        if( glXGetCurrentContext( ) == window->Window.Context &&
+            glXGetCurrentDrawable( ) == window->Window.Handle )
+            return;
+
 #ifdef GLX_VERSION_1_3
         glXMakeContextCurrent(
             fgDisplay.pDisplay.Display,
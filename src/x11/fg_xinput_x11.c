@@ -228,9 +228,9 @@ void fgHandleExtensionEvents( XEvent* base_ev )
                 }
             }
             if (button) {
-                INVOKE_WCB( *window, MultiMotion,  ( event->deviceid, event->event_x, event->event_y ) );
+                fgCoalesceEvent( window, FG_EVENT_MULTI_MOTION,  event->deviceid, event->event_x, event->event_y, 0 );
             } else {
-                INVOKE_WCB( *window, MultiPassive, ( event->deviceid, event->event_x, event->event_y ) );
+                fgCoalesceEvent( window, FG_EVENT_MULTI_PASSIVE, event->deviceid, event->event_x, event->event_y, 0 );
             }
             #if _DEBUG
             fgPrintXIDeviceEvent(event);